@@ -0,0 +1,149 @@
+/**************************************************************************************************
+ *
+ * Contention benchmark for e_mpmc.h
+ *
+ * Moves a fixed number of items from a number of producer threads to the same number of consumer
+ * threads, once through an `E_Mpmc` and once through an `E_Queue` protected by a mutex, and prints
+ * the throughput of both for an increasing number of threads.
+ *
+ * Build and run (from the repository root):
+ *
+ *     cc -std=c11 -O2 -Iempower benchmarks/bench_mpmc.c -o bench_mpmc -lpthread
+ *     ./bench_mpmc [items per thread]
+ *
+ **************************************************************************************************/
+
+#define E_MPMC_IMPL
+#define E_QUEUE_IMPL
+#include "e_mpmc.h"
+#include "e_queue.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <threads.h>
+#include <time.h>
+
+#define BENCH_MAX_THREADS 16
+#define BENCH_CAP         1024
+
+typedef E_Mpmc (size_t) Bench_Mpmc;
+
+typedef struct {
+    Bench_Mpmc mpmc;
+    E_Queue (size_t) queue;
+    mtx_t lock;
+    size_t per_thread;
+} Bench;
+
+static int
+bench_mpmc_producer (void *arg)
+{
+    Bench *bench = arg;
+    size_t i;
+
+    for (i = 0; i < bench->per_thread; i++) {
+        e_mpmc_push_wait (&bench->mpmc, i);
+    }
+    return 0;
+}
+
+static int
+bench_mpmc_consumer (void *arg)
+{
+    Bench *bench = arg;
+    size_t i, item;
+
+    for (i = 0; i < bench->per_thread; i++) {
+        e_mpmc_pop_wait (&bench->mpmc, &item);
+    }
+    return 0;
+}
+
+static int
+bench_queue_producer (void *arg)
+{
+    Bench *bench = arg;
+    size_t i;
+    int pushed;
+
+    for (i = 0; i < bench->per_thread; i++) {
+        do {
+            mtx_lock (&bench->lock);
+            pushed = e_queue_len (&bench->queue) < BENCH_CAP;
+            if (pushed) e_queue_push (&bench->queue, i);
+            mtx_unlock (&bench->lock);
+            if (!pushed) thrd_yield ();
+        } while (!pushed);
+    }
+    return 0;
+}
+
+static int
+bench_queue_consumer (void *arg)
+{
+    Bench *bench = arg;
+    size_t i, item;
+    int popped;
+
+    for (i = 0; i < bench->per_thread; i++) {
+        do {
+            mtx_lock (&bench->lock);
+            popped = e_queue_pop (&bench->queue, &item);
+            mtx_unlock (&bench->lock);
+            if (!popped) thrd_yield ();
+        } while (!popped);
+    }
+    return 0;
+}
+
+static double
+bench_now (void)
+{
+    struct timespec ts;
+
+    timespec_get (&ts, TIME_UTC);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+static double
+bench_run (Bench *bench, thrd_start_t producer, thrd_start_t consumer, size_t threads)
+{
+    thrd_t producers[BENCH_MAX_THREADS], consumers[BENCH_MAX_THREADS];
+    double start;
+    size_t i;
+
+    start = bench_now ();
+    for (i = 0; i < threads; i++) {
+        thrd_create (&producers[i], producer, bench);
+        thrd_create (&consumers[i], consumer, bench);
+    }
+    for (i = 0; i < threads; i++) {
+        thrd_join (producers[i], NULL);
+        thrd_join (consumers[i], NULL);
+    }
+    return (double) (threads * bench->per_thread) / (bench_now () - start) / 1e6;
+}
+
+int
+main (int argc, char **argv)
+{
+    Bench bench;
+    size_t threads;
+
+    bench.per_thread = argc > 1 ? (size_t) strtoul (argv[1], NULL, 10) : 1000000;
+    e_mpmc_init (&bench.mpmc, BENCH_CAP);
+    bench.queue = (E_TYPEOF (bench.queue)) e_queue_init ();
+    mtx_init (&bench.lock, mtx_plain);
+
+    printf ("threads   e_mpmc (Mitems/s)   mutex + e_queue (Mitems/s)\n");
+    for (threads = 1; threads <= BENCH_MAX_THREADS; threads *= 2) {
+        printf ("%2zu x %-2zu  %17.2f", threads, threads,
+                bench_run (&bench, bench_mpmc_producer, bench_mpmc_consumer, threads));
+        printf ("   %26.2f\n",
+                bench_run (&bench, bench_queue_producer, bench_queue_consumer, threads));
+    }
+
+    mtx_destroy (&bench.lock);
+    e_queue_deinit (&bench.queue);
+    e_mpmc_deinit (&bench.mpmc);
+    return 0;
+}
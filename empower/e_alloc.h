@@ -19,10 +19,36 @@
  *     ptr = e_new (Node);                 // create a single `Node`
  *     e_free (ptr);                       // free the memory
  *
+ * It also defines `E_Allocator`, the allocator interface that is accepted by the containers of
+ * Empower (e.g. `e_da`, `e_queue` and `e_sb`). An allocator consists of three function pointers and
+ * a context pointer that is passed to each of them. The sizes of the previous allocation are passed
+ * to `realloc_fn` and `free_fn`, so that allocators which do not track sizes themselves (e.g.
+ * arenas or pools) can be implemented easily. When a function returns `NULL`, the allocation is
+ * considered to have failed.
+ *
+ *     static void *my_alloc (void *ctx, size_t size) { ... }
+ *     static void *my_realloc (void *ctx, void *ptr, size_t old_size, size_t new_size) { ... }
+ *     static void my_free (void *ctx, void *ptr, size_t size) { ... }
+ *     E_Allocator allocator = {my_alloc, my_realloc, my_free, &my_ctx};
+ *     E_Da (int) list = e_da_init_with_allocator (&allocator);
+ *
  **************************************************************************************************/
 
 #include <stddef.h>
 
+/**
+ * Allocator interface. See the module documentation for details.
+ */
+#ifndef E_ALLOCATOR_DEFINED
+# define E_ALLOCATOR_DEFINED
+typedef struct {
+    void *(*alloc_fn) (void *ctx, size_t size);
+    void *(*realloc_fn) (void *ctx, void *ptr, size_t old_size, size_t new_size);
+    void (*free_fn) (void *ctx, void *ptr, size_t size);
+    void *ctx;
+} E_Allocator;
+#endif /* E_ALLOCATOR_DEFINED */
+
 #define e_alloc(type, nmemb)        (type *) (e_alloc_size) (sizeof (type) * (nmemb))
 #define e_alloc_zero(type, nmemb)   (type *) (e_alloc_zero_size) (sizeof (type) * (nmemb))
 #define e_realloc(ptr, type, nmemb) (type *) (e_realloc_size) ((ptr), sizeof (type) * (nmemb))
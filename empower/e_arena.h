@@ -16,6 +16,10 @@
  *  | do_stuff ();
  *  | e_free (buf);
  *
+ * An arena can also be used as the backing memory of containers through `e_arena_allocator()`:
+ *  | E_Allocator allocator = e_arena_allocator (&arena);
+ *  | E_Da (int) list = e_da_init_with_allocator (&allocator);
+ *
  **************************************************************************************************/
 
 #include <stddef.h>
@@ -58,6 +62,17 @@ union e_max_align_union {
 #endif
 /* clang-format on */
 
+/* allocator interface (see e_alloc.h): */
+#ifndef E_ALLOCATOR_DEFINED
+# define E_ALLOCATOR_DEFINED
+typedef struct {
+    void *(*alloc_fn) (void *ctx, size_t size);
+    void *(*realloc_fn) (void *ctx, void *ptr, size_t old_size, size_t new_size);
+    void (*free_fn) (void *ctx, void *ptr, size_t size);
+    void *ctx;
+} E_Allocator;
+#endif /* E_ALLOCATOR_DEFINED */
+
 #define e_arena_alloc(arena, T, nmemb)                                                             \
     ((T *) e_arena_alloc_aligned ((arena), sizeof (T) * (nmemb), E_ALIGNOF (T)))
 #define e_arena_alloc_zero(arena, T, nmemb)                                                        \
@@ -77,6 +92,7 @@ void *e_arena_alloc_aligned (E_Arena *arena, size_t size, size_t align);
 void *e_arena_alloc_zero_aligned (E_Arena *arena, size_t size, size_t align);
 size_t e_arena_allocated_byte_count (const E_Arena *arena);
 size_t e_arena_remaining_byte_count (const E_Arena *arena);
+E_Allocator e_arena_allocator (E_Arena *arena);
 
 /**************************************************************************************************/
 
@@ -158,6 +174,70 @@ e_arena_remaining_byte_count (const E_Arena *arena)
     return arena->cap - arena->offset;
 }
 
+void *e_arena__allocator_alloc (void *ctx, size_t size);
+void *e_arena__allocator_realloc (void *ctx, void *ptr, size_t old_size, size_t new_size);
+void e_arena__allocator_free (void *ctx, void *ptr, size_t size);
+
+/**
+ * Obtain an `E_Allocator` that allocates from `arena`.
+ *
+ * Reallocating or freeing the most recent allocation of the arena is done in place. Other
+ * allocations are never reclaimed individually; the memory is released all at once when the arena
+ * itself is discarded. The arena must outlive all users of the allocator.
+ */
+E_Allocator
+e_arena_allocator (E_Arena *arena)
+{
+    E_Allocator allocator;
+    allocator.alloc_fn = e_arena__allocator_alloc;
+    allocator.realloc_fn = e_arena__allocator_realloc;
+    allocator.free_fn = e_arena__allocator_free;
+    allocator.ctx = arena;
+    return allocator;
+}
+
+void *
+e_arena__allocator_alloc (void *ctx, size_t size)
+{
+    return e_arena_alloc_aligned (ctx, size, E_ALIGN_MAX);
+}
+
+void *
+e_arena__allocator_realloc (void *ctx, void *ptr, size_t old_size, size_t new_size)
+{
+    E_Arena *arena = ctx;
+    unsigned char *old_ptr = ptr;
+    unsigned char *new_ptr;
+    size_t i;
+
+    /* the most recent allocation can be resized in place */
+    if (old_ptr != NULL && old_ptr + old_size == arena->buf + arena->offset) {
+        if ((size_t) (old_ptr - arena->buf) + new_size > arena->cap) return NULL;
+        arena->offset = (size_t) (old_ptr - arena->buf) + new_size;
+        return ptr;
+    }
+
+    new_ptr = e_arena_alloc_aligned (arena, new_size, E_ALIGN_MAX);
+    if (new_ptr == NULL) return NULL;
+    if (old_ptr != NULL) {
+        for (i = 0; i < old_size && i < new_size; i++)
+            new_ptr[i] = old_ptr[i];
+    }
+    return new_ptr;
+}
+
+void
+e_arena__allocator_free (void *ctx, void *ptr, size_t size)
+{
+    E_Arena *arena = ctx;
+    unsigned char *p = ptr;
+
+    /* only the most recent allocation can be given back to the arena */
+    if (p != NULL && p + size == arena->buf + arena->offset) {
+        arena->offset = (size_t) (p - arena->buf);
+    }
+}
+
 #endif /* E_ARENA_IMPL */
 
 #endif /* EMPOWER_ARENA_H_ */
@@ -0,0 +1,247 @@
+#ifndef E_BIPBUF_H_
+#define E_BIPBUF_H_
+
+/**************************************************************************************************
+ *
+ * Empower / e_bipbuf.h - Public Domain - https://git.tjdev.de/thetek/empower
+ *
+ * This module implements non-resizable ringbuffers for variable-length records, such as log
+ * messages or network packets. It is built on top of a byte ringbuffer from e_rbuf.h, so no
+ * allocations are performed in the library as the user has to provide the memory.
+ *
+ * Every record is stored with a length header and is always contiguous, so that it can be written
+ * and read in place. Like in a bip buffer, when a record does not fit in the space before the end
+ * of the memory, that space is skipped and the record is placed at the start of the memory
+ * instead. The skipped space is reclaimed once the reader passes it.
+ *
+ * It can be used as follows:
+ *
+ * ```
+ * static size_t memory[4096 / sizeof (size_t)];
+ * E_Bipbuf bipbuf;
+ * e_bipbuf_init (&bipbuf, memory, sizeof (memory));
+ * // copy a record into the ringbuffer:
+ * if (!e_bipbuf_push (&bipbuf, "hello", 5)) { ... } // full
+ * // or write it in place:
+ * char *dst = e_bipbuf_reserve (&bipbuf, 512);
+ * if (dst != NULL) {
+ *     size_t n = serialise (dst, 512);
+ *     e_bipbuf_commit (&bipbuf, n);
+ * }
+ * // read the oldest record:
+ * size_t len;
+ * const char *record = e_bipbuf_peek (&bipbuf, &len);
+ * if (record != NULL) {
+ *     parse (record, len);
+ *     e_bipbuf_pop (&bipbuf);
+ * }
+ * ```
+ *
+ * The memory must be aligned for `size_t`. Every record is padded to a multiple of
+ * `sizeof (size_t)` bytes, and its data is aligned for `size_t` as well.
+ *
+ * The implementation of e_rbuf.h (`E_RBUF_IMPL`) is required.
+ *
+ * Configuration options:
+ *  - `E_CONFIG_FREESTANDING`: Do not use functions from the standard library.
+ *
+ **************************************************************************************************/
+
+#include "e_rbuf.h"
+#include <stddef.h>
+
+/**
+ * Ringbuffer for variable-length records
+ */
+typedef struct {
+    E_Rbuf (unsigned char) rbuf;
+    size_t count;        /* number of records */
+    size_t reserved;     /* size of the current reservation in bytes, including the header */
+    size_t reserved_len; /* length that was requested for the current reservation */
+} E_Bipbuf;
+
+/**
+ * Initialise a ringbuffer that stores its records in `ptr`, which has space for `size` bytes.
+ * `ptr` must be aligned for `size_t`, and `size` is rounded down to a multiple of
+ * `sizeof (size_t)`.
+ */
+void e_bipbuf_init (E_Bipbuf *bipbuf, void *ptr, size_t size);
+
+/**
+ * Obtain the number of records in the ringbuffer.
+ */
+#define e_bipbuf_len(bipbuf) (bipbuf)->count
+
+/**
+ * Check if the ringbuffer contains no records.
+ */
+#define e_bipbuf_is_empty(bipbuf) ((bipbuf)->count == 0)
+
+/**
+ * Reserve contiguous space for a record of up to `len` bytes, so that it can be written in place.
+ * The record is only added once it is committed with `e_bipbuf_commit`.
+ *
+ * If there is not enough contiguous space, `NULL` is returned.
+ */
+void *e_bipbuf_reserve (E_Bipbuf *bipbuf, size_t len);
+
+/**
+ * Add the record that was written to the space returned by `e_bipbuf_reserve`. `len` is the actual
+ * length of the record and is limited to the `len` passed to `e_bipbuf_reserve`, since nothing
+ * beyond it may have been written; the rest of the reserved space is released again.
+ */
+void e_bipbuf_commit (E_Bipbuf *bipbuf, size_t len);
+
+/**
+ * Copy a record of `len` bytes from `data` into the ringbuffer.
+ *
+ * If there is not enough contiguous space, nothing is added and zero (false) is returned.
+ * Otherwise, a non-zero (true) value is returned.
+ */
+int e_bipbuf_push (E_Bipbuf *bipbuf, const void *data, size_t len);
+
+/**
+ * Obtain the oldest record in the ringbuffer without removing it. Its length is stored in `*len`.
+ *
+ * If the ringbuffer is empty, `NULL` is returned.
+ */
+void *e_bipbuf_peek (E_Bipbuf *bipbuf, size_t *len);
+
+/**
+ * Remove the oldest record from the ringbuffer.
+ *
+ * If the ringbuffer is not empty, a non-zero (true) value is returned. Otherwise, zero (false) is
+ * returned.
+ */
+int e_bipbuf_pop (E_Bipbuf *bipbuf);
+
+/**************************************************************************************************/
+
+#ifdef E_BIPBUF_IMPL
+
+# ifndef E_CONFIG_FREESTANDING
+#  include <string.h>
+# endif
+
+# define E_BIPBUF__HEADER     sizeof (size_t)
+# define E_BIPBUF__PADDING    ((size_t) -1)
+# define E_BIPBUF__ROUND(len) (((len) + E_BIPBUF__HEADER - 1) / E_BIPBUF__HEADER * E_BIPBUF__HEADER)
+
+void
+e_bipbuf_init (E_Bipbuf *bipbuf, void *ptr, size_t size)
+{
+    bipbuf->rbuf.data.ptr = ptr;
+    bipbuf->rbuf.data.cap = size / E_BIPBUF__HEADER * E_BIPBUF__HEADER;
+    bipbuf->rbuf.data.len = 0;
+    bipbuf->rbuf.data.head = 0;
+    bipbuf->rbuf.data.tail = 0;
+    bipbuf->rbuf.data.mirrored = 0;
+    bipbuf->count = 0;
+    bipbuf->reserved = 0;
+    bipbuf->reserved_len = 0;
+}
+
+void *
+e_bipbuf_reserve (E_Bipbuf *bipbuf, size_t len)
+{
+    E_Rbuf_Data *rbuf = &bipbuf->rbuf.data;
+    size_t need, free_total, free_until_end;
+
+    bipbuf->reserved = 0;
+    if (len > rbuf->cap) return NULL;
+    need = E_BIPBUF__HEADER + E_BIPBUF__ROUND (len);
+
+    /* without records, only padding can be left, so the whole memory can be used again */
+    if (bipbuf->count == 0) {
+        rbuf->len = 0;
+        rbuf->head = 0;
+        rbuf->tail = 0;
+    }
+
+    free_total = rbuf->cap - rbuf->len;
+    free_until_end = rbuf->cap - rbuf->head;
+    if (free_until_end > free_total) free_until_end = free_total;
+
+    if (need > free_until_end) {
+        /* the free space wraps around, and the part at the start is `free_total - free_until_end`
+         * bytes large */
+        if (free_until_end == free_total || need > free_total - free_until_end) return NULL;
+        *(size_t *) (void *) e_rbuf_head_ptr (&bipbuf->rbuf) = E_BIPBUF__PADDING;
+        e_rbuf_commit (&bipbuf->rbuf, free_until_end);
+    }
+
+    bipbuf->reserved = need;
+    bipbuf->reserved_len = len;
+    return e_rbuf_head_ptr (&bipbuf->rbuf) + E_BIPBUF__HEADER;
+}
+
+void
+e_bipbuf_commit (E_Bipbuf *bipbuf, size_t len)
+{
+    size_t size;
+
+    if (bipbuf->reserved == 0) return;
+    if (len > bipbuf->reserved_len) len = bipbuf->reserved_len;
+    size = E_BIPBUF__HEADER + E_BIPBUF__ROUND (len);
+
+    *(size_t *) (void *) e_rbuf_head_ptr (&bipbuf->rbuf) = len;
+    e_rbuf_commit (&bipbuf->rbuf, size);
+    bipbuf->count += 1;
+    bipbuf->reserved = 0;
+}
+
+int
+e_bipbuf_push (E_Bipbuf *bipbuf, const void *data, size_t len)
+{
+    unsigned char *dst;
+# ifdef E_CONFIG_FREESTANDING
+    const unsigned char *src = data;
+    size_t i;
+# endif /* E_CONFIG_FREESTANDING */
+
+    dst = e_bipbuf_reserve (bipbuf, len);
+    if (dst == NULL) return 0;
+# ifdef E_CONFIG_FREESTANDING
+    for (i = 0; i < len; i++) {
+        dst[i] = src[i];
+    }
+# else  /* E_CONFIG_FREESTANDING */
+    memcpy (dst, data, len);
+# endif /* E_CONFIG_FREESTANDING */
+    e_bipbuf_commit (bipbuf, len);
+    return 1;
+}
+
+void *
+e_bipbuf_peek (E_Bipbuf *bipbuf, size_t *len)
+{
+    E_Rbuf_Data *rbuf = &bipbuf->rbuf.data;
+    size_t header;
+
+    if (bipbuf->count == 0) return NULL;
+
+    header = *(size_t *) (void *) e_rbuf_tail_ptr (&bipbuf->rbuf);
+    if (header == E_BIPBUF__PADDING) {
+        /* the rest of the memory was skipped, so the record is at the start */
+        e_rbuf_consume (&bipbuf->rbuf, rbuf->cap - rbuf->tail);
+        header = *(size_t *) (void *) e_rbuf_tail_ptr (&bipbuf->rbuf);
+    }
+
+    *len = header;
+    return e_rbuf_tail_ptr (&bipbuf->rbuf) + E_BIPBUF__HEADER;
+}
+
+int
+e_bipbuf_pop (E_Bipbuf *bipbuf)
+{
+    size_t len;
+
+    if (e_bipbuf_peek (bipbuf, &len) == NULL) return 0;
+    e_rbuf_consume (&bipbuf->rbuf, E_BIPBUF__HEADER + E_BIPBUF__ROUND (len));
+    bipbuf->count -= 1;
+    return 1;
+}
+
+#endif /* E_BIPBUF_IMPL */
+
+#endif /* E_BIPBUF_H_ */
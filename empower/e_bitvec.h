@@ -11,43 +11,293 @@
  * is not really necessary in most cases. So technically, these should be called "bit arrays"
  * instead, but who cares.
  *
+ * The bits are stored in words of type `E_Bitvec_Word` (64 bits wide from C99 onwards, and
+ * `unsigned long` in C89), so that functions that operate on ranges of bits, such as
+ * `e_bitvec_all`, `e_bitvec_count` or `e_bitvec_find_next_set`, process a whole word at a time:
+ *
+ * ```
+ * E_Bitvec_Word data[E_BITVEC_WORDS (1000)];
+ * E_Bitvec visited = e_bitvec_init (data, 1000);
+ * e_bitvec_set (&visited, 42);
+ * e_bitvec_set (&visited, 500);
+ * size_t n = e_bitvec_count (&visited, 0, 1000); // 2
+ * e_bitvec_foreach_set (&visited, index) {
+ *     printf ("%zu\n", index); // 42, 500
+ * }
+ * ```
+ *
+ * Bit vectors can be combined with `e_bitvec_and`, `e_bitvec_or`, `e_bitvec_xor`, `e_bitvec_andnot`
+ * and `e_bitvec_not`, either in place or into another bit vector:
+ *
+ * ```
+ * e_bitvec_and (&matches, &matches, &filter); // matches &= filter
+ * e_bitvec_andnot (&todo, &all, &done);       // todo = all & ~done
+ * size_t n = e_bitvec_count_and (&a, &b);     // number of bits that are set in both
+ * ```
+ *
+ * Ranges of bits can be changed at once with `e_bitvec_set_range`, `e_bitvec_unset_range` and
+ * `e_bitvec_negate_range`, which fill whole words in the middle of the range. Together with
+ * `e_bitvec_find_first_unset`, a bit vector can be used to allocate slots:
+ *
+ * ```
+ * size_t slot = e_bitvec_find_first_unset (&used, 0, used.cap);
+ * if (slot != E_BITVEC_NONE) e_bitvec_set (&used, slot);
+ * e_bitvec_set_range (&used, 4096, 8192); // reserve a block of slots
+ * ```
+ *
+ * For succinct data structures, a rank/select index can be built over a bit vector that is no
+ * longer modified. It answers how many bits are set before an index (`e_bitvec_rank1`) in constant
+ * time, and where the `k`th set bit is (`e_bitvec_select1`) with a short search. The index stores
+ * a `size_t` count for every 65536 bits and a 16-bit count for every 512 bits, which takes about
+ * 3.3% of the size of the bit vector. Its memory is provided by the user:
+ *
+ * ```
+ * void *memory = malloc (e_bitvec_rank_size (bitvec.cap));
+ * E_Bitvec_Rank rank = e_bitvec_rank_init (&bitvec, memory);
+ * size_t before = e_bitvec_rank1 (&rank, 1000); // number of set bits in [0, 1000)
+ * size_t index = e_bitvec_select1 (&rank, 41);  // index of the 42nd set bit
+ * ```
+ *
+ * The operations between bit vectors use SSE2 or AVX2 instructions when the compiler targets a CPU
+ * that supports them (e.g. with `-mavx2` or `-march=native` for AVX2), and process a word at a time
+ * otherwise.
+ *
+ * Configuration options:
+ *  - `E_CONFIG_BITVEC_NO_SIMD`: Do not use SSE2 or AVX2 instructions.
+ *
  **************************************************************************************************/
 
 #include <stddef.h>
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+# include <stdint.h>
+#endif
+
+/**
+ * The type of the words that a bit vector stores its bits in. Bit `i` is stored in bit `i % 64` of
+ * word `i / 64` (or `i % E_BITVEC_WORD_BITS` of word `i / E_BITVEC_WORD_BITS` in C89).
+ */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+typedef uint64_t E_Bitvec_Word;
+#else
+typedef unsigned long E_Bitvec_Word;
+#endif
+
+/**
+ * The number of bits in an `E_Bitvec_Word`.
+ */
+#define E_BITVEC_WORD_BITS (sizeof (E_Bitvec_Word) * 8)
+
+/**
+ * The number of words that are required to store `cap` bits.
+ */
+#define E_BITVEC_WORDS(cap) (((cap) + E_BITVEC_WORD_BITS - 1) / E_BITVEC_WORD_BITS)
+
+/**
+ * Returned by the `find` functions if no bit was found.
+ */
+#define E_BITVEC_NONE ((size_t) -1)
 
 /**
  * A bit vector, consisting of the \data pointer and \cap, the number of available bits.
  */
 typedef struct {
-    unsigned char *data;
+    E_Bitvec_Word *data;
     size_t cap;
 } E_Bitvec;
 
-E_Bitvec e_bitvec_init (unsigned char *data, size_t cap);
+/**
+ * A rank/select index over a bit vector that is not modified anymore (see `e_bitvec_rank_init`).
+ */
+typedef struct {
+    E_Bitvec bitvec;
+    size_t ones;            /* total number of bits that are set */
+    size_t *superblocks;    /* number of set bits before every superblock, and in total */
+    size_t *samples;        /* superblock of every 65536th set bit */
+    unsigned short *blocks; /* number of set bits before every block within its superblock */
+    size_t superblock_count;
+    size_t block_count;
+    size_t sample_count;
+} E_Bitvec_Rank;
+
+/**
+ * Iterate over the indices of all bits in the bit vector `bitvec` that are set to 1, in ascending
+ * order. The index is stored in a variable of type `size_t` that is called `index`. Requires C99.
+ *
+ * This macro can be used as follows:
+ *
+ * ```
+ * e_bitvec_foreach_set (&bitvec, index) {
+ *     printf ("%zu\n", index);
+ * }
+ * ```
+ */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+# define e_bitvec_foreach_set(bitvec, index)                                                       \
+     for (size_t index = e_bitvec_find_first_set (bitvec); (index) != E_BITVEC_NONE;               \
+          (index) = e_bitvec_find_next_set ((bitvec), (index) + 1))
+#endif
+
+E_Bitvec e_bitvec_init (E_Bitvec_Word *data, size_t cap);
 int e_bitvec_get (const E_Bitvec *bitvec, size_t index);
 int e_bitvec_all (const E_Bitvec *bitvec, size_t start, size_t end);
 int e_bitvec_any (const E_Bitvec *bitvec, size_t start, size_t end);
+size_t e_bitvec_count (const E_Bitvec *bitvec, size_t start, size_t end);
+size_t e_bitvec_find_first_set (const E_Bitvec *bitvec);
+size_t e_bitvec_find_next_set (const E_Bitvec *bitvec, size_t index);
+size_t e_bitvec_find_first_unset (const E_Bitvec *bitvec, size_t start, size_t end);
 void e_bitvec_set (E_Bitvec *bitvec, size_t index);
 void e_bitvec_unset (E_Bitvec *bitvec, size_t index);
 void e_bitvec_put (E_Bitvec *bitvec, size_t index, int value);
 void e_bitvec_negate (E_Bitvec *bitvec, size_t index);
+void e_bitvec_set_range (E_Bitvec *bitvec, size_t start, size_t end);
+void e_bitvec_unset_range (E_Bitvec *bitvec, size_t start, size_t end);
+void e_bitvec_negate_range (E_Bitvec *bitvec, size_t start, size_t end);
+void e_bitvec_and (E_Bitvec *dst, const E_Bitvec *a, const E_Bitvec *b);
+void e_bitvec_or (E_Bitvec *dst, const E_Bitvec *a, const E_Bitvec *b);
+void e_bitvec_xor (E_Bitvec *dst, const E_Bitvec *a, const E_Bitvec *b);
+void e_bitvec_andnot (E_Bitvec *dst, const E_Bitvec *a, const E_Bitvec *b);
+void e_bitvec_not (E_Bitvec *dst, const E_Bitvec *a);
+size_t e_bitvec_count_and (const E_Bitvec *a, const E_Bitvec *b);
+size_t e_bitvec_rank_size (size_t cap);
+E_Bitvec_Rank e_bitvec_rank_init (const E_Bitvec *bitvec, void *memory);
+size_t e_bitvec_rank1 (const E_Bitvec_Rank *rank, size_t index);
+size_t e_bitvec_rank0 (const E_Bitvec_Rank *rank, size_t index);
+size_t e_bitvec_select1 (const E_Bitvec_Rank *rank, size_t k);
 
 /**************************************************************************************************/
 
 #ifdef E_BITVEC_IMPL
 
 # include <string.h>
+# if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+# endif
+# ifndef E_CONFIG_BITVEC_NO_SIMD
+#  if defined(__AVX2__)
+#   define E_BITVEC__AVX2
+#   include <immintrin.h>
+#  elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   define E_BITVEC__SSE2
+#   include <emmintrin.h>
+#  endif
+#  if defined(__BMI2__) && defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L &&           \
+      (defined(__x86_64__) || defined(_M_X64))
+#   define E_BITVEC__BMI2
+#   include <immintrin.h>
+#  endif
+# endif /* E_CONFIG_BITVEC_NO_SIMD */
+
+# define E_BITVEC__ONES ((E_Bitvec_Word) ~(E_Bitvec_Word) 0)
+# define E_BITVEC__BIT(index) ((E_Bitvec_Word) 1 << ((index) % E_BITVEC_WORD_BITS))
+# define E_BITVEC__BLOCK_WORDS      (512 / E_BITVEC_WORD_BITS)   /* words per block */
+# define E_BITVEC__SUPERBLOCK_WORDS (65536 / E_BITVEC_WORD_BITS) /* words per superblock */
+# define E_BITVEC__SELECT_SAMPLE    65536
+
+typedef enum {
+    E_BITVEC__AND,
+    E_BITVEC__OR,
+    E_BITVEC__XOR,
+    E_BITVEC__ANDNOT,
+    E_BITVEC__NOT
+} E_Bitvec__Op;
+
+size_t e_bitvec__popcount (E_Bitvec_Word word);
+size_t e_bitvec__ctz (E_Bitvec_Word word);
+E_Bitvec_Word e_bitvec__mask (size_t word_index, size_t start, size_t end);
+int e_bitvec__trim (const E_Bitvec *bitvec, size_t start, size_t *end);
+void e_bitvec__apply (E_Bitvec *dst, const E_Bitvec *a, const E_Bitvec *b, E_Bitvec__Op op);
+void e_bitvec__apply_range (E_Bitvec *bitvec, size_t start, size_t end, E_Bitvec__Op op);
+size_t e_bitvec__select_word (E_Bitvec_Word word, size_t k);
+
+/**
+ * Number of bits in `word` that are set to 1.
+ */
+size_t
+e_bitvec__popcount (E_Bitvec_Word word)
+{
+# if (defined(__GNUC__) || defined(__clang__)) && defined(__STDC_VERSION__) &&                     \
+     __STDC_VERSION__ >= 199901L
+    return (size_t) __builtin_popcountll (word);
+# elif defined(__GNUC__) || defined(__clang__)
+    return (size_t) __builtin_popcountl (word);
+# elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+    word = word - ((word >> 1) & 0x5555555555555555);
+    word = (word & 0x3333333333333333) + ((word >> 2) & 0x3333333333333333);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0F;
+    return (size_t) ((word * 0x0101010101010101) >> 56);
+# else
+    size_t r = 0;
+    while (word != 0) {
+        word &= word - 1;
+        r += 1;
+    }
+    return r;
+# endif
+}
+
+/**
+ * Index of the least significant set bit of `word`, which must not be 0.
+ */
+size_t
+e_bitvec__ctz (E_Bitvec_Word word)
+{
+# if (defined(__GNUC__) || defined(__clang__)) && defined(__STDC_VERSION__) &&                     \
+     __STDC_VERSION__ >= 199901L
+    return (size_t) __builtin_ctzll (word);
+# elif defined(__GNUC__) || defined(__clang__)
+    return (size_t) __builtin_ctzl (word);
+# elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanForward64 (&index, word);
+    return index;
+# else
+    size_t r = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        r += 1;
+    }
+    return r;
+# endif
+}
+
+/**
+ * Mask of the bits in word `word_index` that are within the range from `start` (inclusive) to
+ * `end` (exclusive). The word must overlap with the range.
+ */
+E_Bitvec_Word
+e_bitvec__mask (size_t word_index, size_t start, size_t end)
+{
+    E_Bitvec_Word mask = E_BITVEC__ONES;
+
+    if (word_index == start / E_BITVEC_WORD_BITS) {
+        mask &= (E_Bitvec_Word) (E_BITVEC__ONES << (start % E_BITVEC_WORD_BITS));
+    }
+    if (word_index == (end - 1) / E_BITVEC_WORD_BITS && end % E_BITVEC_WORD_BITS != 0) {
+        mask &= (E_Bitvec_Word) ~(E_BITVEC__ONES << (end % E_BITVEC_WORD_BITS));
+    }
+    return mask;
+}
+
+/**
+ * Trim `end` to the capacity of `bitvec`. Returns 0 if the range is empty or out of range.
+ */
+int
+e_bitvec__trim (const E_Bitvec *bitvec, size_t start, size_t *end)
+{
+    if (*end > bitvec->cap) *end = bitvec->cap;
+    return start < *end;
+}
 
 /**
  * Initialise a bit vector with a pointer `data` that allows storing `cap` BITS (not bytes!) of
- * data. `cap` must be divisible by 8. This means that `data` must point to `cap / 8` items of type
- * `unsigned char`. All elements are initialised to 0.
+ * data. This means that `data` must point to `E_BITVEC_WORDS (cap)` items of type
+ * `E_Bitvec_Word`. All elements are initialised to 0.
  */
 E_Bitvec
-e_bitvec_init (unsigned char *data, size_t cap)
+e_bitvec_init (E_Bitvec_Word *data, size_t cap)
 {
     E_Bitvec ret;
-    memset (data, 0, cap / 8);
+    memset (data, 0, E_BITVEC_WORDS (cap) * sizeof (E_Bitvec_Word));
     ret.data = data;
     ret.cap = cap;
     return ret;
@@ -60,10 +310,8 @@ e_bitvec_init (unsigned char *data, size_t cap)
 int
 e_bitvec_get (const E_Bitvec *bitvec, size_t index)
 {
-    unsigned char byte;
-    if (index >= bitvec->cap) return 1;
-    byte = bitvec->data[index / 8];
-    return (byte >> (index % 8)) & 0x1;
+    if (index >= bitvec->cap) return 0;
+    return (bitvec->data[index / E_BITVEC_WORD_BITS] & E_BITVEC__BIT (index)) != 0;
 }
 
 /**
@@ -78,15 +326,15 @@ e_bitvec_get (const E_Bitvec *bitvec, size_t index)
 int
 e_bitvec_all (const E_Bitvec *bitvec, size_t start, size_t end)
 {
-    unsigned char byte;
+    E_Bitvec_Word mask;
     size_t i;
 
     if (start > end) return 0;
     if (start >= bitvec->cap) return 0;
-    end = end >= bitvec->cap ? bitvec->cap - 1 : end;
-    for (i = start; i < end; i++) {
-        byte = bitvec->data[i / 8];
-        if (!(byte & (1 << (i % 8)))) {
+    if (!e_bitvec__trim (bitvec, start, &end)) return 1;
+    for (i = start / E_BITVEC_WORD_BITS; i <= (end - 1) / E_BITVEC_WORD_BITS; i++) {
+        mask = e_bitvec__mask (i, start, end);
+        if ((bitvec->data[i] & mask) != mask) {
             return 0;
         }
     }
@@ -105,21 +353,92 @@ e_bitvec_all (const E_Bitvec *bitvec, size_t start, size_t end)
 int
 e_bitvec_any (const E_Bitvec *bitvec, size_t start, size_t end)
 {
-    unsigned char byte;
     size_t i;
 
-    if (start > end) return 0;
-    if (start >= bitvec->cap) return 0;
-    end = end >= bitvec->cap ? bitvec->cap - 1 : end;
-    for (i = start; i < end; i++) {
-        byte = bitvec->data[i / 8];
-        if (byte & (1 << (i % 8))) {
+    if (!e_bitvec__trim (bitvec, start, &end)) return 0;
+    for (i = start / E_BITVEC_WORD_BITS; i <= (end - 1) / E_BITVEC_WORD_BITS; i++) {
+        if (bitvec->data[i] & e_bitvec__mask (i, start, end)) {
             return 1;
         }
     }
     return 0;
 }
 
+/**
+ * Count the bits within a range in `bitvec` that are set to 1.
+ *
+ * The range is given by `start` (inclusive) and `end` (exclusive). If `end` is out of range, it is
+ * trimmed to the capacity of the bit vector. If the range is empty or `start` is out of range, 0 is
+ * returned.
+ */
+size_t
+e_bitvec_count (const E_Bitvec *bitvec, size_t start, size_t end)
+{
+    size_t i, count = 0;
+
+    if (!e_bitvec__trim (bitvec, start, &end)) return 0;
+    for (i = start / E_BITVEC_WORD_BITS; i <= (end - 1) / E_BITVEC_WORD_BITS; i++) {
+        count += e_bitvec__popcount (bitvec->data[i] & e_bitvec__mask (i, start, end));
+    }
+    return count;
+}
+
+/**
+ * Find the index of the first bit in `bitvec` that is set to 1. If no bit is set, `E_BITVEC_NONE`
+ * is returned.
+ */
+size_t
+e_bitvec_find_first_set (const E_Bitvec *bitvec)
+{
+    return e_bitvec_find_next_set (bitvec, 0);
+}
+
+/**
+ * Find the index of the first bit in `bitvec` at or after `index` that is set to 1. If no such bit
+ * is set, or if `index` is out of range, `E_BITVEC_NONE` is returned.
+ */
+size_t
+e_bitvec_find_next_set (const E_Bitvec *bitvec, size_t index)
+{
+    E_Bitvec_Word word;
+    size_t i, words, found;
+
+    if (index >= bitvec->cap) return E_BITVEC_NONE;
+    words = E_BITVEC_WORDS (bitvec->cap);
+    i = index / E_BITVEC_WORD_BITS;
+    word = bitvec->data[i] & (E_Bitvec_Word) (E_BITVEC__ONES << (index % E_BITVEC_WORD_BITS));
+    while (word == 0) {
+        i += 1;
+        if (i >= words) return E_BITVEC_NONE;
+        word = bitvec->data[i];
+    }
+    found = i * E_BITVEC_WORD_BITS + e_bitvec__ctz (word);
+    return found < bitvec->cap ? found : E_BITVEC_NONE;
+}
+
+/**
+ * Find the index of the first bit within a range in `bitvec` that is set to 0.
+ *
+ * The range is given by `start` (inclusive) and `end` (exclusive). If `end` is out of range, it is
+ * trimmed to the capacity of the bit vector. If all bits within the range are set to 1, or if the
+ * range is empty, `E_BITVEC_NONE` is returned.
+ */
+size_t
+e_bitvec_find_first_unset (const E_Bitvec *bitvec, size_t start, size_t end)
+{
+    E_Bitvec_Word word;
+    size_t i;
+
+    if (!e_bitvec__trim (bitvec, start, &end)) return E_BITVEC_NONE;
+    for (i = start / E_BITVEC_WORD_BITS; i <= (end - 1) / E_BITVEC_WORD_BITS; i++) {
+        word = (E_Bitvec_Word) ~bitvec->data[i] & e_bitvec__mask (i, start, end);
+        if (word != 0) {
+            return i * E_BITVEC_WORD_BITS + e_bitvec__ctz (word);
+        }
+    }
+    return E_BITVEC_NONE;
+}
+
 /**
  * Set the bit at `index` within the bit vector `bitvec` to 1.
  * Does nothing if `index` is out of range.
@@ -127,10 +446,8 @@ e_bitvec_any (const E_Bitvec *bitvec, size_t start, size_t end)
 void
 e_bitvec_set (E_Bitvec *bitvec, size_t index)
 {
-    unsigned char *byte;
     if (index >= bitvec->cap) return;
-    byte = &bitvec->data[index / 8];
-    *byte |= (unsigned char) (1 << (index % 8));
+    bitvec->data[index / E_BITVEC_WORD_BITS] |= E_BITVEC__BIT (index);
 }
 
 /**
@@ -140,10 +457,8 @@ e_bitvec_set (E_Bitvec *bitvec, size_t index)
 void
 e_bitvec_unset (E_Bitvec *bitvec, size_t index)
 {
-    unsigned char *byte;
     if (index >= bitvec->cap) return;
-    byte = &bitvec->data[index / 8];
-    *byte &= (unsigned char) ~(1 << (index % 8));
+    bitvec->data[index / E_BITVEC_WORD_BITS] &= (E_Bitvec_Word) ~E_BITVEC__BIT (index);
 }
 
 /**
@@ -166,10 +481,472 @@ e_bitvec_put (E_Bitvec *bitvec, size_t index, int value)
 void
 e_bitvec_negate (E_Bitvec *bitvec, size_t index)
 {
-    unsigned char *byte;
     if (index >= bitvec->cap) return;
-    byte = &bitvec->data[index / 8];
-    *byte ^= (unsigned char) (1 << (index % 8));
+    bitvec->data[index / E_BITVEC_WORD_BITS] ^= E_BITVEC__BIT (index);
+}
+
+/**
+ * Set (`E_BITVEC__OR`), unset (`E_BITVEC__ANDNOT`) or negate (`E_BITVEC__XOR`) the bits within a
+ * range in `bitvec`. Only the first and the last word need a mask; the words in between are
+ * filled completely.
+ */
+void
+e_bitvec__apply_range (E_Bitvec *bitvec, size_t start, size_t end, E_Bitvec__Op op)
+{
+    E_Bitvec_Word *data = bitvec->data, mask;
+    size_t first, last, i;
+
+    if (!e_bitvec__trim (bitvec, start, &end)) return;
+    first = start / E_BITVEC_WORD_BITS;
+    last = (end - 1) / E_BITVEC_WORD_BITS;
+
+    for (i = first; i <= last; i++) {
+        if (i == first + 1 && last > first + 1) {
+            /* the words in between are completely within the range */
+            if (op == E_BITVEC__XOR) {
+                for (; i < last; i++) {
+                    data[i] = (E_Bitvec_Word) ~data[i];
+                }
+            } else {
+                memset (&data[i], op == E_BITVEC__OR ? 0xFF : 0, (last - i) * sizeof (*data));
+                i = last;
+            }
+        }
+        mask = e_bitvec__mask (i, start, end);
+        switch (op) {
+        case E_BITVEC__OR:
+            data[i] |= mask;
+            break;
+        case E_BITVEC__ANDNOT:
+            data[i] &= (E_Bitvec_Word) ~mask;
+            break;
+        default:
+            data[i] ^= mask;
+            break;
+        }
+    }
+}
+
+/**
+ * Apply `op` to the words of `a` and `b` and store the result in `dst`. `b` is ignored for
+ * `E_BITVEC__NOT`. The bit vectors may overlap, as long as they are either equal or disjoint.
+ */
+void
+e_bitvec__apply (E_Bitvec *dst, const E_Bitvec *a, const E_Bitvec *b, E_Bitvec__Op op)
+{
+    E_Bitvec_Word *d = dst->data, word, tail_mask = 0, tail = 0;
+    const E_Bitvec_Word *x = a->data, *y = op == E_BITVEC__NOT ? a->data : b->data;
+    size_t i = 0, words, cap;
+
+    cap = dst->cap < a->cap ? dst->cap : a->cap;
+    if (op != E_BITVEC__NOT && b->cap < cap) cap = b->cap;
+    words = E_BITVEC_WORDS (cap);
+
+    /* the bits of the last word after `cap` are kept (or stay 0 after the end of `dst`) */
+    if (cap % E_BITVEC_WORD_BITS != 0) {
+        tail_mask = (E_Bitvec_Word) (E_BITVEC__ONES << (cap % E_BITVEC_WORD_BITS));
+        tail = d[words - 1] & tail_mask;
+    }
+
+# if defined(E_BITVEC__AVX2)
+    {
+        const size_t step = sizeof (__m256i) / sizeof (E_Bitvec_Word);
+        const __m256i ones = _mm256_set1_epi32 (-1);
+        __m256i vx, vy, vd;
+
+        for (; i + step <= words; i += step) {
+            vx = _mm256_loadu_si256 ((const __m256i *) (const void *) &x[i]);
+            vy = _mm256_loadu_si256 ((const __m256i *) (const void *) &y[i]);
+            switch (op) {
+            case E_BITVEC__AND:
+                vd = _mm256_and_si256 (vx, vy);
+                break;
+            case E_BITVEC__OR:
+                vd = _mm256_or_si256 (vx, vy);
+                break;
+            case E_BITVEC__XOR:
+                vd = _mm256_xor_si256 (vx, vy);
+                break;
+            case E_BITVEC__ANDNOT:
+                vd = _mm256_andnot_si256 (vy, vx);
+                break;
+            default:
+                vd = _mm256_xor_si256 (vx, ones);
+                break;
+            }
+            _mm256_storeu_si256 ((__m256i *) (void *) &d[i], vd);
+        }
+    }
+# elif defined(E_BITVEC__SSE2)
+    {
+        const size_t step = sizeof (__m128i) / sizeof (E_Bitvec_Word);
+        const __m128i ones = _mm_set1_epi32 (-1);
+        __m128i vx, vy, vd;
+
+        for (; i + step <= words; i += step) {
+            vx = _mm_loadu_si128 ((const __m128i *) (const void *) &x[i]);
+            vy = _mm_loadu_si128 ((const __m128i *) (const void *) &y[i]);
+            switch (op) {
+            case E_BITVEC__AND:
+                vd = _mm_and_si128 (vx, vy);
+                break;
+            case E_BITVEC__OR:
+                vd = _mm_or_si128 (vx, vy);
+                break;
+            case E_BITVEC__XOR:
+                vd = _mm_xor_si128 (vx, vy);
+                break;
+            case E_BITVEC__ANDNOT:
+                vd = _mm_andnot_si128 (vy, vx);
+                break;
+            default:
+                vd = _mm_xor_si128 (vx, ones);
+                break;
+            }
+            _mm_storeu_si128 ((__m128i *) (void *) &d[i], vd);
+        }
+    }
+# endif
+
+    for (; i < words; i++) {
+        switch (op) {
+        case E_BITVEC__AND:
+            word = x[i] & y[i];
+            break;
+        case E_BITVEC__OR:
+            word = x[i] | y[i];
+            break;
+        case E_BITVEC__XOR:
+            word = x[i] ^ y[i];
+            break;
+        case E_BITVEC__ANDNOT:
+            word = x[i] & (E_Bitvec_Word) ~y[i];
+            break;
+        default:
+            word = (E_Bitvec_Word) ~x[i];
+            break;
+        }
+        d[i] = word;
+    }
+
+    if (tail_mask != 0) {
+        d[words - 1] = (d[words - 1] & (E_Bitvec_Word) ~tail_mask) | tail;
+    }
+}
+
+/**
+ * Set the bits within a range in `bitvec` to 1.
+ *
+ * The range is given by `start` (inclusive) and `end` (exclusive). If `end` is out of range, it is
+ * trimmed to the capacity of the bit vector. Does nothing if the range is empty or `start` is out
+ * of range.
+ */
+void
+e_bitvec_set_range (E_Bitvec *bitvec, size_t start, size_t end)
+{
+    e_bitvec__apply_range (bitvec, start, end, E_BITVEC__OR);
+}
+
+/**
+ * Set the bits within a range in `bitvec` to 0.
+ *
+ * The range is given by `start` (inclusive) and `end` (exclusive). If `end` is out of range, it is
+ * trimmed to the capacity of the bit vector. Does nothing if the range is empty or `start` is out
+ * of range.
+ */
+void
+e_bitvec_unset_range (E_Bitvec *bitvec, size_t start, size_t end)
+{
+    e_bitvec__apply_range (bitvec, start, end, E_BITVEC__ANDNOT);
+}
+
+/**
+ * Negate the bits within a range in `bitvec`.
+ *
+ * The range is given by `start` (inclusive) and `end` (exclusive). If `end` is out of range, it is
+ * trimmed to the capacity of the bit vector. Does nothing if the range is empty or `start` is out
+ * of range.
+ */
+void
+e_bitvec_negate_range (E_Bitvec *bitvec, size_t start, size_t end)
+{
+    e_bitvec__apply_range (bitvec, start, end, E_BITVEC__XOR);
+}
+
+/**
+ * Store the bitwise AND of `a` and `b` in `dst`. `dst` may be the same bit vector as `a` or `b`.
+ *
+ * If the bit vectors do not have the same capacity, only the bits that all of them have are
+ * processed.
+ */
+void
+e_bitvec_and (E_Bitvec *dst, const E_Bitvec *a, const E_Bitvec *b)
+{
+    e_bitvec__apply (dst, a, b, E_BITVEC__AND);
+}
+
+/**
+ * Store the bitwise OR of `a` and `b` in `dst`. `dst` may be the same bit vector as `a` or `b`.
+ *
+ * If the bit vectors do not have the same capacity, only the bits that all of them have are
+ * processed.
+ */
+void
+e_bitvec_or (E_Bitvec *dst, const E_Bitvec *a, const E_Bitvec *b)
+{
+    e_bitvec__apply (dst, a, b, E_BITVEC__OR);
+}
+
+/**
+ * Store the bitwise XOR of `a` and `b` in `dst`. `dst` may be the same bit vector as `a` or `b`.
+ *
+ * If the bit vectors do not have the same capacity, only the bits that all of them have are
+ * processed.
+ */
+void
+e_bitvec_xor (E_Bitvec *dst, const E_Bitvec *a, const E_Bitvec *b)
+{
+    e_bitvec__apply (dst, a, b, E_BITVEC__XOR);
+}
+
+/**
+ * Store the bits of `a` that are not set in `b` (i.e. `a & ~b`) in `dst`. `dst` may be the same
+ * bit vector as `a` or `b`.
+ *
+ * If the bit vectors do not have the same capacity, only the bits that all of them have are
+ * processed.
+ */
+void
+e_bitvec_andnot (E_Bitvec *dst, const E_Bitvec *a, const E_Bitvec *b)
+{
+    e_bitvec__apply (dst, a, b, E_BITVEC__ANDNOT);
+}
+
+/**
+ * Store the bitwise negation of `a` in `dst`. `dst` may be the same bit vector as `a`.
+ *
+ * If the bit vectors do not have the same capacity, only the bits that both of them have are
+ * processed.
+ */
+void
+e_bitvec_not (E_Bitvec *dst, const E_Bitvec *a)
+{
+    e_bitvec__apply (dst, a, NULL, E_BITVEC__NOT);
+}
+
+/**
+ * Count the bits that are set to 1 in both `a` and `b`, without storing the intersection anywhere.
+ *
+ * If the bit vectors do not have the same capacity, only the bits that both of them have are
+ * counted.
+ */
+size_t
+e_bitvec_count_and (const E_Bitvec *a, const E_Bitvec *b)
+{
+    const E_Bitvec_Word *x = a->data, *y = b->data;
+    size_t i = 0, words, cap, count = 0;
+
+    cap = a->cap < b->cap ? a->cap : b->cap;
+    words = cap / E_BITVEC_WORD_BITS; /* the last word is counted separately if it is partial */
+
+# if defined(E_BITVEC__AVX2)
+    {
+        /* count the bits of every nibble with a lookup table and sum up the bytes with `sad` */
+        const size_t step = sizeof (__m256i) / sizeof (E_Bitvec_Word);
+        const __m256i lookup = _mm256_setr_epi8 (0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0,
+                                                 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i low_mask = _mm256_set1_epi8 (0x0F);
+        __m256i sum = _mm256_setzero_si256 (), v, counts;
+        E_Bitvec_Word lanes[sizeof (__m256i) / sizeof (E_Bitvec_Word)];
+        size_t j;
+
+        for (; i + step <= words; i += step) {
+            v = _mm256_and_si256 (_mm256_loadu_si256 ((const __m256i *) (const void *) &x[i]),
+                                  _mm256_loadu_si256 ((const __m256i *) (const void *) &y[i]));
+            counts = _mm256_shuffle_epi8 (lookup, _mm256_and_si256 (v, low_mask));
+            v = _mm256_and_si256 (_mm256_srli_epi16 (v, 4), low_mask);
+            counts = _mm256_add_epi8 (counts, _mm256_shuffle_epi8 (lookup, v));
+            sum = _mm256_add_epi64 (sum, _mm256_sad_epu8 (counts, _mm256_setzero_si256 ()));
+        }
+        _mm256_storeu_si256 ((__m256i *) (void *) lanes, sum);
+        for (j = 0; j < step; j++) {
+            count += (size_t) lanes[j];
+        }
+    }
+# endif
+
+    for (; i < words; i++) {
+        count += e_bitvec__popcount (x[i] & y[i]);
+    }
+    if (cap % E_BITVEC_WORD_BITS != 0) {
+        count += e_bitvec__popcount (x[i] & y[i] & e_bitvec__mask (i, 0, cap));
+    }
+    return count;
+}
+
+/**
+ * Index of the `k`th (counting from 0) set bit in `word`, which must have more than `k` set bits.
+ */
+size_t
+e_bitvec__select_word (E_Bitvec_Word word, size_t k)
+{
+# ifdef E_BITVEC__BMI2
+    return e_bitvec__ctz (_pdep_u64 ((uint64_t) 1 << k, word));
+# else
+    for (; k > 0; k--) {
+        word &= word - 1;
+    }
+    return e_bitvec__ctz (word);
+# endif
+}
+
+/**
+ * Obtain the number of bytes that the rank/select index of a bit vector with `cap` bits requires.
+ */
+size_t
+e_bitvec_rank_size (size_t cap)
+{
+    size_t words, superblocks, blocks, samples;
+
+    words = E_BITVEC_WORDS (cap);
+    superblocks = (words + E_BITVEC__SUPERBLOCK_WORDS - 1) / E_BITVEC__SUPERBLOCK_WORDS;
+    blocks = (words + E_BITVEC__BLOCK_WORDS - 1) / E_BITVEC__BLOCK_WORDS;
+    samples = cap / E_BITVEC__SELECT_SAMPLE + 1;
+    return (superblocks + 1 + samples) * sizeof (size_t) + blocks * sizeof (unsigned short);
+}
+
+/**
+ * Build a rank/select index over `bitvec`. `memory` must point to `e_bitvec_rank_size (cap)` bytes
+ * that are aligned for `size_t`, and must stay valid as long as the index is used.
+ *
+ * The index refers to the bits of `bitvec` and does not notice when they are modified, so it has
+ * to be built again after the bit vector is changed.
+ */
+E_Bitvec_Rank
+e_bitvec_rank_init (const E_Bitvec *bitvec, void *memory)
+{
+    E_Bitvec_Rank rank;
+    E_Bitvec_Word word;
+    size_t words, i, count, in_superblock, next_sample;
+
+    words = E_BITVEC_WORDS (bitvec->cap);
+    rank.bitvec = *bitvec;
+    rank.superblock_count = (words + E_BITVEC__SUPERBLOCK_WORDS - 1) / E_BITVEC__SUPERBLOCK_WORDS;
+    rank.block_count = (words + E_BITVEC__BLOCK_WORDS - 1) / E_BITVEC__BLOCK_WORDS;
+    rank.superblocks = memory;
+    rank.samples = rank.superblocks + rank.superblock_count + 1;
+    rank.blocks = (unsigned short *) (void *) (rank.samples + bitvec->cap /
+                                               E_BITVEC__SELECT_SAMPLE + 1);
+    rank.sample_count = 0;
+
+    count = 0;
+    in_superblock = 0;
+    next_sample = 0;
+    for (i = 0; i < words; i++) {
+        if (i % E_BITVEC__SUPERBLOCK_WORDS == 0) {
+            rank.superblocks[i / E_BITVEC__SUPERBLOCK_WORDS] = count;
+            in_superblock = 0;
+        }
+        if (i % E_BITVEC__BLOCK_WORDS == 0) {
+            rank.blocks[i / E_BITVEC__BLOCK_WORDS] = (unsigned short) in_superblock;
+        }
+
+        word = bitvec->data[i];
+        if (i == words - 1) word &= e_bitvec__mask (i, 0, bitvec->cap);
+        in_superblock += e_bitvec__popcount (word);
+        while (next_sample < count + e_bitvec__popcount (word)) {
+            rank.samples[rank.sample_count++] = i / E_BITVEC__SUPERBLOCK_WORDS;
+            next_sample += E_BITVEC__SELECT_SAMPLE;
+        }
+        count += e_bitvec__popcount (word);
+    }
+    rank.superblocks[rank.superblock_count] = count;
+    rank.ones = count;
+    return rank;
+}
+
+/**
+ * Count the bits before `index` (i.e. within the range from 0 to `index`) that are set to 1. If
+ * `index` is out of range, all set bits are counted.
+ */
+size_t
+e_bitvec_rank1 (const E_Bitvec_Rank *rank, size_t index)
+{
+    size_t i, j, count;
+
+    if (index >= rank->bitvec.cap) return rank->ones;
+    i = index / E_BITVEC_WORD_BITS;
+    count = rank->superblocks[i / E_BITVEC__SUPERBLOCK_WORDS] +
+            rank->blocks[i / E_BITVEC__BLOCK_WORDS];
+    for (j = i - i % E_BITVEC__BLOCK_WORDS; j < i; j++) {
+        count += e_bitvec__popcount (rank->bitvec.data[j]);
+    }
+    return count +
+           e_bitvec__popcount (rank->bitvec.data[i] & (E_Bitvec_Word) (E_BITVEC__BIT (index) - 1));
+}
+
+/**
+ * Count the bits before `index` (i.e. within the range from 0 to `index`) that are set to 0. If
+ * `index` is out of range, all unset bits are counted.
+ */
+size_t
+e_bitvec_rank0 (const E_Bitvec_Rank *rank, size_t index)
+{
+    if (index > rank->bitvec.cap) index = rank->bitvec.cap;
+    return index - e_bitvec_rank1 (rank, index);
+}
+
+/**
+ * Find the index of the `k`th set bit, counting from 0 (i.e. the index `i` for which
+ * `e_bitvec_rank1 (rank, i) == k` and bit `i` is set). If fewer than `k + 1` bits are set,
+ * `E_BITVEC_NONE` is returned.
+ */
+size_t
+e_bitvec_select1 (const E_Bitvec_Rank *rank, size_t k)
+{
+    size_t lo, hi, mid, i, end, count;
+
+    if (k >= rank->ones) return E_BITVEC_NONE;
+
+    /* the samples narrow down the superblocks that contain the bit */
+    lo = rank->samples[k / E_BITVEC__SELECT_SAMPLE];
+    hi = k / E_BITVEC__SELECT_SAMPLE + 1 < rank->sample_count
+           ? rank->samples[k / E_BITVEC__SELECT_SAMPLE + 1] + 1
+           : rank->superblock_count;
+    while (hi - lo > 1) {
+        mid = lo + (hi - lo) / 2;
+        if (rank->superblocks[mid] <= k) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    k -= rank->superblocks[lo];
+
+    /* find the block within the superblock */
+    lo *= E_BITVEC__SUPERBLOCK_WORDS / E_BITVEC__BLOCK_WORDS;
+    hi = lo + E_BITVEC__SUPERBLOCK_WORDS / E_BITVEC__BLOCK_WORDS;
+    if (hi > rank->block_count) hi = rank->block_count;
+    while (hi - lo > 1) {
+        mid = lo + (hi - lo) / 2;
+        if (rank->blocks[mid] <= k) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    k -= rank->blocks[lo];
+
+    /* find the word within the block */
+    i = lo * E_BITVEC__BLOCK_WORDS;
+    end = E_BITVEC_WORDS (rank->bitvec.cap);
+    if (end > i + E_BITVEC__BLOCK_WORDS) end = i + E_BITVEC__BLOCK_WORDS;
+    for (; i + 1 < end; i++) {
+        count = e_bitvec__popcount (rank->bitvec.data[i]);
+        if (count > k) break;
+        k -= count;
+    }
+    return i * E_BITVEC_WORD_BITS + e_bitvec__select_word (rank->bitvec.data[i], k);
 }
 
 #endif /* E_BITVEC_IMPL */
@@ -0,0 +1,352 @@
+#ifndef E_CDA_H_
+#define E_CDA_H_
+
+/**************************************************************************************************
+ *
+ * Empower / e_cda.h - Public Domain - https://git.tjdev.de/thetek/empower
+ *
+ * This module implements concurrent append-only arrays for generic types.
+ *
+ * Multiple threads can append to the same array at the same time without any locks: every append
+ * reserves its slots with a single atomic fetch-add, and the items are stored in segments of
+ * exponentially increasing size (like in e_segda.h), so the storage never has to be reallocated.
+ * Items never move, so pointers to them stay valid until the array is deinitialised.
+ *
+ * Every slot has a ready flag that is set once its item has been written. The committed length is
+ * the longest prefix of ready slots, and is advanced by whichever thread finds new ready slots, so
+ * appends never wait for each other. Readers thus always see a consistent length: every item below
+ * `e_cda_len` has been fully written, even while other threads are still appending.
+ *
+ * It can be used as follows:
+ *
+ * ```
+ * E_Cda (int) results = e_cda_init ();
+ * // in any number of threads:
+ * e_cda_push (&results, 42);
+ * // after all threads are done:
+ * E_Da (int) da = e_da_init ();
+ * e_cda_to_da (&results, &da);
+ * e_cda_deinit (&results);
+ * ```
+ *
+ * Appending is safe from any number of threads. `e_cda_len` and `e_cda_nth` (for indices below a
+ * previously obtained length) can be used concurrently with appends. `e_cda_deinit` and
+ * `e_cda_to_da` must only be used once all appends have completed.
+ *
+ * A thread that stalls between reserving and committing its slots does not block other appends,
+ * but the length does not grow past its slots until it has committed them.
+ *
+ * This module requires C11 atomics.
+ *
+ * On allocation failure, an error message is printed and the programme is aborted.
+ *
+ * Configuration options:
+ *  - `E_CONFIG_CDA_BASE_SHIFT`: Base-2 logarithm of the number of items in the first segment
+ *    (default: 6, i.e. 64 items).
+ *
+ **************************************************************************************************/
+
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 201112L || defined(__STDC_NO_ATOMICS__)
+# error e_cda requires C11 or newer with atomics
+#endif
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/* compatibility annoyances: */
+#ifndef E_TYPEOF
+# if __STDC_VERSION__ >= 202311L
+#  define E_TYPEOF(x) typeof (x)
+# else
+#  define E_TYPEOF(x) __typeof__ (x)
+# endif
+#endif /* E_TYPEOF */
+
+#ifdef E_CONFIG_CDA_BASE_SHIFT
+# define E_CDA__BASE_SHIFT E_CONFIG_CDA_BASE_SHIFT
+#else
+# define E_CDA__BASE_SHIFT 6
+#endif
+#define E_CDA__BASE         ((size_t) 1 << E_CDA__BASE_SHIFT)
+#define E_CDA__MAX_SEGMENTS (sizeof (size_t) * 8 - E_CDA__BASE_SHIFT)
+#define E_CDA__CACHE_LINE   64
+
+/**
+ * Generic concurrent append-only array
+ */
+#define E_Cda(T)                                                                                   \
+    union {                                                                                        \
+        E_Cda_Data data;                                                                           \
+        T *type; /* NOLINT */                                                                      \
+    }
+
+/**
+ * Initialise a new concurrent append-only array.
+ *
+ * No memory is allocated yet.
+ */
+#define e_cda_init() {0}
+
+/**
+ * Free the memory occupied by the concurrent append-only array.
+ */
+#define e_cda_deinit(cda) e_cda__deinit (&(cda)->data, sizeof (*(cda)->type))
+
+/**
+ * Obtain the number of committed items of the concurrent append-only array.
+ */
+#define e_cda_len(cda) e_cda__len (&(cda)->data, sizeof (*(cda)->type))
+
+/**
+ * Obtain a pointer to the nth item of the concurrent append-only array. `n` must be less than a
+ * length that was previously obtained with `e_cda_len`.
+ *
+ * This does not perform any bounds checks.
+ */
+#define e_cda_nth(cda, n)                                                                          \
+    ((E_TYPEOF ((cda)->type)) e_cda__nth (&(cda)->data, (n), sizeof (*(cda)->type)))
+
+/**
+ * Append a single item to the end of the concurrent append-only array.
+ */
+#define e_cda_push(cda, item)                                                                      \
+    do {                                                                                           \
+        E_TYPEOF (*(cda)->type) e_cda__item = (item);                                              \
+        e_cda_extend ((cda), &e_cda__item, 1);                                                     \
+    } while (0)
+
+/**
+ * Append multiple items to the end of the concurrent append-only array. The items are stored
+ * contiguously in terms of their indices, and the index of the first one is returned.
+ */
+#define e_cda_extend(cda, items, count)                                                            \
+    e_cda__extend (&(cda)->data, (1 ? (items) : (cda)->type), (count), sizeof (*(cda)->type))
+
+/**
+ * Append the items of the concurrent append-only array to the dynamic array `da` (see e_da.h),
+ * which must have the same item type.
+ */
+#define e_cda_to_da(cda, da)                                                                       \
+    e_cda__copy_to (&(cda)->data, (1 ? e_da_extend_uninit ((da), e_cda_len (cda)) : (cda)->type),  \
+                    e_cda_len (cda), sizeof (*(cda)->type))
+
+typedef struct {
+    _Atomic (size_t) reserved;
+    unsigned char pad_[E_CDA__CACHE_LINE - sizeof (size_t)];
+    _Atomic (size_t) len;                           /* longest prefix of ready slots */
+    _Atomic (void *) segments[E_CDA__MAX_SEGMENTS]; /* items, followed by their ready flags */
+} E_Cda_Data;
+
+void e_cda__deinit (E_Cda_Data *cda, size_t item_size);
+size_t e_cda__len (E_Cda_Data *cda, size_t item_size);
+void *e_cda__nth (E_Cda_Data *cda, size_t n, size_t item_size);
+size_t e_cda__extend (E_Cda_Data *cda, const void *items, size_t count, size_t item_size);
+void e_cda__commit (E_Cda_Data *cda, size_t start, size_t count, size_t item_size);
+void e_cda__copy_to (E_Cda_Data *cda, void *dst, size_t count, size_t item_size);
+
+/**************************************************************************************************/
+
+#ifdef E_CDA_IMPL
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+
+size_t e_cda__msb (size_t x);
+void *e_cda__segment (E_Cda_Data *cda, size_t k, size_t item_size);
+_Atomic (unsigned char) *e_cda__ready_flags (void *segment, size_t k, size_t item_size);
+int e_cda__is_ready (E_Cda_Data *cda, size_t n, size_t item_size);
+
+/**
+ * Index of the most significant set bit of `x`, which must not be 0.
+ */
+size_t
+e_cda__msb (size_t x)
+{
+# if defined(__GNUC__) || defined(__clang__)
+    return (sizeof (unsigned long long) * 8 - 1) - (size_t) __builtin_clzll (x);
+# else
+    size_t r = 0;
+    while (x >>= 1)
+        r += 1;
+    return r;
+# endif
+}
+
+/**
+ * Obtain the ready flags of the items in segment `k`, which are stored after the items.
+ */
+_Atomic (unsigned char) *
+e_cda__ready_flags (void *segment, size_t k, size_t item_size)
+{
+    return (void *) ((unsigned char *) segment + (E_CDA__BASE << k) * item_size);
+}
+
+/**
+ * Obtain segment `k`, allocating it if no other thread has done so yet.
+ */
+void *
+e_cda__segment (E_Cda_Data *cda, size_t k, size_t item_size)
+{
+    _Atomic (unsigned char) *ready;
+    void *segment, *expected;
+    size_t i;
+
+    segment = atomic_load_explicit (&cda->segments[k], memory_order_acquire);
+    if (segment != NULL) return segment;
+
+    segment = malloc ((E_CDA__BASE << k) * (item_size + 1));
+    if (segment == NULL) {
+        fprintf (stderr, "[e_cda] allocation failed!\n");
+        abort ();
+    }
+    ready = e_cda__ready_flags (segment, k, item_size);
+    for (i = 0; i < E_CDA__BASE << k; i++) {
+        atomic_init (&ready[i], 0);
+    }
+    expected = NULL;
+    if (!atomic_compare_exchange_strong_explicit (&cda->segments[k], &expected, segment,
+                                                  memory_order_acq_rel, memory_order_acquire)) {
+        /* another thread was faster */
+        free (segment);
+        segment = expected;
+    }
+    return segment;
+}
+
+void
+e_cda__deinit (E_Cda_Data *cda, size_t item_size)
+{
+    size_t k;
+
+    (void) item_size;
+    for (k = 0; k < E_CDA__MAX_SEGMENTS; k++) {
+        free (atomic_load_explicit (&cda->segments[k], memory_order_relaxed));
+    }
+}
+
+/**
+ * Check whether the item at index `n` has been written.
+ */
+int
+e_cda__is_ready (E_Cda_Data *cda, size_t n, size_t item_size)
+{
+    void *segment;
+    size_t k, offset;
+
+    k = e_cda__msb (n + E_CDA__BASE) - E_CDA__BASE_SHIFT;
+    segment = atomic_load_explicit (&cda->segments[k], memory_order_acquire);
+    if (segment == NULL) return 0;
+    offset = n + E_CDA__BASE - ((size_t) 1 << (k + E_CDA__BASE_SHIFT));
+    return atomic_load_explicit (&e_cda__ready_flags (segment, k, item_size)[offset],
+                                 memory_order_acquire);
+}
+
+/**
+ * Obtain the committed length, advancing it past the slots that have become ready since it was
+ * last advanced.
+ */
+size_t
+e_cda__len (E_Cda_Data *cda, size_t item_size)
+{
+    size_t len, n;
+
+    len = atomic_load_explicit (&cda->len, memory_order_acquire);
+    for (;;) {
+        n = len;
+        while (e_cda__is_ready (cda, n, item_size)) {
+            n += 1;
+        }
+        if (n == len) return len;
+        /* on failure, `len` is updated to the length that another thread has stored */
+        if (atomic_compare_exchange_weak_explicit (&cda->len, &len, n, memory_order_acq_rel,
+                                                   memory_order_acquire)) {
+            return n;
+        }
+    }
+}
+
+void *
+e_cda__nth (E_Cda_Data *cda, size_t n, size_t item_size)
+{
+    unsigned char *segment;
+    size_t msb;
+
+    n += E_CDA__BASE;
+    msb = e_cda__msb (n);
+    segment = atomic_load_explicit (&cda->segments[msb - E_CDA__BASE_SHIFT], memory_order_acquire);
+    return &segment[(n - ((size_t) 1 << msb)) * item_size];
+}
+
+size_t
+e_cda__extend (E_Cda_Data *cda, const void *items, size_t count, size_t item_size)
+{
+    const unsigned char *src = items;
+    unsigned char *segment;
+    size_t start, n, k, offset, run, remaining;
+
+    start = atomic_fetch_add_explicit (&cda->reserved, count, memory_order_relaxed);
+
+    /* write the items into the reserved slots, which may span multiple segments */
+    n = start;
+    remaining = count;
+    while (remaining > 0) {
+        k = e_cda__msb (n + E_CDA__BASE) - E_CDA__BASE_SHIFT;
+        offset = n + E_CDA__BASE - ((size_t) 1 << (k + E_CDA__BASE_SHIFT));
+        run = (E_CDA__BASE << k) - offset;
+        if (run > remaining) run = remaining;
+        segment = e_cda__segment (cda, k, item_size);
+        memcpy (&segment[offset * item_size], src, run * item_size);
+        src += run * item_size;
+        n += run;
+        remaining -= run;
+    }
+
+    e_cda__commit (cda, start, count, item_size);
+    return start;
+}
+
+/**
+ * Mark the `count` slots from index `start` on as ready, once their items have been written.
+ */
+void
+e_cda__commit (E_Cda_Data *cda, size_t start, size_t count, size_t item_size)
+{
+    _Atomic (unsigned char) *ready;
+    size_t n, k, offset;
+
+    /* the items must be visible to any thread that observes one of the flags */
+    atomic_thread_fence (memory_order_release);
+    for (n = start; n < start + count; n++) {
+        k = e_cda__msb (n + E_CDA__BASE) - E_CDA__BASE_SHIFT;
+        offset = n + E_CDA__BASE - ((size_t) 1 << (k + E_CDA__BASE_SHIFT));
+        ready = e_cda__ready_flags (atomic_load_explicit (&cda->segments[k], memory_order_relaxed),
+                                    k, item_size);
+        atomic_store_explicit (&ready[offset], 1, memory_order_relaxed);
+    }
+
+    /* of two appends that finish at the same time, at least one sees the flags of the other, so
+     * the length cannot get stuck before slots that are already ready */
+    atomic_thread_fence (memory_order_seq_cst);
+    e_cda__len (cda, item_size);
+}
+
+void
+e_cda__copy_to (E_Cda_Data *cda, void *dst, size_t count, size_t item_size)
+{
+    unsigned char *out = dst;
+    size_t k, run;
+
+    for (k = 0; count > 0; k++) {
+        run = E_CDA__BASE << k;
+        if (run > count) run = count;
+        memcpy (out, atomic_load_explicit (&cda->segments[k], memory_order_acquire),
+                run * item_size);
+        out += run * item_size;
+        count -= run;
+    }
+}
+
+#endif /* E_CDA_IMPL */
+
+#endif /* E_CDA_H_ */
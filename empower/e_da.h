@@ -27,11 +27,69 @@
  * Int_List second_list;
  * ```
  *
+ * By default, memory is allocated using `realloc` and `free`. A custom allocator (see `E_Allocator`
+ * in e_alloc.h) can be used by initialising the dynamic array with `e_da_init_with_allocator`. The
+ * allocator must outlive the dynamic array.
+ *
+ * For dynamic arrays that usually only hold a few items, `E_Da_Small (T, N)` stores up to `N` items
+ * inline and only allocates memory once it grows larger than that. All the regular `e_da_*` macros
+ * can be used on it:
+ *
+ * ```
+ * E_Da_Small (int, 8) small_list;
+ * e_da_small_init (&small_list);
+ * e_da_push (&small_list, 1); // no allocation
+ * e_da_deinit (&small_list);
+ * ```
+ *
+ * Sorting is done with functions that are generated for a specific item type, so that comparisons
+ * and swaps can be inlined by the compiler (see `E_DA_DECL_SORT` and `E_DA_IMPL_SORT`):
+ *
+ * ```
+ * E_DA_IMPL_SORT (int_sort, int)
+ * // ...
+ * e_da_sort (&int_list, int_sort);
+ * size_t index = e_da_lower_bound (&int_list, int_sort, 42);
+ * ```
+ *
+ * When the capacity of a dynamic array is exhausted, it is doubled by default. Other growth factors
+ * can be selected per dynamic array with `e_da_set_growth`, and the capacity can be managed
+ * explicitly with `e_da_reserve`, `e_da_reserve_exact` and `e_da_shrink_to_fit`.
+ *
+ * When a large number of mostly small dynamic arrays is needed (e.g. adjacency lists), `E_Da32 (T)`
+ * can be used instead. It stores the length and capacity as 32-bit integers and has no allocator or
+ * growth policy, so that its header is only 16 bytes large instead of the 24 bytes of a pointer
+ * with a `size_t` length and capacity (and the 40 bytes of `E_Da`). The read-only macros
+ * (`e_da_len`, `e_da_first`, `e_da_nth`, `e_da_last`, `e_da_foreach`, `e_da_sort`, ...) work on it
+ * as-is, while modifications are done with the `e_da32_*` variants of the regular macros:
+ *
+ * ```
+ * E_Da32 (int) neighbours = e_da32_init ();
+ * e_da32_push (&neighbours, 42);
+ * int *first = e_da_first (&neighbours);
+ * e_da32_deinit (&neighbours);
+ * ```
+ *
+ * On Linux, the allocator `e_da_mremap_allocator` can be used for very large arrays. Allocations
+ * above a threshold are backed by `mmap`, and growing them uses `mremap`, which remaps the pages
+ * instead of copying them. Pages that have not been touched yet do not occupy physical memory.
+ *
  * On allocation failure, an error message is printed and the programme is aborted.
  *
+ * Configuration options:
+ *  - `E_CONFIG_DA_INIT_CAP`: Number of items that are allocated when an empty dynamic array first
+ *    grows (default: 32).
+ *  - `E_CONFIG_DA_MREMAP`: When defined, enables `e_da_mremap_allocator` (Linux only). This
+ *    requires `_GNU_SOURCE` to be defined before any system header is included.
+ *  - `E_CONFIG_DA_MREMAP_THRESHOLD`: Allocation size in bytes from which `e_da_mremap_allocator`
+ *    uses `mmap` (default: 1 MiB).
+ *
  **************************************************************************************************/
 
 #include <stddef.h>
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+# include <stdint.h>
+#endif
 
 /* compatibility annoyances: */
 #ifndef E_TYPEOF
@@ -42,6 +100,17 @@
 # endif
 #endif /* E_TYPEOF */
 
+/* allocator interface (see e_alloc.h): */
+#ifndef E_ALLOCATOR_DEFINED
+# define E_ALLOCATOR_DEFINED
+typedef struct {
+    void *(*alloc_fn) (void *ctx, size_t size);
+    void *(*realloc_fn) (void *ctx, void *ptr, size_t old_size, size_t new_size);
+    void (*free_fn) (void *ctx, void *ptr, size_t size);
+    void *ctx;
+} E_Allocator;
+#endif /* E_ALLOCATOR_DEFINED */
+
 /**
  * Generic dynamic array
  */
@@ -51,6 +120,26 @@
         T *type; /* NOLINT */                                                                      \
     }
 
+/**
+ * Generic dynamic array with inline storage for up to `N` items
+ *
+ * The items are stored inside of the dynamic array itself until more than `N` items are added, at
+ * which point they are moved to heap memory. It has to be initialised with `e_da_small_init`, and
+ * all other `e_da_*` macros work the same as for `E_Da`.
+ *
+ * Since the dynamic array points to its own inline storage, it must not be copied or moved (e.g.
+ * returned by value from a function) after it has been initialised.
+ */
+#define E_Da_Small(T, N)                                                                           \
+    union {                                                                                        \
+        E_Da_Data data;                                                                            \
+        T *type; /* NOLINT */                                                                      \
+        struct {                                                                                   \
+            E_Da_Data data_;                                                                       \
+            T items[N];                                                                            \
+        } small;                                                                                   \
+    }
+
 /**
  * Initialise a new dynamic array.
  *
@@ -58,10 +147,39 @@
  */
 #define e_da_init() {0}
 
+/**
+ * Initialise a new dynamic array that obtains its memory from `allocator` (of type `const
+ * E_Allocator *`). Passing `NULL` is equivalent to `e_da_init()`.
+ *
+ * No memory is allocated yet.
+ *
+ * In C89, initialisers must be constant, so you may have to set the allocator manually instead:
+ * ```
+ * E_Da (int) da = e_da_init ();
+ * da.data.allocator = &allocator;
+ * ```
+ */
+#define e_da_init_with_allocator(allocator) {{NULL, 0, 0, (allocator), 0}}
+
+/**
+ * Initialise a dynamic array of type `E_Da_Small`, so that it uses its inline storage.
+ *
+ * No memory is allocated yet.
+ */
+#define e_da_small_init(da) e_da_small_init_with_allocator ((da), NULL)
+
+/**
+ * Initialise a dynamic array of type `E_Da_Small` that obtains its memory from `allocator` (of type
+ * `const E_Allocator *`) once it outgrows its inline storage.
+ */
+#define e_da_small_init_with_allocator(da, allocator)                                              \
+    e_da__init_inline (&(da)->data, (da)->small.items,                                             \
+                       sizeof ((da)->small.items) / sizeof (*(da)->type), (allocator))
+
 /**
  * Free the memory occupied by the dynamic array.
  */
-#define e_da_deinit(da) e_da__deinit (&(da)->data)
+#define e_da_deinit(da) e_da__deinit (&(da)->data, sizeof (*(da)->type))
 
 /**
  * Obtain the length (i.e. the number of contained items) of the dynamic array.
@@ -131,6 +249,103 @@
  */
 #define e_da_pop(da, count) e_da__pop (&(da)->data, (count))
 
+/**
+ * Insert a single item at position `index` of the dynamic array, moving the following items back.
+ *
+ * This does not perform any bounds checks.
+ */
+#define e_da_insert(da, index, item)                                                               \
+    do {                                                                                           \
+        E_TYPEOF (*(da)->type) e_da__item = (item);                                                \
+        e_da_insert_n ((da), (index), &e_da__item, 1);                                             \
+    } while (0)
+
+/**
+ * Insert `count` items at position `index` of the dynamic array, moving the following items back.
+ * The inserted items must not be part of the dynamic array itself.
+ *
+ * This does not perform any bounds checks.
+ */
+#define e_da_insert_n(da, index, items, count)                                                     \
+    e_da__splice (&(da)->data, (index), 0, (1 ? (items) : (da)->type), (count),                    \
+                  sizeof (*(da)->type))
+
+/**
+ * Remove `count` items starting at position `index` from the dynamic array, moving the following
+ * items forward. If fewer than `count` items follow `index`, all of them are removed.
+ */
+#define e_da_erase_range(da, index, count)                                                         \
+    e_da__splice (&(da)->data, (index), (count), NULL, 0, sizeof (*(da)->type))
+
+/**
+ * Remove the item at position `index` from the dynamic array by replacing it with the last item.
+ * This does not preserve the order of the items, but does not have to move the following items.
+ *
+ * This does not perform any bounds checks.
+ */
+#define e_da_swap_remove(da, index) e_da__swap_remove (&(da)->data, (index), sizeof (*(da)->type))
+
+/**
+ * Replace `remove_count` items starting at position `index` of the dynamic array with
+ * `insert_count` items from `items`. The following items are moved at most once. The inserted
+ * items must not be part of the dynamic array itself.
+ */
+#define e_da_splice(da, index, remove_count, items, insert_count)                                  \
+    e_da__splice (&(da)->data, (index), (remove_count), (1 ? (items) : (da)->type),                \
+                  (insert_count), sizeof (*(da)->type))
+
+/**
+ * Remove all items from the dynamic array for which the expression `keep` evaluates to false,
+ * preserving the order of the remaining items. Within `keep`, `it` is a pointer to the current
+ * item. This can also be used with `E_Da32`.
+ *
+ * ```
+ * e_da_retain (&int_list, it, *it % 2 == 0); // remove all odd numbers
+ * ```
+ */
+#define e_da_retain(da, it, keep)                                                                  \
+    do {                                                                                           \
+        E_TYPEOF ((da)->type) e_da__dst = e_da_first (da);                                         \
+        E_TYPEOF ((da)->type) (it) = e_da_first (da);                                              \
+        E_TYPEOF ((da)->type) e_da__end;                                                           \
+        if ((da)->data.len == 0) break;                                                            \
+        for (e_da__end = (it) + (da)->data.len; (it) < e_da__end; (it) += 1) {                     \
+            if (!(keep)) continue;                                                                 \
+            if (e_da__dst != (it)) *e_da__dst = *(it);                                             \
+            e_da__dst += 1;                                                                        \
+        }                                                                                          \
+        (da)->data.len = (E_TYPEOF ((da)->data.len)) (e_da__dst - e_da_first (da));                \
+    } while (0)
+
+/**
+ * Make sure that the dynamic array has space for at least `cap` items in total, growing it
+ * according to its growth policy if necessary.
+ */
+#define e_da_reserve(da, cap) e_da__reserve (&(da)->data, (cap), sizeof (*(da)->type))
+
+/**
+ * Make sure that the dynamic array has space for at least `cap` items in total. If the capacity has
+ * to be increased, exactly `cap` items are allocated.
+ */
+#define e_da_reserve_exact(da, cap) e_da__reserve_exact (&(da)->data, (cap), sizeof (*(da)->type))
+
+/**
+ * Reduce the capacity of the dynamic array to its length, releasing unused memory. If the dynamic
+ * array is empty, its memory is freed. Inline storage (see `E_Da_Small`) is never released.
+ */
+#define e_da_shrink_to_fit(da) e_da__shrink_to_fit (&(da)->data, sizeof (*(da)->type))
+
+/**
+ * Set the factor by which the capacity of the dynamic array grows when it is exhausted. `growth`
+ * is one of `E_DA_GROWTH_2` (the default), `E_DA_GROWTH_1_5` or `E_DA_GROWTH_1_25`. Smaller
+ * factors waste less memory for large arrays, at the cost of more frequent reallocations.
+ */
+#define e_da_set_growth(da, growth) e_da__set_growth (&(da)->data, (growth))
+
+#define E_DA_GROWTH_2    0u
+#define E_DA_GROWTH_1_5  1u
+#define E_DA_GROWTH_1_25 2u
+
 /**
  * Iterate over the dynamic array.
  *
@@ -150,17 +365,344 @@
           (it) < ((E_TYPEOF ((da)->type)) ((da)->data.ptr) + (da)->data.len); (it) += 1)
 #endif
 
+/**
+ * Generic dynamic array with a compact header
+ *
+ * The length and capacity are stored as 32-bit integers, and the dynamic array always uses
+ * `realloc` and `free`. The capacity starts small and grows by a factor of 1.5, since such arrays
+ * are usually used in large numbers and hold only a few items each. If the length would exceed
+ * `UINT32_MAX`, an error message is printed and the programme is aborted.
+ */
+#define E_Da32(T)                                                                                  \
+    union {                                                                                        \
+        E_Da32_Data data;                                                                          \
+        T *type; /* NOLINT */                                                                      \
+    }
+
+/**
+ * Initialise a new dynamic array of type `E_Da32`.
+ *
+ * No memory is allocated yet.
+ */
+#define e_da32_init() {0}
+
+/**
+ * Free the memory occupied by a dynamic array of type `E_Da32`.
+ */
+#define e_da32_deinit(da) e_da32__deinit (&(da)->data)
+
+/**
+ * Append a single item to the end of a dynamic array of type `E_Da32`.
+ */
+#define e_da32_push(da, item)                                                                      \
+    do {                                                                                           \
+        E_TYPEOF (*(da)->type) e_da32__item = (item);                                              \
+        e_da32_extend ((da), &e_da32__item, 1);                                                    \
+    } while (0)
+
+/**
+ * Append a single item to the end of a dynamic array of type `E_Da32` (but the item is a pointer).
+ */
+#define e_da32_push_ref(da, item_ref) e_da32_extend ((da), (1 ? (item_ref) : (da)->type), 1)
+
+/**
+ * Make room for an additional item in a dynamic array of type `E_Da32`, but don’t initialize that
+ * item (see `e_da_push_uninit`).
+ */
+#define e_da32_push_uninit(da)                                                                     \
+    ((E_TYPEOF ((da)->type)) e_da32__extend_uninit (&(da)->data, 1, sizeof (*(da)->type)))
+
+/**
+ * Extend a dynamic array of type `E_Da32` by multiple items.
+ */
+#define e_da32_extend(da, items, count)                                                            \
+    e_da32__extend (&(da)->data, (1 ? (items) : (da)->type), (count), sizeof (*(da)->type))
+
+/**
+ * Make room for `count` additional items in a dynamic array of type `E_Da32`, but don’t initialize
+ * them (see `e_da_extend_uninit`).
+ */
+#define e_da32_extend_uninit(da, count)                                                            \
+    ((E_TYPEOF ((da)->type)) e_da32__extend_uninit (&(da)->data, (count), sizeof (*(da)->type)))
+
+/**
+ * Remove a certain number of items from the end of a dynamic array of type `E_Da32`.
+ */
+#define e_da32_pop(da, count) e_da32__pop (&(da)->data, (count))
+
+/**
+ * Make sure that a dynamic array of type `E_Da32` has space for at least `cap` items in total.
+ */
+#define e_da32_reserve(da, cap) e_da32__reserve (&(da)->data, (cap), sizeof (*(da)->type))
+
+/**
+ * Reduce the capacity of a dynamic array of type `E_Da32` to its length.
+ */
+#define e_da32_shrink_to_fit(da) e_da32__shrink_to_fit (&(da)->data, sizeof (*(da)->type))
+
+/**
+ * Sort the dynamic array in ascending order using the sorting function `name` that was generated
+ * by `E_DA_IMPL_SORT` or `E_DA_IMPL_SORT_BY`.
+ */
+#define e_da_sort(da, name) name (e_da_first (da), e_da_len (da))
+
+/**
+ * Find the index of the first item in a sorted dynamic array that is not less than `key`, using
+ * the functions generated for `name` (see `E_DA_IMPL_SORT`). If there is no such item, the length
+ * of the dynamic array is returned.
+ */
+#define e_da_lower_bound(da, name, key) name##_lower_bound (e_da_first (da), e_da_len (da), (key))
+
+/**
+ * Find the index of the first item in a sorted dynamic array that is greater than `key`, using
+ * the functions generated for `name` (see `E_DA_IMPL_SORT`). If there is no such item, the length
+ * of the dynamic array is returned.
+ */
+#define e_da_upper_bound(da, name, key) name##_upper_bound (e_da_first (da), e_da_len (da), (key))
+
+/**
+ * Default ordering used by `E_DA_IMPL_SORT`.
+ */
+#define E_DA_LESS(a, b) ((a) < (b))
+
+/**
+ * The `E_DA_DECL_SORT` and `E_DA_IMPL_SORT` macros generate a sorting function `name` for arrays
+ * of items of type `T`, along with the binary search functions `name##_lower_bound` and
+ * `name##_upper_bound`. Since the comparison is known at compile time, no function pointers are
+ * involved and items are moved with plain assignments.
+ *
+ * `E_DA_IMPL_SORT_BY` does the same, but uses `less (a, b)` as the ordering, where `less` is a
+ * function or function-like macro that takes two items by value and returns non-zero if `a` has
+ * to be placed before `b`. `E_DA_IMPL_SORT` uses the `<` operator.
+ *
+ * The sorting algorithm is introsort (quicksort with median-of-three pivots, falling back to
+ * heapsort when the recursion gets too deep and to insertion sort for short ranges). It is not
+ * stable. `T` must be a type name that can be prefixed with `const` (use a `typedef` for pointer
+ * types).
+ *
+ * Example:
+ *
+ *     // ----- (points.h) -----
+ *     E_DA_DECL_SORT (point_sort, Point);
+ *
+ *     // ----- (points.c) -----
+ *     #define POINT_LESS(a, b) ((a).x < (b).x)
+ *     E_DA_IMPL_SORT_BY (point_sort, Point, POINT_LESS)
+ *
+ * Generated functions:
+ *
+ *     void point_sort (Point *ptr, size_t len);
+ *     size_t point_sort_lower_bound (const Point *ptr, size_t len, Point key);
+ *     size_t point_sort_upper_bound (const Point *ptr, size_t len, Point key);
+ */
+#define E_DA_DECL_SORT(name, T)                                                                    \
+    void name (T *ptr, size_t len);                                                                \
+    size_t name##_lower_bound (const T *ptr, size_t len, T key);                                   \
+    size_t name##_upper_bound (const T *ptr, size_t len, T key)
+#define E_DA_IMPL_SORT(name, T) E_DA_IMPL_SORT_BY (name, T, E_DA_LESS)
+#define E_DA_IMPL_SORT_BY(name, T, less)                                                           \
+    static void name##__swap (T *a, T *b)                                                          \
+    {                                                                                              \
+        T tmp;                                                                                     \
+        tmp = *a;                                                                                  \
+        *a = *b;                                                                                   \
+        *b = tmp;                                                                                  \
+    }                                                                                              \
+    static void name##__insertion_sort (T *ptr, size_t len)                                        \
+    {                                                                                              \
+        size_t i, j;                                                                               \
+        T tmp;                                                                                     \
+        for (i = 1; i < len; i++) {                                                                \
+            tmp = ptr[i];                                                                          \
+            for (j = i; j > 0 && less (tmp, ptr[j - 1]); j--)                                      \
+                ptr[j] = ptr[j - 1];                                                               \
+            ptr[j] = tmp;                                                                          \
+        }                                                                                          \
+    }                                                                                              \
+    static void name##__sift_down (T *ptr, size_t root, size_t len)                                \
+    {                                                                                              \
+        size_t child;                                                                              \
+        T tmp;                                                                                     \
+        tmp = ptr[root];                                                                           \
+        while ((child = 2 * root + 1) < len) {                                                     \
+            if (child + 1 < len && less (ptr[child], ptr[child + 1])) child += 1;                  \
+            if (!less (tmp, ptr[child])) break;                                                    \
+            ptr[root] = ptr[child];                                                                \
+            root = child;                                                                          \
+        }                                                                                          \
+        ptr[root] = tmp;                                                                           \
+    }                                                                                              \
+    static void name##__heap_sort (T *ptr, size_t len)                                             \
+    {                                                                                              \
+        size_t i;                                                                                  \
+        for (i = len / 2; i > 0; i--)                                                              \
+            name##__sift_down (ptr, i - 1, len);                                                   \
+        for (i = len - 1; i > 0; i--) {                                                            \
+            name##__swap (&ptr[0], &ptr[i]);                                                       \
+            name##__sift_down (ptr, 0, i);                                                         \
+        }                                                                                          \
+    }                                                                                              \
+    static void name##__intro_sort (T *ptr, size_t len, size_t depth)                              \
+    {                                                                                              \
+        size_t mid, i, j;                                                                          \
+        T pivot;                                                                                   \
+        while (len > E_DA__SORT_THRESHOLD) {                                                       \
+            if (depth == 0) {                                                                      \
+                name##__heap_sort (ptr, len);                                                      \
+                return;                                                                            \
+            }                                                                                      \
+            depth -= 1;                                                                            \
+            /* median of three, so that ptr[0] <= pivot <= ptr[len - 1] */                         \
+            mid = len / 2;                                                                         \
+            if (less (ptr[mid], ptr[0])) {                                                         \
+                name##__swap (&ptr[mid], &ptr[0]);                                                 \
+            }                                                                                      \
+            if (less (ptr[len - 1], ptr[mid])) {                                                   \
+                name##__swap (&ptr[mid], &ptr[len - 1]);                                           \
+                if (less (ptr[mid], ptr[0])) {                                                     \
+                    name##__swap (&ptr[mid], &ptr[0]);                                             \
+                }                                                                                  \
+            }                                                                                      \
+            pivot = ptr[mid];                                                                      \
+            /* hoare partition: [0, j] <= pivot <= [j + 1, len) */                                 \
+            i = 0;                                                                                 \
+            j = len - 1;                                                                           \
+            for (;;) {                                                                             \
+                while (less (ptr[i], pivot))                                                       \
+                    i += 1;                                                                        \
+                while (less (pivot, ptr[j]))                                                       \
+                    j -= 1;                                                                        \
+                if (i >= j) break;                                                                 \
+                name##__swap (&ptr[i], &ptr[j]);                                                   \
+                i += 1;                                                                            \
+                j -= 1;                                                                            \
+            }                                                                                      \
+            /* recurse into the smaller partition, iterate on the larger one */                    \
+            if (j + 1 < len - (j + 1)) {                                                           \
+                name##__intro_sort (ptr, j + 1, depth);                                            \
+                ptr += j + 1;                                                                      \
+                len -= j + 1;                                                                      \
+            } else {                                                                               \
+                name##__intro_sort (&ptr[j + 1], len - (j + 1), depth);                            \
+                len = j + 1;                                                                       \
+            }                                                                                      \
+        }                                                                                          \
+        name##__insertion_sort (ptr, len);                                                         \
+    }                                                                                              \
+    void name (T *ptr, size_t len)                                                                 \
+    {                                                                                              \
+        size_t depth, n;                                                                           \
+        depth = 0;                                                                                 \
+        for (n = len; n > 1; n /= 2)                                                               \
+            depth += 2;                                                                            \
+        name##__intro_sort (ptr, len, depth);                                                      \
+    }                                                                                              \
+    size_t name##_lower_bound (const T *ptr, size_t len, T key)                                    \
+    {                                                                                              \
+        size_t lo, half;                                                                           \
+        lo = 0;                                                                                    \
+        while (len > 0) {                                                                          \
+            half = len / 2;                                                                        \
+            if (less (ptr[lo + half], key)) {                                                      \
+                lo += half + 1;                                                                    \
+                len -= half + 1;                                                                   \
+            } else {                                                                               \
+                len = half;                                                                        \
+            }                                                                                      \
+        }                                                                                          \
+        return lo;                                                                                 \
+    }                                                                                              \
+    size_t name##_upper_bound (const T *ptr, size_t len, T key)                                    \
+    {                                                                                              \
+        size_t lo, half;                                                                           \
+        lo = 0;                                                                                    \
+        while (len > 0) {                                                                          \
+            half = len / 2;                                                                        \
+            if (!less (key, ptr[lo + half])) {                                                     \
+                lo += half + 1;                                                                    \
+                len -= half + 1;                                                                   \
+            } else {                                                                               \
+                len = half;                                                                        \
+            }                                                                                      \
+        }                                                                                          \
+        return lo;                                                                                 \
+    }
+
+#define E_DA__SORT_THRESHOLD 16
+
+/**
+ * Sort a dynamic array of integer or floating point numbers in ascending order using an LSD radix
+ * sort. This runs in linear time, which is a lot faster than comparison-based sorting for large
+ * arrays, but it requires a temporary buffer of the same size as the array, which is obtained from
+ * the allocator of the dynamic array.
+ *
+ * The suffix denotes the item type: `u32` (`uint32_t`), `i32` (`int32_t`), `u64` (`uint64_t`),
+ * `i64` (`int64_t`), `f32` (`float`) and `f64` (`double`). NaNs are sorted to the start (negative
+ * NaNs) or end (positive NaNs) of the array.
+ */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+# define e_da_radix_sort_u32(da) e_da__radix_sort_typed (da, uint32_t, E_DA__RADIX_UNSIGNED)
+# define e_da_radix_sort_i32(da) e_da__radix_sort_typed (da, int32_t, E_DA__RADIX_SIGNED)
+# define e_da_radix_sort_u64(da) e_da__radix_sort_typed (da, uint64_t, E_DA__RADIX_UNSIGNED)
+# define e_da_radix_sort_i64(da) e_da__radix_sort_typed (da, int64_t, E_DA__RADIX_SIGNED)
+# define e_da_radix_sort_f32(da) e_da__radix_sort_typed (da, float, E_DA__RADIX_FLOAT)
+# define e_da_radix_sort_f64(da) e_da__radix_sort_typed (da, double, E_DA__RADIX_FLOAT)
+# define e_da__radix_sort_typed(da, T, kind)                                                       \
+     e_da__radix_sort (&(da)->data, sizeof (*(1 ? (da)->type : (T *) NULL)), (kind))
+# define E_DA__RADIX_UNSIGNED 0
+# define E_DA__RADIX_SIGNED   1
+# define E_DA__RADIX_FLOAT    2
+#endif
+
 typedef struct {
     void *ptr;
     size_t len;
     size_t cap;
+    const E_Allocator *allocator;
+    unsigned int flags;
 } E_Da_Data;
 
-void e_da__deinit (E_Da_Data *da);
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+typedef uint32_t E_Da32__Size;
+#else
+typedef unsigned int E_Da32__Size;
+#endif
+
+typedef struct {
+    void *ptr;
+    E_Da32__Size len;
+    E_Da32__Size cap;
+} E_Da32_Data;
+
+#define E_DA__FLAG_INLINE       0x1u /* `ptr` points to inline storage that must not be freed */
+#define E_DA__FLAG_GROWTH_SHIFT 1
+#define E_DA__FLAG_GROWTH_MASK  (0x3u << E_DA__FLAG_GROWTH_SHIFT)
+
+#if defined(E_CONFIG_DA_MREMAP) && defined(__linux__)
+extern const E_Allocator e_da_mremap_allocator;
+#endif
+
+void e_da__init_inline (E_Da_Data *da, void *ptr, size_t cap, const E_Allocator *allocator);
+void e_da__deinit (E_Da_Data *da, size_t item_size);
 void e_da__reserve (E_Da_Data *da, size_t cap, size_t item_size);
+void e_da__reserve_exact (E_Da_Data *da, size_t cap, size_t item_size);
+void e_da__shrink_to_fit (E_Da_Data *da, size_t item_size);
+void e_da__set_growth (E_Da_Data *da, unsigned int growth);
 void e_da__extend (E_Da_Data *da, void *data, size_t count, size_t item_size);
 void *e_da__extend_uninit (E_Da_Data *da, size_t count, size_t item_size);
 void e_da__pop (E_Da_Data *da, size_t count);
+void e_da__splice (E_Da_Data *da, size_t index, size_t remove_count, const void *items,
+                   size_t insert_count, size_t item_size);
+void e_da__swap_remove (E_Da_Data *da, size_t index, size_t item_size);
+void e_da32__deinit (E_Da32_Data *da);
+void e_da32__reserve (E_Da32_Data *da, size_t cap, size_t item_size);
+void e_da32__shrink_to_fit (E_Da32_Data *da, size_t item_size);
+void e_da32__extend (E_Da32_Data *da, void *data, size_t count, size_t item_size);
+void *e_da32__extend_uninit (E_Da32_Data *da, size_t count, size_t item_size);
+void e_da32__pop (E_Da32_Data *da, size_t count);
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+void e_da__radix_sort (E_Da_Data *da, size_t key_size, int kind);
+#endif
 
 /**************************************************************************************************/
 
@@ -170,28 +712,130 @@ void e_da__pop (E_Da_Data *da, size_t count);
 # include <stdlib.h>
 # include <string.h>
 
-# define E_DA__INIT_CAP 32
+# ifdef E_CONFIG_DA_INIT_CAP
+#  define E_DA__INIT_CAP E_CONFIG_DA_INIT_CAP
+# else
+#  define E_DA__INIT_CAP 32
+# endif
+
+void *e_da__mem_realloc (const E_Allocator *allocator, void *ptr, size_t old_size, size_t size);
+void e_da__mem_free (const E_Allocator *allocator, void *ptr, size_t size);
+
+void *
+e_da__mem_realloc (const E_Allocator *allocator, void *ptr, size_t old_size, size_t size)
+{
+    void *new_ptr;
+
+    if (allocator == NULL) {
+        new_ptr = realloc (ptr, size);
+    } else if (ptr == NULL) {
+        new_ptr = allocator->alloc_fn (allocator->ctx, size);
+    } else {
+        new_ptr = allocator->realloc_fn (allocator->ctx, ptr, old_size, size);
+    }
+    if (new_ptr == NULL) {
+        fprintf (stderr, "[e_da] allocation failed!\n");
+        abort ();
+    }
+    return new_ptr;
+}
 
 void
-e_da__deinit (E_Da_Data *da)
+e_da__mem_free (const E_Allocator *allocator, void *ptr, size_t size)
 {
-    free (da->ptr);
+    if (allocator == NULL) {
+        free (ptr);
+    } else if (ptr != NULL) {
+        allocator->free_fn (allocator->ctx, ptr, size);
+    }
 }
 
 void
-e_da__reserve (E_Da_Data *da, size_t cap, size_t item_size)
+e_da__init_inline (E_Da_Data *da, void *ptr, size_t cap, const E_Allocator *allocator)
+{
+    da->ptr = ptr;
+    da->len = 0;
+    da->cap = cap;
+    da->allocator = allocator;
+    da->flags = E_DA__FLAG_INLINE;
+}
+
+void
+e_da__deinit (E_Da_Data *da, size_t item_size)
+{
+    if (da->flags & E_DA__FLAG_INLINE) return;
+    e_da__mem_free (da->allocator, da->ptr, da->cap * item_size);
+}
+
+void e_da__set_cap (E_Da_Data *da, size_t cap, size_t item_size);
+
+/**
+ * Change the capacity of `da` to exactly `cap` items, which must not be less than its length.
+ */
+void
+e_da__set_cap (E_Da_Data *da, size_t cap, size_t item_size)
 {
     void *ptr;
-    if (cap <= da->cap) return;
-    if (da->cap == 0) da->cap = E_DA__INIT_CAP;
-    while (da->cap < cap)
-        da->cap *= 2;
-    ptr = realloc (da->ptr, da->cap * item_size);
-    if (ptr == NULL) {
-        fprintf (stderr, "[e_da] allocation failed!\n");
-        abort ();
+
+    if (da->flags & E_DA__FLAG_INLINE) {
+        /* move out of the inline storage */
+        ptr = e_da__mem_realloc (da->allocator, NULL, 0, cap * item_size);
+        memcpy (ptr, da->ptr, da->len * item_size);
+        da->flags &= ~E_DA__FLAG_INLINE;
+    } else if (cap == 0) {
+        e_da__mem_free (da->allocator, da->ptr, da->cap * item_size);
+        ptr = NULL;
+    } else {
+        ptr = e_da__mem_realloc (da->allocator, da->ptr, da->cap * item_size, cap * item_size);
     }
     da->ptr = ptr;
+    da->cap = cap;
+}
+
+void
+e_da__reserve (E_Da_Data *da, size_t cap, size_t item_size)
+{
+    size_t new_cap, next;
+
+    if (cap <= da->cap) return;
+    new_cap = da->cap == 0 ? E_DA__INIT_CAP : da->cap;
+    while (new_cap < cap) {
+        switch ((da->flags & E_DA__FLAG_GROWTH_MASK) >> E_DA__FLAG_GROWTH_SHIFT) {
+        case E_DA_GROWTH_1_5:
+            next = new_cap + new_cap / 2;
+            break;
+        case E_DA_GROWTH_1_25:
+            next = new_cap + new_cap / 4;
+            break;
+        default:
+            next = new_cap * 2;
+            break;
+        }
+        new_cap = next > new_cap ? next : new_cap + 1;
+    }
+    e_da__set_cap (da, new_cap, item_size);
+}
+
+void
+e_da__reserve_exact (E_Da_Data *da, size_t cap, size_t item_size)
+{
+    if (cap <= da->cap) return;
+    e_da__set_cap (da, cap, item_size);
+}
+
+void
+e_da__shrink_to_fit (E_Da_Data *da, size_t item_size)
+{
+    if (da->flags & E_DA__FLAG_INLINE) return;
+    if (da->len == da->cap) return;
+    e_da__set_cap (da, da->len, item_size);
+}
+
+void
+e_da__set_growth (E_Da_Data *da, unsigned int growth)
+{
+    da->flags &= ~E_DA__FLAG_GROWTH_MASK;
+    da->flags |= (growth << E_DA__FLAG_GROWTH_SHIFT) & E_DA__FLAG_GROWTH_MASK;
 }
 
 void
@@ -222,6 +866,284 @@ e_da__pop (E_Da_Data *da, size_t count)
     da->len -= count;
 }
 
+void
+e_da__splice (E_Da_Data *da, size_t index, size_t remove_count, const void *items,
+              size_t insert_count, size_t item_size)
+{
+    unsigned char *ptr;
+    size_t tail;
+
+    if (remove_count > da->len - index) remove_count = da->len - index;
+    tail = da->len - index - remove_count;
+    if (insert_count > remove_count) {
+        e_da__reserve (da, da->len - remove_count + insert_count, item_size);
+    }
+    ptr = da->ptr;
+    if (insert_count != remove_count && tail > 0) {
+        memmove (&ptr[(index + insert_count) * item_size], &ptr[(index + remove_count) * item_size],
+                 tail * item_size);
+    }
+    if (insert_count > 0) memcpy (&ptr[index * item_size], items, insert_count * item_size);
+    da->len = da->len - remove_count + insert_count;
+}
+
+void
+e_da__swap_remove (E_Da_Data *da, size_t index, size_t item_size)
+{
+    unsigned char *ptr;
+
+    ptr = da->ptr;
+    da->len -= 1;
+    if (index != da->len) {
+        memcpy (&ptr[index * item_size], &ptr[da->len * item_size], item_size);
+    }
+}
+
+# define E_DA32__INIT_CAP 4
+# define E_DA32__MAX_CAP  ((E_Da32__Size) -1)
+
+void
+e_da32__deinit (E_Da32_Data *da)
+{
+    free (da->ptr);
+}
+
+void
+e_da32__reserve (E_Da32_Data *da, size_t cap, size_t item_size)
+{
+    size_t new_cap, next;
+
+    if (cap <= da->cap) return;
+    if (cap > E_DA32__MAX_CAP) {
+        fprintf (stderr, "[e_da] E_Da32 capacity exceeded!\n");
+        abort ();
+    }
+    new_cap = da->cap == 0 ? E_DA32__INIT_CAP : da->cap;
+    while (new_cap < cap) {
+        if (new_cap > E_DA32__MAX_CAP - new_cap / 2) {
+            new_cap = E_DA32__MAX_CAP;
+            break;
+        }
+        next = new_cap + new_cap / 2;
+        new_cap = next > new_cap ? next : new_cap + 1;
+    }
+    da->ptr = e_da__mem_realloc (NULL, da->ptr, 0, new_cap * item_size);
+    da->cap = (E_Da32__Size) new_cap;
+}
+
+void
+e_da32__shrink_to_fit (E_Da32_Data *da, size_t item_size)
+{
+    if (da->len == da->cap) return;
+    if (da->len == 0) {
+        free (da->ptr);
+        da->ptr = NULL;
+    } else {
+        da->ptr = e_da__mem_realloc (NULL, da->ptr, 0, da->len * item_size);
+    }
+    da->cap = da->len;
+}
+
+void
+e_da32__extend (E_Da32_Data *da, void *data, size_t count, size_t item_size)
+{
+    unsigned char *ptr;
+    e_da32__reserve (da, (size_t) da->len + count, item_size);
+    ptr = da->ptr;
+    memcpy (&ptr[da->len * item_size], data, count * item_size);
+    da->len += (E_Da32__Size) count;
+}
+
+void *
+e_da32__extend_uninit (E_Da32_Data *da, size_t count, size_t item_size)
+{
+    unsigned char *ptr;
+    e_da32__reserve (da, (size_t) da->len + count, item_size);
+    ptr = da->ptr;
+    ptr = &ptr[item_size * da->len];
+    da->len += (E_Da32__Size) count;
+    return ptr;
+}
+
+void
+e_da32__pop (E_Da32_Data *da, size_t count)
+{
+    if (count > da->len) count = da->len;
+    da->len -= (E_Da32__Size) count;
+}
+
+# if defined(E_CONFIG_DA_MREMAP) && defined(__linux__)
+
+#  include <sys/mman.h>
+
+#  ifdef E_CONFIG_DA_MREMAP_THRESHOLD
+#   define E_DA__MREMAP_THRESHOLD E_CONFIG_DA_MREMAP_THRESHOLD
+#  else
+#   define E_DA__MREMAP_THRESHOLD ((size_t) 1 << 20)
+#  endif
+
+void *e_da__mremap_alloc (void *ctx, size_t size);
+void *e_da__mremap_realloc (void *ctx, void *ptr, size_t old_size, size_t new_size);
+void e_da__mremap_free (void *ctx, void *ptr, size_t size);
+
+const E_Allocator e_da_mremap_allocator = {
+    e_da__mremap_alloc,
+    e_da__mremap_realloc,
+    e_da__mremap_free,
+    NULL,
+};
+
+/* whether an allocation is backed by `mmap` is determined solely by its size */
+
+void *
+e_da__mremap_alloc (void *ctx, size_t size)
+{
+    void *ptr;
+
+    (void) ctx;
+    if (size < E_DA__MREMAP_THRESHOLD) return malloc (size);
+    ptr = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+void *
+e_da__mremap_realloc (void *ctx, void *ptr, size_t old_size, size_t new_size)
+{
+    void *new_ptr;
+
+    if (old_size < E_DA__MREMAP_THRESHOLD && new_size < E_DA__MREMAP_THRESHOLD) {
+        return realloc (ptr, new_size);
+    }
+    if (old_size >= E_DA__MREMAP_THRESHOLD && new_size >= E_DA__MREMAP_THRESHOLD) {
+        new_ptr = mremap (ptr, old_size, new_size, MREMAP_MAYMOVE);
+        return new_ptr == MAP_FAILED ? NULL : new_ptr;
+    }
+
+    /* crossing the threshold requires a copy */
+    new_ptr = e_da__mremap_alloc (ctx, new_size);
+    if (new_ptr == NULL) return NULL;
+    memcpy (new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    e_da__mremap_free (ctx, ptr, old_size);
+    return new_ptr;
+}
+
+void
+e_da__mremap_free (void *ctx, void *ptr, size_t size)
+{
+    (void) ctx;
+    if (size < E_DA__MREMAP_THRESHOLD) {
+        free (ptr);
+    } else {
+        munmap (ptr, size);
+    }
+}
+
+# endif /* defined(E_CONFIG_DA_MREMAP) && defined(__linux__) */
+
+# if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+
+uint64_t e_da__radix_load (const unsigned char *ptr, size_t key_size);
+void e_da__radix_store (unsigned char *ptr, uint64_t key, size_t key_size);
+
+uint64_t
+e_da__radix_load (const unsigned char *ptr, size_t key_size)
+{
+    uint32_t key32;
+    uint64_t key64;
+
+    if (key_size == sizeof (uint32_t)) {
+        memcpy (&key32, ptr, sizeof (key32));
+        return key32;
+    }
+    memcpy (&key64, ptr, sizeof (key64));
+    return key64;
+}
+
+void
+e_da__radix_store (unsigned char *ptr, uint64_t key, size_t key_size)
+{
+    uint32_t key32;
+
+    if (key_size == sizeof (uint32_t)) {
+        key32 = (uint32_t) key;
+        memcpy (ptr, &key32, sizeof (key32));
+    } else {
+        memcpy (ptr, &key, sizeof (key));
+    }
+}
+
+void
+e_da__radix_sort (E_Da_Data *da, size_t key_size, int kind)
+{
+    size_t counts[sizeof (uint64_t)][256];
+    size_t offset, count, i, d;
+    unsigned char *src, *dst, *tmp, *scratch;
+    uint64_t key, sign, mask;
+    unsigned shift;
+
+    if (da->len < 2) return;
+    sign = (uint64_t) 1 << (key_size * 8 - 1);
+    mask = sign | (sign - 1);
+
+    /* map keys to unsigned integers with the same ordering and build the histograms */
+    memset (counts, 0, sizeof (counts));
+    src = da->ptr;
+    for (i = 0; i < da->len; i++) {
+        key = e_da__radix_load (&src[i * key_size], key_size);
+        if (kind == E_DA__RADIX_SIGNED) {
+            key ^= sign;
+        } else if (kind == E_DA__RADIX_FLOAT) {
+            key = (key & sign) ? (~key & mask) : (key | sign);
+        }
+        e_da__radix_store (&src[i * key_size], key, key_size);
+        for (d = 0; d < key_size; d++) {
+            counts[d][(key >> (d * 8)) & 0xff] += 1;
+        }
+    }
+
+    /* one stable counting sort pass per byte, skipping bytes that are equal for all keys */
+    scratch = e_da__mem_realloc (da->allocator, NULL, 0, da->len * key_size);
+    dst = scratch;
+    for (d = 0; d < key_size; d++) {
+        shift = (unsigned) (d * 8);
+        key = e_da__radix_load (src, key_size);
+        if (counts[d][(key >> shift) & 0xff] == da->len) continue;
+        offset = 0;
+        for (i = 0; i < 256; i++) {
+            count = counts[d][i];
+            counts[d][i] = offset;
+            offset += count;
+        }
+        for (i = 0; i < da->len; i++) {
+            key = e_da__radix_load (&src[i * key_size], key_size);
+            offset = counts[d][(key >> shift) & 0xff]++;
+            memcpy (&dst[offset * key_size], &src[i * key_size], key_size);
+        }
+        tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    if (src != da->ptr) {
+        memcpy (da->ptr, src, da->len * key_size);
+    }
+    e_da__mem_free (da->allocator, scratch, da->len * key_size);
+
+    /* map keys back to their original representation */
+    src = da->ptr;
+    if (kind == E_DA__RADIX_UNSIGNED) return;
+    for (i = 0; i < da->len; i++) {
+        key = e_da__radix_load (&src[i * key_size], key_size);
+        if (kind == E_DA__RADIX_SIGNED) {
+            key ^= sign;
+        } else {
+            key = (key & sign) ? (key ^ sign) : (~key & mask);
+        }
+        e_da__radix_store (&src[i * key_size], key, key_size);
+    }
+}
+
+# endif /* defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L */
+
 #endif /* E_DA_IMPL */
 
 #endif /* E_DA_H_ */
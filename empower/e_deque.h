@@ -0,0 +1,493 @@
+#ifndef E_DEQUE_H_
+#define E_DEQUE_H_
+
+/**************************************************************************************************
+ *
+ * Empower / e_deque.h - Public Domain - https://git.tjdev.de/thetek/empower
+ *
+ * This module implements block-based double-ended queues for generic types.
+ *
+ * Unlike `E_Queue`, which stores its items in a single ringbuffer that has to be reallocated (and
+ * partially rearranged) when it grows, a block-based deque stores its items in fixed-size blocks.
+ * The blocks are referenced by a block map, which is a small ringbuffer of block pointers. Pushing
+ * at either end only ever allocates a single block, and items are never moved, so pointers to them
+ * stay valid until they are popped or the deque is deinitialised.
+ *
+ * When the block map is full, a map of twice the size is allocated, but the block pointers are not
+ * copied all at once: the old map is kept around, and every push that adds a block copies two more
+ * pointers to the new map. Thus, pushing at either end takes constant time even in the worst case.
+ *
+ * It can be used as follows:
+ *
+ * ```
+ * E_Deque (int) int_deque = e_deque_init ();
+ * e_deque_push_back (&int_deque, 1);
+ * e_deque_push_front (&int_deque, 0);
+ * int *first = e_deque_first (&int_deque); // 0
+ * int popped;
+ * bool x = e_deque_pop_back (&int_deque, &popped); // true, 1
+ * bool y = e_deque_pop_front (&int_deque, &popped); // true, 0
+ * bool z = e_deque_pop_front (&int_deque, &popped); // false (no items left)
+ * e_deque_deinit (&int_deque);
+ * ```
+ *
+ * When a block becomes empty, it is kept in a small cache instead of being freed, so that a deque
+ * whose length oscillates around a block boundary does not allocate and free a block on every push
+ * and pop.
+ *
+ * By default, memory is allocated using `malloc` and `free`. A custom allocator (see `E_Allocator`
+ * in e_alloc.h) can be used by initialising the deque with `e_deque_init_with_allocator`.
+ *
+ * On allocation failure, an error message is printed and the programme is aborted.
+ *
+ * Configuration options:
+ *  - `E_CONFIG_DEQUE_BLOCK_SIZE`: Size of a block in bytes. Blocks hold at least 16 items, so they
+ *    may be larger for large item types (default: 512).
+ *  - `E_CONFIG_DEQUE_BLOCK_CACHE`: Number of empty blocks that are kept for reuse (default: 2).
+ *
+ **************************************************************************************************/
+
+#include <stddef.h>
+
+/* compatibility annoyances: */
+#ifndef E_TYPEOF
+# if __STDC_VERSION__ >= 202311L
+#  define E_TYPEOF(x) typeof (x)
+# else
+#  define E_TYPEOF(x) __typeof__ (x)
+# endif
+#endif /* E_TYPEOF */
+
+/* allocator interface (see e_alloc.h): */
+#ifndef E_ALLOCATOR_DEFINED
+# define E_ALLOCATOR_DEFINED
+typedef struct {
+    void *(*alloc_fn) (void *ctx, size_t size);
+    void *(*realloc_fn) (void *ctx, void *ptr, size_t old_size, size_t new_size);
+    void (*free_fn) (void *ctx, void *ptr, size_t size);
+    void *ctx;
+} E_Allocator;
+#endif /* E_ALLOCATOR_DEFINED */
+
+#ifdef E_CONFIG_DEQUE_BLOCK_CACHE
+# define E_DEQUE__BLOCK_CACHE E_CONFIG_DEQUE_BLOCK_CACHE
+#else
+# define E_DEQUE__BLOCK_CACHE 2
+#endif
+
+/**
+ * Generic block-based double-ended queue
+ */
+#define E_Deque(T)                                                                                 \
+    union {                                                                                        \
+        E_Deque_Data data;                                                                         \
+        T *type; /* NOLINT */                                                                      \
+    }
+
+/**
+ * Initialise a new deque.
+ *
+ * No memory is allocated yet.
+ */
+#define e_deque_init() {0}
+
+/**
+ * Initialise a new deque that obtains its memory from `allocator` (of type `const E_Allocator *`).
+ * Passing `NULL` is equivalent to `e_deque_init()`.
+ *
+ * In C89, initialisers must be constant, so you may have to set `data.allocator` manually instead.
+ */
+#define e_deque_init_with_allocator(allocator)                                                     \
+    {{NULL, 0, 0, 0, NULL, 0, 0, 0, 0, 0, {0}, 0, (allocator)}}
+
+/**
+ * Free the memory occupied by the deque.
+ */
+#define e_deque_deinit(deque) e_deque__deinit (&(deque)->data, sizeof (*(deque)->type))
+
+/**
+ * Obtain the length (i.e. the number of contained items) of the deque.
+ */
+#define e_deque_len(deque) (deque)->data.len
+
+/**
+ * Obtain a pointer to the nth item of the deque, counting from the front.
+ *
+ * This does not perform any bounds checks.
+ */
+#define e_deque_nth(deque, n)                                                                      \
+    ((E_TYPEOF ((deque)->type)) e_deque__nth (&(deque)->data, (n), sizeof (*(deque)->type)))
+
+/**
+ * Obtain a pointer to the first item of the deque.
+ *
+ * This does not perform any bounds checks.
+ */
+#define e_deque_first(deque) e_deque_nth ((deque), 0)
+
+/**
+ * Obtain a pointer to the last item of the deque.
+ *
+ * This does not perform any bounds checks.
+ */
+#define e_deque_last(deque) e_deque_nth ((deque), (deque)->data.len - 1)
+
+/**
+ * Add an item to the back of the deque.
+ */
+#define e_deque_push_back(deque, item)                                                             \
+    do {                                                                                           \
+        E_TYPEOF (*(deque)->type) e_deque__item = (item);                                          \
+        e_deque_push_back_ref ((deque), &e_deque__item);                                           \
+    } while (0)
+
+/**
+ * Add an item to the back of the deque (but the item is a pointer).
+ */
+#define e_deque_push_back_ref(deque, item_ref)                                                     \
+    e_deque__push_back (&(deque)->data, (1 ? (item_ref) : (deque)->type), sizeof (*(deque)->type))
+
+/**
+ * Add an item to the front of the deque.
+ */
+#define e_deque_push_front(deque, item)                                                            \
+    do {                                                                                           \
+        E_TYPEOF (*(deque)->type) e_deque__item = (item);                                          \
+        e_deque_push_front_ref ((deque), &e_deque__item);                                          \
+    } while (0)
+
+/**
+ * Add an item to the front of the deque (but the item is a pointer).
+ */
+#define e_deque_push_front_ref(deque, item_ref)                                                    \
+    e_deque__push_front (&(deque)->data, (1 ? (item_ref) : (deque)->type), sizeof (*(deque)->type))
+
+/**
+ * Pop an item from the back of the deque.
+ *
+ * If the deque is not empty, the item will be removed and written to `out`, and a non-zero (true)
+ * value will be returned. If the deque is empty, no action will be performed, and zero (false) will
+ * be returned.
+ *
+ * If the `out` parameter is `NULL`, nothing will be written to it, but the item will still be
+ * popped and `true` or `false` will be returned.
+ */
+#define e_deque_pop_back(deque, out)                                                               \
+    e_deque__pop_back (&(deque)->data, (1 ? (out) : (deque)->type), sizeof (*(deque)->type))
+
+/**
+ * Pop an item from the front of the deque. The return value and `out` behave like in
+ * `e_deque_pop_back`.
+ */
+#define e_deque_pop_front(deque, out)                                                              \
+    e_deque__pop_front (&(deque)->data, (1 ? (out) : (deque)->type), sizeof (*(deque)->type))
+
+typedef struct {
+    void **map;      /* ringbuffer of block pointers */
+    size_t map_cap;  /* capacity of `map` (0 or a power of two) */
+    size_t map_head; /* index of the first used block in `map` */
+    size_t block_count;
+    void **old_map; /* previous map, while its pointers are being moved to `map` */
+    size_t old_map_cap;
+    size_t migrate_head; /* index in `map` of the first block that is still in `old_map` */
+    size_t migrate_len;  /* number of blocks that are still in `old_map` */
+    size_t head;         /* index of the first item in the first block */
+    size_t len;
+    void *cache[E_DEQUE__BLOCK_CACHE];
+    size_t cache_len;
+    const E_Allocator *allocator;
+} E_Deque_Data;
+
+void e_deque__deinit (E_Deque_Data *deque, size_t item_size);
+void *e_deque__nth (const E_Deque_Data *deque, size_t n, size_t item_size);
+void e_deque__push_back (E_Deque_Data *deque, const void *item, size_t item_size);
+void e_deque__push_front (E_Deque_Data *deque, const void *item, size_t item_size);
+int e_deque__pop_back (E_Deque_Data *deque, void *out, size_t item_size);
+int e_deque__pop_front (E_Deque_Data *deque, void *out, size_t item_size);
+
+/**************************************************************************************************/
+
+#ifdef E_DEQUE_IMPL
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+
+/* gcc's analyzer cannot tell that a new block is stored into a map slot that is not in use, and
+ * reports the block that it assumes to be overwritten as leaked */
+# if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 10
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wanalyzer-malloc-leak"
+# endif
+
+# ifdef E_CONFIG_DEQUE_BLOCK_SIZE
+#  define E_DEQUE__BLOCK_SIZE E_CONFIG_DEQUE_BLOCK_SIZE
+# else
+#  define E_DEQUE__BLOCK_SIZE 512
+# endif
+# define E_DEQUE__MIN_BLOCK_ITEMS 16
+# define E_DEQUE__MIN_MAP_CAP     8
+# define E_DEQUE__MIGRATE_STEP    2
+
+size_t e_deque__block_items (size_t item_size);
+void *e_deque__alloc_block (E_Deque_Data *deque, size_t item_size);
+void e_deque__release_block (E_Deque_Data *deque, void *block, size_t item_size);
+void e_deque__grow_map (E_Deque_Data *deque);
+void e_deque__migrate (E_Deque_Data *deque, size_t steps);
+void *e_deque__block (const E_Deque_Data *deque, size_t i);
+void e_deque__add_block (E_Deque_Data *deque, int front, size_t item_size);
+void *e_deque__mem_alloc (const E_Allocator *allocator, size_t size);
+void e_deque__mem_free (const E_Allocator *allocator, void *ptr, size_t size);
+
+/**
+ * Number of items in a block.
+ */
+size_t
+e_deque__block_items (size_t item_size)
+{
+    size_t items;
+
+    items = E_DEQUE__BLOCK_SIZE / item_size;
+    return items < E_DEQUE__MIN_BLOCK_ITEMS ? E_DEQUE__MIN_BLOCK_ITEMS : items;
+}
+
+void *
+e_deque__mem_alloc (const E_Allocator *allocator, size_t size)
+{
+    void *new_ptr;
+
+    if (allocator == NULL) {
+        new_ptr = malloc (size);
+    } else {
+        new_ptr = allocator->alloc_fn (allocator->ctx, size);
+    }
+    if (new_ptr == NULL) {
+        fprintf (stderr, "[e_deque] allocation failed!\n");
+        abort ();
+    }
+    return new_ptr;
+}
+
+void
+e_deque__mem_free (const E_Allocator *allocator, void *ptr, size_t size)
+{
+    if (allocator == NULL) {
+        free (ptr);
+    } else if (ptr != NULL) {
+        allocator->free_fn (allocator->ctx, ptr, size);
+    }
+}
+
+/**
+ * Obtain an empty block, either from the cache or by allocating a new one.
+ */
+void *
+e_deque__alloc_block (E_Deque_Data *deque, size_t item_size)
+{
+    if (deque->cache_len > 0) {
+        deque->cache_len -= 1;
+        return deque->cache[deque->cache_len];
+    }
+    return e_deque__mem_alloc (deque->allocator, e_deque__block_items (item_size) * item_size);
+}
+
+/**
+ * Put a block that is no longer used into the cache, or free it if the cache is full.
+ */
+void
+e_deque__release_block (E_Deque_Data *deque, void *block, size_t item_size)
+{
+    if (deque->cache_len < E_DEQUE__BLOCK_CACHE) {
+        deque->cache[deque->cache_len] = block;
+        deque->cache_len += 1;
+        return;
+    }
+    e_deque__mem_free (deque->allocator, block, e_deque__block_items (item_size) * item_size);
+}
+
+/**
+ * Move up to `steps` block pointers from the old map to the current one, and free the old map once
+ * it is no longer needed.
+ */
+void
+e_deque__migrate (E_Deque_Data *deque, size_t steps)
+{
+    size_t index;
+
+    for (; steps > 0 && deque->migrate_len > 0; steps--) {
+        index = deque->migrate_head;
+        deque->map[index] = deque->old_map[index & (deque->old_map_cap - 1)];
+        deque->migrate_head = (index + 1) & (deque->map_cap - 1);
+        deque->migrate_len -= 1;
+    }
+    if (deque->old_map != NULL && deque->migrate_len == 0) {
+        e_deque__mem_free (deque->allocator, deque->old_map, deque->old_map_cap * sizeof (void *));
+        deque->old_map = NULL;
+        deque->old_map_cap = 0;
+    }
+}
+
+/**
+ * Double the capacity of the block map. The block pointers stay in the old map until they are
+ * moved by `e_deque__migrate`. Since the old capacity divides the new one, the index of a block in
+ * the old map is its index in the new map modulo the old capacity.
+ */
+void
+e_deque__grow_map (E_Deque_Data *deque)
+{
+    /* only happens if blocks were popped and pushed again during the previous migration */
+    e_deque__migrate (deque, (size_t) -1);
+
+    deque->old_map = deque->map;
+    deque->old_map_cap = deque->map_cap;
+    deque->migrate_head = deque->map_head;
+    deque->migrate_len = deque->block_count;
+    deque->map_cap = deque->map_cap > 0 ? deque->map_cap * 2 : E_DEQUE__MIN_MAP_CAP;
+    deque->map = e_deque__mem_alloc (deque->allocator, deque->map_cap * sizeof (void *));
+}
+
+/**
+ * Obtain the pointer to the `i`th block, counting from the front.
+ */
+void *
+e_deque__block (const E_Deque_Data *deque, size_t i)
+{
+    size_t index;
+
+    index = (deque->map_head + i) & (deque->map_cap - 1);
+    if (((index - deque->migrate_head) & (deque->map_cap - 1)) < deque->migrate_len) {
+        return deque->old_map[index & (deque->old_map_cap - 1)];
+    }
+    return deque->map[index];
+}
+
+/**
+ * Add an empty block before the first block (if `front` is non-zero) or after the last block.
+ */
+void
+e_deque__add_block (E_Deque_Data *deque, int front, size_t item_size)
+{
+    void *block;
+    size_t index;
+
+    if (deque->block_count == deque->map_cap) e_deque__grow_map (deque);
+    e_deque__migrate (deque, E_DEQUE__MIGRATE_STEP);
+    block = e_deque__alloc_block (deque, item_size);
+    if (front) {
+        deque->map_head = (deque->map_head - 1) & (deque->map_cap - 1);
+        index = deque->map_head;
+    } else {
+        index = (deque->map_head + deque->block_count) & (deque->map_cap - 1);
+    }
+    deque->map[index] = block;
+    deque->block_count += 1;
+}
+
+void
+e_deque__deinit (E_Deque_Data *deque, size_t item_size)
+{
+    void *block;
+    size_t block_bytes, i;
+
+    block_bytes = e_deque__block_items (item_size) * item_size;
+    for (i = 0; i < deque->block_count; i++) {
+        block = e_deque__block (deque, i);
+        e_deque__mem_free (deque->allocator, block, block_bytes);
+    }
+    for (i = 0; i < deque->cache_len; i++) {
+        e_deque__mem_free (deque->allocator, deque->cache[i], block_bytes);
+    }
+    e_deque__mem_free (deque->allocator, deque->old_map, deque->old_map_cap * sizeof (void *));
+    e_deque__mem_free (deque->allocator, deque->map, deque->map_cap * sizeof (void *));
+}
+
+void *
+e_deque__nth (const E_Deque_Data *deque, size_t n, size_t item_size)
+{
+    unsigned char *block;
+    size_t block_items;
+
+    block_items = e_deque__block_items (item_size);
+    n += deque->head;
+    block = e_deque__block (deque, n / block_items);
+    return &block[(n % block_items) * item_size];
+}
+
+void
+e_deque__push_back (E_Deque_Data *deque, const void *item, size_t item_size)
+{
+    if (deque->head + deque->len == deque->block_count * e_deque__block_items (item_size)) {
+        e_deque__add_block (deque, 0, item_size);
+    }
+    deque->len += 1;
+    memcpy (e_deque__nth (deque, deque->len - 1, item_size), item, item_size);
+}
+
+void
+e_deque__push_front (E_Deque_Data *deque, const void *item, size_t item_size)
+{
+    if (deque->head == 0) {
+        e_deque__add_block (deque, 1, item_size);
+        deque->head = e_deque__block_items (item_size);
+    }
+    deque->head -= 1;
+    deque->len += 1;
+    memcpy (e_deque__nth (deque, 0, item_size), item, item_size);
+}
+
+int
+e_deque__pop_back (E_Deque_Data *deque, void *out, size_t item_size)
+{
+    size_t block_items;
+
+    if (deque->len == 0) return 0;
+
+    if (out != NULL) memcpy (out, e_deque__nth (deque, deque->len - 1, item_size), item_size);
+    deque->len -= 1;
+
+    /* release the last block once it is empty */
+    block_items = e_deque__block_items (item_size);
+    if (deque->len == 0 || (deque->head + deque->len) % block_items == 0) {
+        e_deque__release_block (deque, e_deque__block (deque, deque->block_count - 1), item_size);
+        deque->block_count -= 1;
+        /* the blocks that are still in the old map are a subrange of the used blocks */
+        if (deque->migrate_len > 0 &&
+            ((deque->migrate_head - deque->map_head) & (deque->map_cap - 1)) + deque->migrate_len >
+                deque->block_count) {
+            deque->migrate_len -= 1;
+        }
+        if (deque->len == 0) deque->head = 0;
+    }
+    return 1;
+}
+
+int
+e_deque__pop_front (E_Deque_Data *deque, void *out, size_t item_size)
+{
+    if (deque->len == 0) return 0;
+
+    if (out != NULL) memcpy (out, e_deque__nth (deque, 0, item_size), item_size);
+    deque->head += 1;
+    deque->len -= 1;
+
+    /* release the first block once it is empty */
+    if (deque->len == 0 || deque->head == e_deque__block_items (item_size)) {
+        e_deque__release_block (deque, e_deque__block (deque, 0), item_size);
+        if (deque->migrate_len > 0 && deque->migrate_head == deque->map_head) {
+            deque->migrate_head = (deque->migrate_head + 1) & (deque->map_cap - 1);
+            deque->migrate_len -= 1;
+        }
+        deque->map_head = (deque->map_head + 1) & (deque->map_cap - 1);
+        deque->block_count -= 1;
+        deque->head = 0;
+    }
+    return 1;
+}
+
+# if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 10
+#  pragma GCC diagnostic pop
+# endif
+
+#endif /* E_DEQUE_IMPL */
+
+#endif /* E_DEQUE_H_ */
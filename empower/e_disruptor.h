@@ -0,0 +1,444 @@
+#ifndef E_DISRUPTOR_H_
+#define E_DISRUPTOR_H_
+
+/**************************************************************************************************
+ *
+ * Empower / e_disruptor.h - Public Domain - https://git.tjdev.de/thetek/empower
+ *
+ * This module implements lock-free ringbuffers for generic types where every item is seen by
+ * several consumers, in the style of the LMAX Disruptor.
+ *
+ * A single producer publishes items, and every consumer reads all of them in order. Instead of
+ * copying the items for every consumer, each item is written once, and every consumer keeps its own
+ * cursor (the sequence number of the next item that it reads). The producer may only overwrite a
+ * slot once the slowest consumer has moved past it, so a slow consumer applies backpressure to the
+ * producer. Consumers never wait for each other unless they are told to: a consumer can depend on
+ * another one, so that it only reads items that the other one has already consumed (e.g. to only
+ * acknowledge items after they have been persisted).
+ *
+ * It can be used as follows:
+ *
+ * ```
+ * enum { LOGGER, METRICS, PERSISTENCE, ACK, CONSUMER_COUNT };
+ * E_Disruptor (Event) events;
+ * e_disruptor_init (&events, 1024, CONSUMER_COUNT);
+ * e_disruptor_depend (&events, ACK, PERSISTENCE);
+ * // in the producer thread:
+ * Event *event = e_disruptor_claim_wait (&events);
+ * event->value = 42;
+ * e_disruptor_publish (&events);
+ * // in the thread of consumer `METRICS`:
+ * size_t i, n = e_disruptor_available (&events, METRICS);
+ * for (i = 0; i < n; i++) {
+ *     record_metrics (e_disruptor_at (&events, METRICS, i));
+ * }
+ * e_disruptor_consume (&events, METRICS, n);
+ * // after all threads are done:
+ * e_disruptor_deinit (&events);
+ * ```
+ *
+ * Consumers can process all available items in a batch as shown above, or pop them one by one with
+ * `e_disruptor_pop` and `e_disruptor_pop_wait`. The producer can also copy items into the
+ * ringbuffer with `e_disruptor_push` and `e_disruptor_push_wait`. The `_wait` variants spin for a
+ * while when the ringbuffer is full or empty and then give the processor to other threads between
+ * attempts, until they succeed.
+ *
+ * The capacity is fixed and must be a power of two of at least 2. The memory for the items and
+ * cursors is allocated on initialisation.
+ *
+ * This module requires C11 atomics.
+ *
+ * On allocation failure, an error message is printed and the programme is aborted.
+ *
+ **************************************************************************************************/
+
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 201112L || defined(__STDC_NO_ATOMICS__)
+# error e_disruptor requires C11 or newer with atomics
+#endif
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/* compatibility annoyances: */
+#ifndef E_TYPEOF
+# if __STDC_VERSION__ >= 202311L
+#  define E_TYPEOF(x) typeof (x)
+# else
+#  define E_TYPEOF(x) __typeof__ (x)
+# endif
+#endif /* E_TYPEOF */
+
+#define E_DISRUPTOR__CACHE_LINE 64
+#define E_DISRUPTOR__NO_DEPENDENCY ((size_t) -1)
+
+/**
+ * Generic single-producer/multi-consumer ringbuffer
+ */
+#define E_Disruptor(T)                                                                             \
+    union {                                                                                        \
+        E_Disruptor_Data data;                                                                     \
+        T *type; /* NOLINT */                                                                      \
+    }
+
+/**
+ * Initialise a ringbuffer with space for `cap` items that are read by `consumer_count` consumers.
+ * The consumers are identified by their index from 0 to `consumer_count - 1`. `cap` must be a
+ * power of two of at least 2, and there must be at least one consumer; otherwise, the ringbuffer is
+ * not initialised and zero (false) is returned. On success, a non-zero (true) value is returned.
+ *
+ * The ringbuffer must be initialised before it is shared with other threads.
+ */
+#define e_disruptor_init(disruptor, cap, consumer_count)                                           \
+    e_disruptor__init (&(disruptor)->data, (cap), (consumer_count), sizeof (*(disruptor)->type))
+
+/**
+ * Free the memory occupied by the ringbuffer. Must only be called once no other thread uses it
+ * anymore.
+ */
+#define e_disruptor_deinit(disruptor) e_disruptor__deinit (&(disruptor)->data)
+
+/**
+ * Obtain the capacity (i.e. the maximum number of items that can be published before the slowest
+ * consumer has read them) of the ringbuffer.
+ */
+#define e_disruptor_cap(disruptor) ((disruptor)->data.mask + 1)
+
+/**
+ * Let `consumer` only read items that `dependency` has already consumed, instead of all items that
+ * have been published. The dependencies must not form a cycle. Must be called before the
+ * ringbuffer is shared with other threads.
+ */
+#define e_disruptor_depend(disruptor, consumer, dependency)                                        \
+    e_disruptor__depend (&(disruptor)->data, (consumer), (dependency))
+
+/**
+ * Obtain a pointer to the slot that the next item is written to, so that it can be written in
+ * place and then published with `e_disruptor_publish`. Must only be called by the producer.
+ *
+ * If the slowest consumer has not read the item that was previously stored in the slot yet, `NULL`
+ * is returned.
+ */
+#define e_disruptor_claim(disruptor)                                                               \
+    ((E_TYPEOF ((disruptor)->type)) e_disruptor__claim (&(disruptor)->data,                        \
+                                                        sizeof (*(disruptor)->type)))
+
+/**
+ * Obtain a pointer to the slot that the next item is written to, waiting for the slowest consumer
+ * to read the item that was previously stored in it. Must only be called by the producer.
+ */
+#define e_disruptor_claim_wait(disruptor)                                                          \
+    ((E_TYPEOF ((disruptor)->type)) e_disruptor__claim_wait (&(disruptor)->data,                   \
+                                                             sizeof (*(disruptor)->type)))
+
+/**
+ * Make the item that was written to the slot returned by `e_disruptor_claim` or
+ * `e_disruptor_claim_wait` visible to the consumers. Must only be called by the producer.
+ */
+#define e_disruptor_publish(disruptor) e_disruptor__publish (&(disruptor)->data)
+
+/**
+ * Try to publish an item. Must only be called by the producer.
+ *
+ * If the ringbuffer is full, nothing is published and zero (false) is returned. Otherwise, a
+ * non-zero (true) value is returned.
+ */
+#define e_disruptor_push(disruptor, item)                                                          \
+    e_disruptor__push (&(disruptor)->data, (E_TYPEOF (*(disruptor)->type)[1]) {(item)},            \
+                       sizeof (*(disruptor)->type))
+
+/**
+ * Publish an item, waiting for the slowest consumer if the ringbuffer is full. Must only be called
+ * by the producer.
+ */
+#define e_disruptor_push_wait(disruptor, item)                                                     \
+    e_disruptor__push_wait (&(disruptor)->data, (E_TYPEOF (*(disruptor)->type)[1]) {(item)},       \
+                            sizeof (*(disruptor)->type))
+
+/**
+ * Obtain the number of items that `consumer` can read. Must only be called by that consumer.
+ */
+#define e_disruptor_available(disruptor, consumer)                                                 \
+    e_disruptor__available (&(disruptor)->data, (consumer))
+
+/**
+ * Obtain a pointer to the `index`th item that `consumer` can read, where `index` must be smaller
+ * than the value returned by `e_disruptor_available`. Must only be called by that consumer.
+ */
+#define e_disruptor_at(disruptor, consumer, index)                                                 \
+    ((const E_TYPEOF (*(disruptor)->type) *) e_disruptor__at (&(disruptor)->data, (consumer),      \
+                                                              (index),                             \
+                                                              sizeof (*(disruptor)->type)))
+
+/**
+ * Move the cursor of `consumer` past `count` items after it has read them (see
+ * `e_disruptor_available`). `count` is limited to the number of available items. Must only be
+ * called by that consumer.
+ */
+#define e_disruptor_consume(disruptor, consumer, count)                                            \
+    e_disruptor__consume (&(disruptor)->data, (consumer), (count))
+
+/**
+ * Try to read the next item for `consumer`. Must only be called by that consumer.
+ *
+ * If an item is available, it will be written to `out`, the cursor of the consumer will be moved
+ * past it, and a non-zero (true) value will be returned. Otherwise, no action will be performed,
+ * and zero (false) will be returned.
+ *
+ * If the `out` parameter is `NULL`, nothing will be written to it, but the item will still be
+ * consumed and `true` or `false` will be returned.
+ */
+#define e_disruptor_pop(disruptor, consumer, out)                                                  \
+    e_disruptor__pop (&(disruptor)->data, (consumer), (1 ? (out) : (disruptor)->type),             \
+                      sizeof (*(disruptor)->type))
+
+/**
+ * Read the next item for `consumer` and write it to `out`, waiting for an item to become available
+ * if there is none. If the `out` parameter is `NULL`, nothing will be written to it. Must only be
+ * called by that consumer.
+ */
+#define e_disruptor_pop_wait(disruptor, consumer, out)                                             \
+    e_disruptor__pop_wait (&(disruptor)->data, (consumer), (1 ? (out) : (disruptor)->type),        \
+                           sizeof (*(disruptor)->type))
+
+typedef struct {
+    /* sequence number of the next item that the consumer reads */
+    _Atomic (size_t) seq;
+    /* index of the consumer whose cursor limits this one, or `E_DISRUPTOR__NO_DEPENDENCY` */
+    size_t dependency;
+    unsigned char pad_[E_DISRUPTOR__CACHE_LINE - sizeof (_Atomic (size_t)) - sizeof (size_t)];
+} E_Disruptor__Cursor;
+
+typedef struct {
+    /* read-only after initialisation */
+    E_Disruptor__Cursor *cursors;
+    size_t consumer_count;
+    void *ptr;
+    size_t mask;
+    unsigned char pad0_[E_DISRUPTOR__CACHE_LINE];
+    /* sequence number of the next item that is published */
+    _Atomic (size_t) published;
+    /* owned by the producer: cached cursor of the slowest consumer */
+    size_t gate;
+    unsigned char pad1_[E_DISRUPTOR__CACHE_LINE];
+} E_Disruptor_Data;
+
+int e_disruptor__init (E_Disruptor_Data *disruptor, size_t cap, size_t consumer_count,
+                       size_t item_size);
+void e_disruptor__deinit (E_Disruptor_Data *disruptor);
+void e_disruptor__depend (E_Disruptor_Data *disruptor, size_t consumer, size_t dependency);
+void *e_disruptor__claim (E_Disruptor_Data *disruptor, size_t item_size);
+void *e_disruptor__claim_wait (E_Disruptor_Data *disruptor, size_t item_size);
+void e_disruptor__publish (E_Disruptor_Data *disruptor);
+int e_disruptor__push (E_Disruptor_Data *disruptor, const void *item, size_t item_size);
+void e_disruptor__push_wait (E_Disruptor_Data *disruptor, const void *item, size_t item_size);
+size_t e_disruptor__available (E_Disruptor_Data *disruptor, size_t consumer);
+void *e_disruptor__at (E_Disruptor_Data *disruptor, size_t consumer, size_t index,
+                       size_t item_size);
+void e_disruptor__consume (E_Disruptor_Data *disruptor, size_t consumer, size_t count);
+int e_disruptor__pop (E_Disruptor_Data *disruptor, size_t consumer, void *out, size_t item_size);
+void e_disruptor__pop_wait (E_Disruptor_Data *disruptor, size_t consumer, void *out,
+                            size_t item_size);
+
+/**************************************************************************************************/
+
+#ifdef E_DISRUPTOR_IMPL
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# if defined(_WIN32)
+#  include <windows.h>
+# elif defined(__unix__) || defined(__APPLE__)
+#  include <sched.h>
+# endif
+
+# define E_DISRUPTOR__SPIN_LIMIT 64
+
+void e_disruptor__backoff (unsigned int *spins);
+
+/**
+ * Wait a little while spinning. After `E_DISRUPTOR__SPIN_LIMIT` spins, the processor is given to
+ * other threads, since the threads that are being waited for may not be running.
+ */
+void
+e_disruptor__backoff (unsigned int *spins)
+{
+    if (*spins < E_DISRUPTOR__SPIN_LIMIT) {
+        *spins += 1;
+# if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_ia32_pause ();
+# elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+        __asm__ volatile ("yield");
+# endif
+        return;
+    }
+# if defined(_WIN32)
+    SwitchToThread ();
+# elif defined(__unix__) || defined(__APPLE__)
+    sched_yield ();
+# endif
+}
+
+int
+e_disruptor__init (E_Disruptor_Data *disruptor, size_t cap, size_t consumer_count,
+                   size_t item_size)
+{
+    size_t i;
+
+    if (cap < 2 || (cap & (cap - 1)) != 0 || consumer_count == 0) return 0;
+    disruptor->cursors = malloc (consumer_count * sizeof (*disruptor->cursors));
+    disruptor->ptr = malloc (cap * item_size);
+    if (disruptor->cursors == NULL || disruptor->ptr == NULL) {
+        fprintf (stderr, "[e_disruptor] allocation failed!\n");
+        abort ();
+    }
+    for (i = 0; i < consumer_count; i++) {
+        atomic_init (&disruptor->cursors[i].seq, 0);
+        disruptor->cursors[i].dependency = E_DISRUPTOR__NO_DEPENDENCY;
+    }
+    disruptor->consumer_count = consumer_count;
+    disruptor->mask = cap - 1;
+    atomic_init (&disruptor->published, 0);
+    disruptor->gate = 0;
+    return 1;
+}
+
+void
+e_disruptor__deinit (E_Disruptor_Data *disruptor)
+{
+    free (disruptor->cursors);
+    free (disruptor->ptr);
+}
+
+void
+e_disruptor__depend (E_Disruptor_Data *disruptor, size_t consumer, size_t dependency)
+{
+    disruptor->cursors[consumer].dependency = dependency;
+}
+
+void *
+e_disruptor__claim (E_Disruptor_Data *disruptor, size_t item_size)
+{
+    unsigned char *ptr = disruptor->ptr;
+    size_t seq, cursor, i;
+
+    seq = atomic_load_explicit (&disruptor->published, memory_order_relaxed);
+    if (seq - disruptor->gate > disruptor->mask) {
+        /* the cached cursor is a full round behind, so look for the current slowest consumer */
+        disruptor->gate = seq;
+        for (i = 0; i < disruptor->consumer_count; i++) {
+            cursor = atomic_load_explicit (&disruptor->cursors[i].seq, memory_order_acquire);
+            if (seq - cursor > seq - disruptor->gate) disruptor->gate = cursor;
+        }
+        if (seq - disruptor->gate > disruptor->mask) return NULL;
+    }
+    return &ptr[(seq & disruptor->mask) * item_size];
+}
+
+void *
+e_disruptor__claim_wait (E_Disruptor_Data *disruptor, size_t item_size)
+{
+    unsigned int spins = 0;
+    void *slot;
+
+    while ((slot = e_disruptor__claim (disruptor, item_size)) == NULL) {
+        e_disruptor__backoff (&spins);
+    }
+    return slot;
+}
+
+void
+e_disruptor__publish (E_Disruptor_Data *disruptor)
+{
+    size_t seq;
+
+    seq = atomic_load_explicit (&disruptor->published, memory_order_relaxed);
+    atomic_store_explicit (&disruptor->published, seq + 1, memory_order_release);
+}
+
+int
+e_disruptor__push (E_Disruptor_Data *disruptor, const void *item, size_t item_size)
+{
+    void *slot;
+
+    slot = e_disruptor__claim (disruptor, item_size);
+    if (slot == NULL) return 0;
+    memcpy (slot, item, item_size);
+    e_disruptor__publish (disruptor);
+    return 1;
+}
+
+void
+e_disruptor__push_wait (E_Disruptor_Data *disruptor, const void *item, size_t item_size)
+{
+    memcpy (e_disruptor__claim_wait (disruptor, item_size), item, item_size);
+    e_disruptor__publish (disruptor);
+}
+
+size_t
+e_disruptor__available (E_Disruptor_Data *disruptor, size_t consumer)
+{
+    E_Disruptor__Cursor *cursor = &disruptor->cursors[consumer];
+    size_t seq, limit;
+
+    /* the cursor is only written by its own consumer */
+    seq = atomic_load_explicit (&cursor->seq, memory_order_relaxed);
+    if (cursor->dependency == E_DISRUPTOR__NO_DEPENDENCY) {
+        limit = atomic_load_explicit (&disruptor->published, memory_order_acquire);
+    } else {
+        limit = atomic_load_explicit (&disruptor->cursors[cursor->dependency].seq,
+                                      memory_order_acquire);
+    }
+    return limit - seq;
+}
+
+void *
+e_disruptor__at (E_Disruptor_Data *disruptor, size_t consumer, size_t index, size_t item_size)
+{
+    unsigned char *ptr = disruptor->ptr;
+    size_t seq;
+
+    seq = atomic_load_explicit (&disruptor->cursors[consumer].seq, memory_order_relaxed);
+    return &ptr[((seq + index) & disruptor->mask) * item_size];
+}
+
+void
+e_disruptor__consume (E_Disruptor_Data *disruptor, size_t consumer, size_t count)
+{
+    E_Disruptor__Cursor *cursor = &disruptor->cursors[consumer];
+    size_t available, seq;
+
+    available = e_disruptor__available (disruptor, consumer);
+    if (count > available) count = available;
+    seq = atomic_load_explicit (&cursor->seq, memory_order_relaxed);
+    /* the release orders the reads of the items before the producer overwrites them */
+    atomic_store_explicit (&cursor->seq, seq + count, memory_order_release);
+}
+
+int
+e_disruptor__pop (E_Disruptor_Data *disruptor, size_t consumer, void *out, size_t item_size)
+{
+    E_Disruptor__Cursor *cursor = &disruptor->cursors[consumer];
+    unsigned char *ptr = disruptor->ptr;
+    size_t seq;
+
+    if (e_disruptor__available (disruptor, consumer) == 0) return 0;
+    seq = atomic_load_explicit (&cursor->seq, memory_order_relaxed);
+    if (out != NULL) memcpy (out, &ptr[(seq & disruptor->mask) * item_size], item_size);
+    atomic_store_explicit (&cursor->seq, seq + 1, memory_order_release);
+    return 1;
+}
+
+void
+e_disruptor__pop_wait (E_Disruptor_Data *disruptor, size_t consumer, void *out, size_t item_size)
+{
+    unsigned int spins = 0;
+
+    while (!e_disruptor__pop (disruptor, consumer, out, item_size)) {
+        e_disruptor__backoff (&spins);
+    }
+}
+
+#endif /* E_DISRUPTOR_IMPL */
+
+#endif /* E_DISRUPTOR_H_ */
@@ -0,0 +1,279 @@
+#ifndef E_HEAP_H_
+#define E_HEAP_H_
+
+/**************************************************************************************************
+ *
+ * Empower / e_heap.h - Public Domain - https://git.tjdev.de/thetek/empower
+ *
+ * This module implements binary and d-ary heaps (priority queues) for generic types.
+ *
+ * A heap is stored in a dynamic array (see e_da.h), so `E_Heap (T)` is the same as `E_Da (T)` and
+ * all the read-only `e_da_*` macros can be used on it. The item with the highest priority is always
+ * the first one. Pushing and popping take O(log n) time, as opposed to the O(n) of inserting into
+ * a sorted dynamic array.
+ *
+ * Like sorting in e_da.h, the heap operations are done with functions that are generated for a
+ * specific item type and ordering, so that comparisons and moves can be inlined by the compiler
+ * (see `E_HEAP_DECL` and `E_HEAP_IMPL`):
+ *
+ * ```
+ * E_HEAP_IMPL (int_heap, int)
+ * // ...
+ * E_Heap (int) heap = e_heap_init ();
+ * e_heap_push (&heap, int_heap, 3);
+ * e_heap_push (&heap, int_heap, 1);
+ * int *top = e_heap_peek (&heap); // 1
+ * int popped;
+ * e_heap_pop (&heap, int_heap, &popped); // 1
+ * e_heap_deinit (&heap);
+ * ```
+ *
+ * An existing dynamic array can be turned into a heap in O(n) time by moving its data into the
+ * heap and calling `e_heap_heapify`:
+ *
+ * ```
+ * heap.data = int_list.data;
+ * e_heap_heapify (&heap, int_heap);
+ * ```
+ *
+ * Heaps with more than two children per node (d-ary heaps) are shallower and keep the children of
+ * a node in the same cache line, which usually makes them faster for large heaps, at the cost of
+ * more comparisons per level. 4-ary heaps are a good default for that.
+ *
+ * To change the priority of items that are already in the heap (e.g. decrease-key in Dijkstra's
+ * algorithm), the heap has to tell the items where they are stored. `E_HEAP_IMPL_INDEXED` takes a
+ * hook that is called with every item and its new index whenever it is moved, so that the index
+ * can be stored in the item or in a separate index map. After changing the priority of the item at
+ * a given index, `e_heap_update` restores the order of the heap, and `e_heap_remove` removes an
+ * arbitrary item.
+ *
+ * Since the heap is a dynamic array, the same allocation rules and configuration options as in
+ * e_da.h apply. The implementation of e_da.h (`E_DA_IMPL`) is required.
+ *
+ **************************************************************************************************/
+
+#include "e_da.h"
+
+/**
+ * Generic heap
+ */
+#define E_Heap(T) E_Da (T)
+
+/**
+ * Initialise a new heap.
+ *
+ * No memory is allocated yet.
+ */
+#define e_heap_init() e_da_init ()
+
+/**
+ * Free the memory occupied by the heap.
+ */
+#define e_heap_deinit(heap) e_da_deinit (heap)
+
+/**
+ * Obtain the length (i.e. the number of contained items) of the heap.
+ */
+#define e_heap_len(heap) e_da_len (heap)
+
+/**
+ * Obtain a pointer to the item with the highest priority, or `NULL` if the heap is empty. The item
+ * must not be modified in a way that changes its priority.
+ */
+#define e_heap_peek(heap) (e_heap_len (heap) > 0 ? e_da_first (heap) : NULL)
+
+/**
+ * Restore the order of the heap after its items have been written directly (e.g. when the data of
+ * a dynamic array was moved into it), using the functions generated for `name`. This takes O(n)
+ * time.
+ */
+#define e_heap_heapify(heap, name) name##_heapify (e_da_first (heap), e_heap_len (heap))
+
+/**
+ * Add an item to the heap, using the functions generated for `name`.
+ */
+#define e_heap_push(heap, name, item) name##_push (&(heap)->data, (item))
+
+/**
+ * Remove the item with the highest priority from the heap, using the functions generated for
+ * `name`.
+ *
+ * If the heap is not empty, the item will be removed and written to `out`, and a non-zero (true)
+ * value will be returned. If the heap is empty, no action will be performed, and zero (false) will
+ * be returned.
+ *
+ * If the `out` parameter is `NULL`, nothing will be written to it, but the item will still be
+ * popped and `true` or `false` will be returned.
+ */
+#define e_heap_pop(heap, name, out) name##_pop (&(heap)->data, (1 ? (out) : (heap)->type))
+
+/**
+ * Replace the item with the highest priority by `item`, using the functions generated for `name`.
+ * This is faster than a pop followed by a push.
+ *
+ * If the heap is not empty, the replaced item is written to `out` (unless it is `NULL`), and a
+ * non-zero (true) value is returned. If the heap is empty, `item` is simply pushed, and zero
+ * (false) is returned.
+ */
+#define e_heap_replace_top(heap, name, item, out)                                                  \
+    name##_replace_top (&(heap)->data, (item), (1 ? (out) : (heap)->type))
+
+/**
+ * Restore the order of the heap after the priority of the item at `index` was changed (in either
+ * direction), using the functions generated for `name`.
+ */
+#define e_heap_update(heap, name, index) name##_update (&(heap)->data, (index))
+
+/**
+ * Remove the item at `index` from the heap and write it to `out` (unless it is `NULL`), using the
+ * functions generated for `name`.
+ */
+#define e_heap_remove(heap, name, index, out)                                                      \
+    name##_remove (&(heap)->data, (index), (1 ? (out) : (heap)->type))
+
+/**
+ * Default ordering used by `E_HEAP_IMPL`, which results in a min-heap.
+ */
+#define E_HEAP_LESS(a, b) ((a) < (b))
+
+#define E_HEAP__NO_INDEX(item, index) ((void) 0)
+
+/**
+ * The `E_HEAP_DECL` and `E_HEAP_IMPL` macros generate the heap functions `name##_heapify`,
+ * `name##_push`, `name##_pop`, `name##_replace_top`, `name##_update` and `name##_remove` for heaps
+ * of items of type `T`. They are used through the `e_heap_*` macros.
+ *
+ * `E_HEAP_IMPL` generates a binary min-heap that uses the `<` operator. `E_HEAP_IMPL_BY` uses
+ * `less (a, b)` as the ordering, where `less` is a function or function-like macro that takes two
+ * items by value and returns non-zero if `a` has a higher priority than `b`, and `arity` is the
+ * number of children per node (e.g. 2 for a binary heap or 4 for a 4-ary heap).
+ *
+ * `E_HEAP_IMPL_INDEXED` additionally calls `set_index (item, index)` whenever an item is stored at
+ * a new index, where `item` is an lvalue of type `T` and `index` is a `size_t`. It is not called
+ * for items that are removed from the heap.
+ *
+ * `T` must be a type name that can be prefixed with `const` (use a `typedef` for pointer types).
+ *
+ * Example:
+ *
+ *     // ----- (timers.h) -----
+ *     typedef Timer *Timer_Ptr;
+ *     E_HEAP_DECL (timer_heap, Timer_Ptr);
+ *
+ *     // ----- (timers.c) -----
+ *     #define TIMER_LESS(a, b) ((a)->deadline < (b)->deadline)
+ *     #define TIMER_SET_INDEX(t, i) ((t)->heap_index = (i))
+ *     E_HEAP_IMPL_INDEXED (timer_heap, Timer_Ptr, TIMER_LESS, 4, TIMER_SET_INDEX)
+ *
+ *     // ----- (usage) -----
+ *     timer->deadline -= 10;
+ *     e_heap_update (&timers, timer_heap, timer->heap_index);
+ *
+ * Generated functions:
+ *
+ *     void timer_heap_heapify (Timer_Ptr *ptr, size_t len);
+ *     void timer_heap_push (E_Da_Data *heap, Timer_Ptr item);
+ *     int timer_heap_pop (E_Da_Data *heap, Timer_Ptr *out);
+ *     int timer_heap_replace_top (E_Da_Data *heap, Timer_Ptr item, Timer_Ptr *out);
+ *     void timer_heap_update (E_Da_Data *heap, size_t index);
+ *     void timer_heap_remove (E_Da_Data *heap, size_t index, Timer_Ptr *out);
+ */
+#define E_HEAP_DECL(name, T)                                                                       \
+    void name##_heapify (T *ptr, size_t len);                                                      \
+    void name##_push (E_Da_Data *heap, T item);                                                    \
+    int name##_pop (E_Da_Data *heap, T *out);                                                      \
+    int name##_replace_top (E_Da_Data *heap, T item, T *out);                                      \
+    void name##_update (E_Da_Data *heap, size_t index);                                            \
+    void name##_remove (E_Da_Data *heap, size_t index, T *out)
+#define E_HEAP_IMPL(name, T) E_HEAP_IMPL_BY (name, T, E_HEAP_LESS, 2)
+#define E_HEAP_IMPL_BY(name, T, less, arity)                                                       \
+    E_HEAP_IMPL_INDEXED (name, T, less, arity, E_HEAP__NO_INDEX)
+#define E_HEAP_IMPL_INDEXED(name, T, less, arity, set_index)                                       \
+    /* move `item` up from the hole at `index` and store it where it belongs */                    \
+    static void name##__sift_up (T *ptr, size_t index, T item)                                     \
+    {                                                                                              \
+        size_t parent;                                                                             \
+        while (index > 0) {                                                                        \
+            parent = (index - 1) / (arity);                                                        \
+            if (!less (item, ptr[parent])) break;                                                  \
+            ptr[index] = ptr[parent];                                                              \
+            set_index (ptr[index], index);                                                         \
+            index = parent;                                                                        \
+        }                                                                                          \
+        ptr[index] = item;                                                                         \
+        set_index (ptr[index], index);                                                             \
+    }                                                                                              \
+    /* move `item` down from the hole at `index` and store it where it belongs */                  \
+    static void name##__sift_down (T *ptr, size_t len, size_t index, T item)                       \
+    {                                                                                              \
+        size_t child, best, end;                                                                   \
+        while ((child = (arity) * index + 1) < len) {                                              \
+            end = child + (arity) < len ? child + (arity) : len;                                   \
+            for (best = child++; child < end; child++) {                                           \
+                if (less (ptr[child], ptr[best])) best = child;                                    \
+            }                                                                                      \
+            if (!less (ptr[best], item)) break;                                                    \
+            ptr[index] = ptr[best];                                                                \
+            set_index (ptr[index], index);                                                         \
+            index = best;                                                                          \
+        }                                                                                          \
+        ptr[index] = item;                                                                         \
+        set_index (ptr[index], index);                                                             \
+    }                                                                                              \
+    void name##_heapify (T *ptr, size_t len)                                                       \
+    {                                                                                              \
+        size_t i;                                                                                  \
+        for (i = 0; i < len; i++) {                                                                \
+            set_index (ptr[i], i);                                                                 \
+        }                                                                                          \
+        if (len < 2) return;                                                                       \
+        for (i = (len - 2) / (arity) + 1; i > 0; i--) {                                            \
+            name##__sift_down (ptr, len, i - 1, ptr[i - 1]);                                       \
+        }                                                                                          \
+    }                                                                                              \
+    void name##_push (E_Da_Data *heap, T item)                                                     \
+    {                                                                                              \
+        e_da__reserve (heap, heap->len + 1, sizeof (T));                                           \
+        heap->len += 1;                                                                            \
+        name##__sift_up ((T *) heap->ptr, heap->len - 1, item);                                    \
+    }                                                                                              \
+    int name##_pop (E_Da_Data *heap, T *out)                                                       \
+    {                                                                                              \
+        T *ptr = heap->ptr;                                                                        \
+        if (heap->len == 0) return 0;                                                              \
+        if (out != NULL) *out = ptr[0];                                                            \
+        heap->len -= 1;                                                                            \
+        if (heap->len > 0) name##__sift_down (ptr, heap->len, 0, ptr[heap->len]);                  \
+        return 1;                                                                                  \
+    }                                                                                              \
+    int name##_replace_top (E_Da_Data *heap, T item, T *out)                                       \
+    {                                                                                              \
+        T *ptr = heap->ptr;                                                                        \
+        if (heap->len == 0) {                                                                      \
+            name##_push (heap, item);                                                              \
+            return 0;                                                                              \
+        }                                                                                          \
+        if (out != NULL) *out = ptr[0];                                                            \
+        name##__sift_down (ptr, heap->len, 0, item);                                               \
+        return 1;                                                                                  \
+    }                                                                                              \
+    void name##_update (E_Da_Data *heap, size_t index)                                             \
+    {                                                                                              \
+        T *ptr = heap->ptr;                                                                        \
+        if (index > 0 && less (ptr[index], ptr[(index - 1) / (arity)])) {                          \
+            name##__sift_up (ptr, index, ptr[index]);                                              \
+        } else {                                                                                   \
+            name##__sift_down (ptr, heap->len, index, ptr[index]);                                 \
+        }                                                                                          \
+    }                                                                                              \
+    void name##_remove (E_Da_Data *heap, size_t index, T *out)                                     \
+    {                                                                                              \
+        T *ptr = heap->ptr;                                                                        \
+        if (out != NULL) *out = ptr[index];                                                        \
+        heap->len -= 1;                                                                            \
+        if (index == heap->len) return;                                                            \
+        ptr[index] = ptr[heap->len];                                                               \
+        name##_update (heap, index);                                                               \
+    }
+
+#endif /* E_HEAP_H_ */
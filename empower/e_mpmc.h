@@ -0,0 +1,490 @@
+#ifndef E_MPMC_H_
+#define E_MPMC_H_
+
+/**************************************************************************************************
+ *
+ * Empower / e_mpmc.h - Public Domain - https://git.tjdev.de/thetek/empower
+ *
+ * This module implements bounded lock-free multi-producer/multi-consumer queues for generic types.
+ *
+ * Any number of threads may push and pop items at the same time. Every slot of the queue carries a
+ * sequence number that tells whether it is ready to be written or read in the current round, so
+ * that both pushing and popping only need a single compare-and-swap on the respective index. The
+ * push and pop indices are kept on separate cache lines.
+ *
+ * It can be used as follows:
+ *
+ * ```
+ * E_Mpmc (int) jobs;
+ * e_mpmc_init (&jobs, 1024);
+ * // in any number of producer threads:
+ * if (!e_mpmc_push (&jobs, 42)) { ... } // full
+ * e_mpmc_push_wait (&jobs, 42);
+ * // in any number of consumer threads:
+ * int job;
+ * if (e_mpmc_pop (&jobs, &job)) { ... }
+ * e_mpmc_pop_wait (&jobs, &job);
+ * // after all threads are done:
+ * e_mpmc_deinit (&jobs);
+ * ```
+ *
+ * The `_wait` variants spin and yield for a while when the queue is full or empty, and then block
+ * on a condition variable until another thread pops or pushes an item, so that an idle consumer
+ * does not keep a processor busy. To make this possible, the sequence numbers are accessed with
+ * sequentially consistent operations, and every successful push and pop checks whether a thread is
+ * blocked on the other side, which costs some throughput (about 20% in `bench_mpmc.c` on x86-64).
+ * Condition variables from POSIX threads or the Windows API are used; on other platforms, the
+ * `_wait` variants keep spinning instead of blocking.
+ *
+ * The capacity is fixed and must be a power of two of at least 2. The memory for the items is
+ * allocated on initialisation.
+ *
+ * This module requires C11 atomics.
+ *
+ * On allocation failure, an error message is printed and the programme is aborted.
+ *
+ **************************************************************************************************/
+
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 201112L || defined(__STDC_NO_ATOMICS__)
+# error e_mpmc requires C11 or newer with atomics
+#endif
+
+#include <stdatomic.h>
+#include <stddef.h>
+#if defined(_WIN32)
+# include <windows.h>
+# define E_MPMC__BLOCKING
+typedef SRWLOCK E_Mpmc__Mutex;
+typedef CONDITION_VARIABLE E_Mpmc__Cond;
+#elif defined(__unix__) || defined(__APPLE__)
+# include <pthread.h>
+# define E_MPMC__BLOCKING
+typedef pthread_mutex_t E_Mpmc__Mutex;
+typedef pthread_cond_t E_Mpmc__Cond;
+#endif
+
+/* compatibility annoyances: */
+#ifndef E_TYPEOF
+# if __STDC_VERSION__ >= 202311L
+#  define E_TYPEOF(x) typeof (x)
+# else
+#  define E_TYPEOF(x) __typeof__ (x)
+# endif
+#endif /* E_TYPEOF */
+
+#define E_MPMC__CACHE_LINE 64
+
+/**
+ * Generic bounded multi-producer/multi-consumer queue
+ */
+#define E_Mpmc(T)                                                                                  \
+    union {                                                                                        \
+        E_Mpmc_Data data;                                                                          \
+        T *type; /* NOLINT */                                                                      \
+    }
+
+/**
+ * Initialise a multi-producer/multi-consumer queue with space for `cap` items. `cap` must be a
+ * power of two of at least 2; otherwise, the queue is not initialised and zero (false) is
+ * returned. On success, a non-zero (true) value is returned.
+ *
+ * The queue must be initialised before it is shared with other threads.
+ */
+#define e_mpmc_init(mpmc, cap) e_mpmc__init (&(mpmc)->data, (cap), sizeof (*(mpmc)->type))
+
+/**
+ * Free the memory occupied by the queue. Must only be called once no other thread uses it anymore.
+ */
+#define e_mpmc_deinit(mpmc) e_mpmc__deinit (&(mpmc)->data)
+
+/**
+ * Obtain the capacity (i.e. the maximum number of items that can be added) of the queue.
+ */
+#define e_mpmc_cap(mpmc) ((mpmc)->data.mask + 1)
+
+/**
+ * Obtain the number of items in the queue. When called while other threads are active, the result
+ * is only an approximation.
+ */
+#define e_mpmc_len(mpmc) e_mpmc__len (&(mpmc)->data)
+
+/**
+ * Try to add an item to the queue.
+ *
+ * If the queue is full, nothing is added and zero (false) is returned. Otherwise, a non-zero (true)
+ * value is returned.
+ */
+#define e_mpmc_push(mpmc, item)                                                                    \
+    e_mpmc__push (&(mpmc)->data, (E_TYPEOF (*(mpmc)->type)[1]) {(item)}, sizeof (*(mpmc)->type))
+
+/**
+ * Try to add an item to the queue (but the item is a pointer).
+ *
+ * If the queue is full, nothing is added and zero (false) is returned. Otherwise, a non-zero (true)
+ * value is returned.
+ */
+#define e_mpmc_push_ref(mpmc, item_ptr)                                                            \
+    e_mpmc__push (&(mpmc)->data, (1 ? (item_ptr) : (mpmc)->type), sizeof (*(mpmc)->type))
+
+/**
+ * Add an item to the queue, waiting for space to become available if it is full.
+ */
+#define e_mpmc_push_wait(mpmc, item)                                                               \
+    e_mpmc__push_wait (&(mpmc)->data, (E_TYPEOF (*(mpmc)->type)[1]) {(item)},                      \
+                       sizeof (*(mpmc)->type))
+
+/**
+ * Try to pop an item from the queue.
+ *
+ * If the queue is not empty, the item will be removed and written to `out`, and a non-zero (true)
+ * value will be returned. If the queue is empty, no action will be performed, and zero (false) will
+ * be returned.
+ *
+ * If the `out` parameter is `NULL`, nothing will be written to it, but the item will still be
+ * popped and `true` or `false` will be returned.
+ */
+#define e_mpmc_pop(mpmc, out)                                                                      \
+    e_mpmc__pop (&(mpmc)->data, (1 ? (out) : (mpmc)->type), sizeof (*(mpmc)->type))
+
+/**
+ * Pop an item from the queue and write it to `out`, waiting for an item to become available if the
+ * queue is empty. If the `out` parameter is `NULL`, nothing will be written to it.
+ */
+#define e_mpmc_pop_wait(mpmc, out)                                                                 \
+    e_mpmc__pop_wait (&(mpmc)->data, (1 ? (out) : (mpmc)->type), sizeof (*(mpmc)->type))
+
+typedef struct {
+    /* read-only after initialisation */
+    _Atomic (size_t) *seqs;
+    void *ptr;
+    size_t mask;
+    unsigned char pad0_[E_MPMC__CACHE_LINE];
+    /* position of the next push */
+    _Atomic (size_t) head;
+    unsigned char pad1_[E_MPMC__CACHE_LINE];
+    /* position of the next pop */
+    _Atomic (size_t) tail;
+    unsigned char pad2_[E_MPMC__CACHE_LINE];
+#ifdef E_MPMC__BLOCKING
+    /* threads that are blocked in `e_mpmc_push_wait` and `e_mpmc_pop_wait` */
+    _Atomic (unsigned int) push_waiters;
+    _Atomic (unsigned int) pop_waiters;
+    E_Mpmc__Mutex lock;
+    E_Mpmc__Cond space; /* signalled after a pop */
+    E_Mpmc__Cond items; /* signalled after a push */
+#endif
+} E_Mpmc_Data;
+
+int e_mpmc__init (E_Mpmc_Data *mpmc, size_t cap, size_t item_size);
+void e_mpmc__deinit (E_Mpmc_Data *mpmc);
+size_t e_mpmc__len (E_Mpmc_Data *mpmc);
+int e_mpmc__push (E_Mpmc_Data *mpmc, const void *item, size_t item_size);
+void e_mpmc__push_wait (E_Mpmc_Data *mpmc, const void *item, size_t item_size);
+int e_mpmc__pop (E_Mpmc_Data *mpmc, void *out, size_t item_size);
+void e_mpmc__pop_wait (E_Mpmc_Data *mpmc, void *out, size_t item_size);
+
+/**************************************************************************************************/
+
+#ifdef E_MPMC_IMPL
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# if defined(__unix__) || defined(__APPLE__)
+#  include <sched.h>
+# endif
+
+# define E_MPMC__SPIN_LIMIT  64
+# define E_MPMC__YIELD_LIMIT 16
+
+void e_mpmc__spin (unsigned int *spins);
+int e_mpmc__try_push (E_Mpmc_Data *mpmc, const void *item, size_t item_size);
+int e_mpmc__try_pop (E_Mpmc_Data *mpmc, void *out, size_t item_size);
+# ifdef E_MPMC__BLOCKING
+void e_mpmc__lock (E_Mpmc_Data *mpmc);
+void e_mpmc__unlock (E_Mpmc_Data *mpmc);
+void e_mpmc__wait (E_Mpmc_Data *mpmc, E_Mpmc__Cond *cond);
+void e_mpmc__wake (E_Mpmc_Data *mpmc, _Atomic (unsigned int) *waiters, E_Mpmc__Cond *cond);
+# endif /* E_MPMC__BLOCKING */
+
+/**
+ * Wait a little while before blocking, since the threads that are being waited for are likely to
+ * make progress soon. For the first `E_MPMC__SPIN_LIMIT` spins, only the processor is told that
+ * this is a spin loop. Afterwards, the processor is given to other threads, since the threads that
+ * are being waited for may not be running.
+ */
+void
+e_mpmc__spin (unsigned int *spins)
+{
+    *spins += 1;
+    if (*spins <= E_MPMC__SPIN_LIMIT) {
+# if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_ia32_pause ();
+# elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+        __asm__ volatile ("yield");
+# endif
+        return;
+    }
+# if defined(_WIN32)
+    SwitchToThread ();
+# elif defined(__unix__) || defined(__APPLE__)
+    sched_yield ();
+# endif
+}
+
+# ifdef E_MPMC__BLOCKING
+
+void
+e_mpmc__lock (E_Mpmc_Data *mpmc)
+{
+#  if defined(_WIN32)
+    AcquireSRWLockExclusive (&mpmc->lock);
+#  else
+    pthread_mutex_lock (&mpmc->lock);
+#  endif
+}
+
+void
+e_mpmc__unlock (E_Mpmc_Data *mpmc)
+{
+#  if defined(_WIN32)
+    ReleaseSRWLockExclusive (&mpmc->lock);
+#  else
+    pthread_mutex_unlock (&mpmc->lock);
+#  endif
+}
+
+/**
+ * Block on `cond` until it is signalled. The lock must be held.
+ */
+void
+e_mpmc__wait (E_Mpmc_Data *mpmc, E_Mpmc__Cond *cond)
+{
+#  if defined(_WIN32)
+    SleepConditionVariableSRW (cond, &mpmc->lock, INFINITE, 0);
+#  else
+    pthread_cond_wait (cond, &mpmc->lock);
+#  endif
+}
+
+/**
+ * Wake up one of the threads that are blocked on `cond`, if there are any. Called after a
+ * successful push or pop. The sequence numbers and the waiter counts are accessed with sequentially
+ * consistent operations, so either the blocked thread sees the changed slot after counting itself,
+ * or this thread sees the blocked thread. Since a thread only counts itself as blocked while
+ * holding the lock or waiting on `cond`, the signal cannot get lost.
+ */
+void
+e_mpmc__wake (E_Mpmc_Data *mpmc, _Atomic (unsigned int) *waiters, E_Mpmc__Cond *cond)
+{
+    if (atomic_load_explicit (waiters, memory_order_seq_cst) == 0) return;
+    e_mpmc__lock (mpmc);
+#  if defined(_WIN32)
+    WakeConditionVariable (cond);
+#  else
+    pthread_cond_signal (cond);
+#  endif
+    e_mpmc__unlock (mpmc);
+}
+
+# endif /* E_MPMC__BLOCKING */
+
+int
+e_mpmc__init (E_Mpmc_Data *mpmc, size_t cap, size_t item_size)
+{
+    size_t i;
+
+    if (cap < 2 || (cap & (cap - 1)) != 0) return 0;
+    mpmc->seqs = malloc (cap * sizeof (*mpmc->seqs));
+    mpmc->ptr = malloc (cap * item_size);
+    if (mpmc->seqs == NULL || mpmc->ptr == NULL) {
+        fprintf (stderr, "[e_mpmc] allocation failed!\n");
+        abort ();
+    }
+    for (i = 0; i < cap; i++) {
+        atomic_init (&mpmc->seqs[i], i);
+    }
+    mpmc->mask = cap - 1;
+    atomic_init (&mpmc->head, 0);
+    atomic_init (&mpmc->tail, 0);
+# ifdef E_MPMC__BLOCKING
+    atomic_init (&mpmc->push_waiters, 0);
+    atomic_init (&mpmc->pop_waiters, 0);
+#  if defined(_WIN32)
+    InitializeSRWLock (&mpmc->lock);
+    InitializeConditionVariable (&mpmc->space);
+    InitializeConditionVariable (&mpmc->items);
+#  else
+    pthread_mutex_init (&mpmc->lock, NULL);
+    pthread_cond_init (&mpmc->space, NULL);
+    pthread_cond_init (&mpmc->items, NULL);
+#  endif
+# endif /* E_MPMC__BLOCKING */
+    return 1;
+}
+
+void
+e_mpmc__deinit (E_Mpmc_Data *mpmc)
+{
+    free (mpmc->seqs);
+    free (mpmc->ptr);
+# if defined(E_MPMC__BLOCKING) && !defined(_WIN32)
+    pthread_mutex_destroy (&mpmc->lock);
+    pthread_cond_destroy (&mpmc->space);
+    pthread_cond_destroy (&mpmc->items);
+# endif
+}
+
+size_t
+e_mpmc__len (E_Mpmc_Data *mpmc)
+{
+    size_t tail, head;
+
+    tail = atomic_load_explicit (&mpmc->tail, memory_order_acquire);
+    head = atomic_load_explicit (&mpmc->head, memory_order_acquire);
+    return head > tail ? head - tail : 0;
+}
+
+/**
+ * Try to add an item without waking up blocked consumers.
+ */
+int
+e_mpmc__try_push (E_Mpmc_Data *mpmc, const void *item, size_t item_size)
+{
+    unsigned char *ptr = mpmc->ptr;
+    size_t pos, seq;
+    ptrdiff_t diff;
+
+    /* a slot is ready to be written in round `pos` once its sequence number equals `pos` */
+    pos = atomic_load_explicit (&mpmc->head, memory_order_relaxed);
+    for (;;) {
+        seq = atomic_load_explicit (&mpmc->seqs[pos & mpmc->mask], memory_order_seq_cst);
+        diff = (ptrdiff_t) (seq - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit (&mpmc->head, &pos, pos + 1,
+                                                       memory_order_relaxed,
+                                                       memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return 0; /* the slot still holds an item from the previous round */
+        } else {
+            pos = atomic_load_explicit (&mpmc->head, memory_order_relaxed);
+        }
+    }
+
+    memcpy (&ptr[(pos & mpmc->mask) * item_size], item, item_size);
+    atomic_store_explicit (&mpmc->seqs[pos & mpmc->mask], pos + 1, memory_order_seq_cst);
+    return 1;
+}
+
+int
+e_mpmc__push (E_Mpmc_Data *mpmc, const void *item, size_t item_size)
+{
+    if (!e_mpmc__try_push (mpmc, item, item_size)) return 0;
+# ifdef E_MPMC__BLOCKING
+    e_mpmc__wake (mpmc, &mpmc->pop_waiters, &mpmc->items);
+# endif
+    return 1;
+}
+
+void
+e_mpmc__push_wait (E_Mpmc_Data *mpmc, const void *item, size_t item_size)
+{
+    unsigned int spins = 0;
+
+    while (!e_mpmc__try_push (mpmc, item, item_size)) {
+        if (spins < E_MPMC__SPIN_LIMIT + E_MPMC__YIELD_LIMIT) {
+            e_mpmc__spin (&spins);
+            continue;
+        }
+# ifdef E_MPMC__BLOCKING
+        e_mpmc__lock (mpmc);
+        atomic_fetch_add_explicit (&mpmc->push_waiters, 1, memory_order_seq_cst);
+        while (!e_mpmc__try_push (mpmc, item, item_size)) {
+            e_mpmc__wait (mpmc, &mpmc->space);
+        }
+        atomic_fetch_sub_explicit (&mpmc->push_waiters, 1, memory_order_relaxed);
+        e_mpmc__unlock (mpmc);
+        break;
+# endif /* E_MPMC__BLOCKING */
+    }
+# ifdef E_MPMC__BLOCKING
+    e_mpmc__wake (mpmc, &mpmc->pop_waiters, &mpmc->items);
+# endif
+}
+
+/**
+ * Try to pop an item without waking up blocked producers.
+ */
+int
+e_mpmc__try_pop (E_Mpmc_Data *mpmc, void *out, size_t item_size)
+{
+    unsigned char *ptr = mpmc->ptr;
+    size_t pos, seq;
+    ptrdiff_t diff;
+
+    /* a slot is ready to be read in round `pos` once its sequence number equals `pos + 1` */
+    pos = atomic_load_explicit (&mpmc->tail, memory_order_relaxed);
+    for (;;) {
+        seq = atomic_load_explicit (&mpmc->seqs[pos & mpmc->mask], memory_order_seq_cst);
+        diff = (ptrdiff_t) (seq - (pos + 1));
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit (&mpmc->tail, &pos, pos + 1,
+                                                       memory_order_relaxed,
+                                                       memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return 0; /* the slot has not been written in this round yet */
+        } else {
+            pos = atomic_load_explicit (&mpmc->tail, memory_order_relaxed);
+        }
+    }
+
+    if (out != NULL) memcpy (out, &ptr[(pos & mpmc->mask) * item_size], item_size);
+    /* release the slot for the push in the next round */
+    atomic_store_explicit (&mpmc->seqs[pos & mpmc->mask], pos + mpmc->mask + 1,
+                           memory_order_seq_cst);
+    return 1;
+}
+
+int
+e_mpmc__pop (E_Mpmc_Data *mpmc, void *out, size_t item_size)
+{
+    if (!e_mpmc__try_pop (mpmc, out, item_size)) return 0;
+# ifdef E_MPMC__BLOCKING
+    e_mpmc__wake (mpmc, &mpmc->push_waiters, &mpmc->space);
+# endif
+    return 1;
+}
+
+void
+e_mpmc__pop_wait (E_Mpmc_Data *mpmc, void *out, size_t item_size)
+{
+    unsigned int spins = 0;
+
+    while (!e_mpmc__try_pop (mpmc, out, item_size)) {
+        if (spins < E_MPMC__SPIN_LIMIT + E_MPMC__YIELD_LIMIT) {
+            e_mpmc__spin (&spins);
+            continue;
+        }
+# ifdef E_MPMC__BLOCKING
+        e_mpmc__lock (mpmc);
+        atomic_fetch_add_explicit (&mpmc->pop_waiters, 1, memory_order_seq_cst);
+        while (!e_mpmc__try_pop (mpmc, out, item_size)) {
+            e_mpmc__wait (mpmc, &mpmc->items);
+        }
+        atomic_fetch_sub_explicit (&mpmc->pop_waiters, 1, memory_order_relaxed);
+        e_mpmc__unlock (mpmc);
+        break;
+# endif /* E_MPMC__BLOCKING */
+    }
+# ifdef E_MPMC__BLOCKING
+    e_mpmc__wake (mpmc, &mpmc->push_waiters, &mpmc->space);
+# endif
+}
+
+#endif /* E_MPMC_IMPL */
+
+#endif /* E_MPMC_H_ */
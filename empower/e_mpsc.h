@@ -0,0 +1,162 @@
+#ifndef E_MPSC_H_
+#define E_MPSC_H_
+
+/**************************************************************************************************
+ *
+ * Empower / e_mpsc.h - Public Domain - https://git.tjdev.de/thetek/empower
+ *
+ * This module implements unbounded intrusive multi-producer/single-consumer queues.
+ *
+ * Any number of threads may push to the queue while a single thread pops from it, which is the
+ * typical shape of an actor's mailbox. Pushing is a single atomic exchange and never blocks or
+ * retries. On the fast path, popping only reads the node that is being popped and the next one,
+ * and does not touch the end of the queue that producers write to.
+ *
+ * The queue is intrusive: instead of copying items, it links `E_Mpsc_Node`s that are embedded in
+ * the user's structs, so the queue itself never allocates memory. The struct can be obtained from
+ * a popped node with `E_CONTAINER_OF` (see e_macro.h):
+ *
+ * ```
+ * typedef struct {
+ *     E_Mpsc_Node node;
+ *     int payload;
+ * } Message;
+ *
+ * E_Mpsc mailbox;
+ * e_mpsc_init (&mailbox);
+ * // in any number of producer threads:
+ * e_mpsc_push (&mailbox, &message->node);
+ * // in the consumer thread:
+ * E_Mpsc_Node *node;
+ * while ((node = e_mpsc_pop (&mailbox)) != NULL) {
+ *     Message *message = E_CONTAINER_OF (node, Message, node);
+ *     // ...
+ * }
+ * ```
+ *
+ * A node must not be pushed again before it has been popped. While a producer is in the middle of
+ * a push, the nodes that were pushed after it are not visible to the consumer yet, so `e_mpsc_pop`
+ * may briefly return `NULL` even though the queue is not empty.
+ *
+ * This module requires C11 atomics.
+ *
+ **************************************************************************************************/
+
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 201112L || defined(__STDC_NO_ATOMICS__)
+# error e_mpsc requires C11 or newer with atomics
+#endif
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+#define E_MPSC__CACHE_LINE 64
+
+/**
+ * Node that is embedded in the items of a multi-producer/single-consumer queue
+ */
+typedef struct E_Mpsc_Node {
+    _Atomic (struct E_Mpsc_Node *) next;
+} E_Mpsc_Node;
+
+/**
+ * Intrusive multi-producer/single-consumer queue
+ */
+typedef struct {
+    /* written by producers */
+    _Atomic (E_Mpsc_Node *) head;
+    unsigned char pad_[E_MPSC__CACHE_LINE - sizeof (E_Mpsc_Node *)];
+    /* owned by the consumer */
+    E_Mpsc_Node *tail;
+    E_Mpsc_Node stub;
+} E_Mpsc;
+
+/**
+ * Initialise an empty queue. Since the queue contains a node that refers to itself, it must not be
+ * moved or copied after it has been initialised.
+ */
+void e_mpsc_init (E_Mpsc *mpsc);
+
+/**
+ * Add `node` to the end of the queue. Can be called from any thread.
+ */
+void e_mpsc_push (E_Mpsc *mpsc, E_Mpsc_Node *node);
+
+/**
+ * Remove the node at the start of the queue and return it. If the queue is empty (or the next node
+ * is still being pushed), `NULL` is returned. Must only be called by the consumer.
+ */
+E_Mpsc_Node *e_mpsc_pop (E_Mpsc *mpsc);
+
+/**
+ * Check whether the queue is empty. Must only be called by the consumer. When called while
+ * producers are active, the result may already be outdated when it is returned.
+ */
+int e_mpsc_is_empty (E_Mpsc *mpsc);
+
+/**************************************************************************************************/
+
+#ifdef E_MPSC_IMPL
+
+void
+e_mpsc_init (E_Mpsc *mpsc)
+{
+    atomic_init (&mpsc->stub.next, NULL);
+    atomic_init (&mpsc->head, &mpsc->stub);
+    mpsc->tail = &mpsc->stub;
+}
+
+void
+e_mpsc_push (E_Mpsc *mpsc, E_Mpsc_Node *node)
+{
+    E_Mpsc_Node *prev;
+
+    atomic_store_explicit (&node->next, NULL, memory_order_relaxed);
+    prev = atomic_exchange_explicit (&mpsc->head, node, memory_order_acq_rel);
+    /* until this store, the consumer cannot reach `node` (or anything pushed after it) */
+    atomic_store_explicit (&prev->next, node, memory_order_release);
+}
+
+E_Mpsc_Node *
+e_mpsc_pop (E_Mpsc *mpsc)
+{
+    E_Mpsc_Node *tail, *next;
+
+    tail = mpsc->tail;
+    next = atomic_load_explicit (&tail->next, memory_order_acquire);
+
+    /* skip the stub node */
+    if (tail == &mpsc->stub) {
+        if (next == NULL) return NULL;
+        mpsc->tail = next;
+        tail = next;
+        next = atomic_load_explicit (&tail->next, memory_order_acquire);
+    }
+
+    if (next != NULL) {
+        mpsc->tail = next;
+        return tail;
+    }
+
+    /* `tail` is the last node: it can only be popped once there is a node after it */
+    if (tail != atomic_load_explicit (&mpsc->head, memory_order_acquire)) return NULL;
+    e_mpsc_push (mpsc, &mpsc->stub);
+    next = atomic_load_explicit (&tail->next, memory_order_acquire);
+    if (next != NULL) {
+        mpsc->tail = next;
+        return tail;
+    }
+    return NULL;
+}
+
+int
+e_mpsc_is_empty (E_Mpsc *mpsc)
+{
+    E_Mpsc_Node *tail;
+
+    tail = mpsc->tail;
+    return tail == &mpsc->stub && atomic_load_explicit (&tail->next, memory_order_acquire) == NULL;
+}
+
+#endif /* E_MPSC_IMPL */
+
+#endif /* E_MPSC_H_ */
@@ -32,6 +32,19 @@
  * Usually, you `push()` to the front and `pop()` from the back. Alternatively, you can
  * `push_back()` to the back and `pop_front()` from the front to do it in the reverse direction.
  *
+ * Multiple items can be moved at once with `e_queue_push_n` and `e_queue_pop_n`. To process items
+ * without copying them out of the queue, `e_queue_peek_spans` provides the (up to two) contiguous
+ * memory regions that contain them:
+ *
+ * ```
+ * int *first, *second;
+ * size_t first_len, second_len;
+ * e_queue_peek_spans (&int_queue, &first, &first_len, &second, &second_len);
+ * process (first, first_len);
+ * process (second, second_len);
+ * e_queue_pop_n (&int_queue, NULL, first_len + second_len);
+ * ```
+ *
  * The following figure illustrates the used terms:
  *
  *            [BACK......FRONT]
@@ -40,6 +53,10 @@
  *    +---+---+---+---+---+---+---+---+
  *              ^tail           ^head
  *
+ * By default, memory is allocated using `realloc` and `free`. A custom allocator (see `E_Allocator`
+ * in e_alloc.h) can be used by initialising the queue with `e_queue_init_with_allocator`. The
+ * allocator must outlive the queue.
+ *
  * On allocation failure, an error message is printed and the programme is aborted.
  *
  **************************************************************************************************/
@@ -55,6 +72,17 @@
 # endif
 #endif /* E_TYPEOF */
 
+/* allocator interface (see e_alloc.h): */
+#ifndef E_ALLOCATOR_DEFINED
+# define E_ALLOCATOR_DEFINED
+typedef struct {
+    void *(*alloc_fn) (void *ctx, size_t size);
+    void *(*realloc_fn) (void *ctx, void *ptr, size_t old_size, size_t new_size);
+    void (*free_fn) (void *ctx, void *ptr, size_t size);
+    void *ctx;
+} E_Allocator;
+#endif /* E_ALLOCATOR_DEFINED */
+
 /**
  * Generic resizable double-ended queue
  */
@@ -71,10 +99,24 @@
  */
 #define e_queue_init() {0}
 
+/**
+ * Initialise a new queue that obtains its memory from `allocator` (of type `const E_Allocator *`).
+ * Passing `NULL` is equivalent to `e_queue_init()`.
+ *
+ * No memory is allocated yet.
+ *
+ * In C89, initialisers must be constant, so you may have to set the allocator manually instead:
+ * ```
+ * E_Queue (int) queue = e_queue_init ();
+ * queue.data.allocator = &allocator;
+ * ```
+ */
+#define e_queue_init_with_allocator(allocator) {{NULL, 0, 0, 0, 0, (allocator)}}
+
 /**
  * Free the memory occupied by the queue.
  */
-#define e_queue_deinit(queue) e_queue__deinit (&(queue)->data)
+#define e_queue_deinit(queue) e_queue__deinit (&(queue)->data, sizeof (*(queue)->type))
 
 /**
  * Obtain the length (i.e. the number of contained items) of the queue.
@@ -137,19 +179,56 @@
 #define e_queue_pop_front(queue, out)                                                              \
     e_queue__pop_front (&(queue)->data, (1 ? (out) : (queue)->type), sizeof (*(queue)->type))
 
+/**
+ * Add `count` items to the front of the queue. `items[0]` is added first, so it will also be the
+ * first one to be popped with `e_queue_pop`.
+ */
+#define e_queue_push_n(queue, items, count)                                                        \
+    e_queue__push_n (&(queue)->data, (1 ? (items) : (queue)->type), (count),                       \
+                     sizeof (*(queue)->type))
+
+/**
+ * Pop up to `count` items from the back of the queue and write them to `out` in the order in which
+ * they were popped. The number of popped items is returned.
+ *
+ * If the `out` parameter is `NULL`, nothing will be written to it, but the items will still be
+ * popped.
+ */
+#define e_queue_pop_n(queue, out, count)                                                           \
+    e_queue__pop_n (&(queue)->data, (1 ? (out) : (queue)->type), (count), sizeof (*(queue)->type))
+
+/**
+ * Obtain the items of the queue as up to two contiguous memory regions, without copying them. The
+ * items in `*first` (of length `*first_len`) followed by the items in `*second` (of length
+ * `*second_len`) are all items of the queue in the order in which `e_queue_pop` would return them.
+ * Unused regions have a length of 0. The number of non-empty regions is returned.
+ *
+ * The regions are invalidated when an item is added to the queue.
+ */
+#define e_queue_peek_spans(queue, first, first_len, second, second_len)                            \
+    ((*(first) = (E_TYPEOF ((queue)->type)) e_queue__span (&(queue)->data, 0, (first_len),         \
+                                                           sizeof (*(queue)->type))),              \
+     (*(second) = (E_TYPEOF ((queue)->type)) e_queue__span (&(queue)->data, 1, (second_len),       \
+                                                            sizeof (*(queue)->type))),             \
+     (*(first_len) > 0) + (*(second_len) > 0))
+
 typedef struct {
     void *ptr;
     size_t cap;
     size_t len;
     size_t head;
     size_t tail;
+    const E_Allocator *allocator;
 } E_Queue_Data;
 
-void e_queue__deinit (E_Queue_Data *queue);
+void e_queue__deinit (E_Queue_Data *queue, size_t item_size);
 void e_queue__push (E_Queue_Data *queue, const void *item, size_t item_size);
 void e_queue__push_back (E_Queue_Data *queue, const void *item, size_t item_size);
 int e_queue__pop (E_Queue_Data *queue, void *out, size_t item_size);
 int e_queue__pop_front (E_Queue_Data *queue, void *out, size_t item_size);
+void e_queue__push_n (E_Queue_Data *queue, const void *items, size_t count, size_t item_size);
+size_t e_queue__pop_n (E_Queue_Data *queue, void *out, size_t count, size_t item_size);
+void *e_queue__span (E_Queue_Data *queue, int index, size_t *len, size_t item_size);
 
 /**************************************************************************************************/
 
@@ -164,9 +243,13 @@ int e_queue__pop_front (E_Queue_Data *queue, void *out, size_t item_size);
 void e_queue__reserve (E_Queue_Data *queue, size_t cap, size_t item_size);
 
 void
-e_queue__deinit (E_Queue_Data *queue)
+e_queue__deinit (E_Queue_Data *queue, size_t item_size)
 {
-    free (queue->ptr);
+    if (queue->allocator == NULL) {
+        free (queue->ptr);
+    } else if (queue->ptr != NULL) {
+        queue->allocator->free_fn (queue->allocator->ctx, queue->ptr, queue->cap * item_size);
+    }
 }
 
 void
@@ -183,7 +266,14 @@ e_queue__reserve (E_Queue_Data *queue, size_t cap, size_t item_size)
         queue->cap *= 2;
 
     /* reallocate */
-    ptr = realloc (queue->ptr, queue->cap * item_size);
+    if (queue->allocator == NULL) {
+        ptr = realloc (queue->ptr, queue->cap * item_size);
+    } else if (queue->ptr == NULL) {
+        ptr = queue->allocator->alloc_fn (queue->allocator->ctx, queue->cap * item_size);
+    } else {
+        ptr = queue->allocator->realloc_fn (queue->allocator->ctx, queue->ptr, old_cap * item_size,
+                                            queue->cap * item_size);
+    }
     if (ptr == NULL) {
         fprintf (stderr, "[e_queue] allocation failed!\n");
         abort ();
@@ -208,7 +298,8 @@ e_queue__push (E_Queue_Data *queue, const void *item, size_t item_size)
     slot = &ptr[queue->head * item_size];
     memcpy (slot, item, item_size);
     queue->len += 1;
-    queue->head = (queue->head + 1) % queue->cap;
+    queue->head += 1;
+    if (queue->head == queue->cap) queue->head = 0;
 }
 
 void
@@ -218,7 +309,7 @@ e_queue__push_back (E_Queue_Data *queue, const void *item, size_t item_size)
     unsigned char *ptr;
 
     e_queue__reserve (queue, queue->len + 1, item_size);
-    queue->tail = (queue->tail + queue->cap - 1) % queue->cap;
+    queue->tail = (queue->tail == 0 ? queue->cap : queue->tail) - 1;
     ptr = queue->ptr;
     slot = &ptr[queue->tail * item_size];
     memcpy (slot, item, item_size);
@@ -239,7 +330,8 @@ e_queue__pop (E_Queue_Data *queue, void *out, size_t item_size)
         slot = &ptr[queue->tail * item_size];
         memcpy (out, slot, item_size);
     }
-    queue->tail = (queue->tail + 1) % queue->cap;
+    queue->tail += 1;
+    if (queue->tail == queue->cap) queue->tail = 0;
     return 1;
 }
 
@@ -252,7 +344,7 @@ e_queue__pop_front (E_Queue_Data *queue, void *out, size_t item_size)
     if (queue->len == 0) return 0;
 
     queue->len -= 1;
-    queue->head = (queue->head + queue->cap - 1) % queue->cap;
+    queue->head = (queue->head == 0 ? queue->cap : queue->head) - 1;
     if (out != NULL) {
         ptr = queue->ptr;
         slot = &ptr[queue->head * item_size];
@@ -261,6 +353,70 @@ e_queue__pop_front (E_Queue_Data *queue, void *out, size_t item_size)
     return 1;
 }
 
+void
+e_queue__push_n (E_Queue_Data *queue, const void *items, size_t count, size_t item_size)
+{
+    const unsigned char *src = items;
+    unsigned char *ptr;
+    size_t run;
+
+    if (count == 0) return;
+    e_queue__reserve (queue, queue->len + count, item_size);
+    ptr = queue->ptr;
+
+    /* copy up to the end of the buffer, then wrap around to the start */
+    run = queue->cap - queue->head;
+    if (run > count) run = count;
+    memcpy (&ptr[queue->head * item_size], src, run * item_size);
+    memcpy (ptr, &src[run * item_size], (count - run) * item_size);
+
+    queue->len += count;
+    queue->head += count;
+    if (queue->head >= queue->cap) queue->head -= queue->cap;
+}
+
+size_t
+e_queue__pop_n (E_Queue_Data *queue, void *out, size_t count, size_t item_size)
+{
+    unsigned char *dst = out;
+    unsigned char *ptr;
+    size_t run;
+
+    if (count > queue->len) count = queue->len;
+    if (count == 0) return 0;
+
+    if (out != NULL) {
+        ptr = queue->ptr;
+        run = queue->cap - queue->tail;
+        if (run > count) run = count;
+        memcpy (dst, &ptr[queue->tail * item_size], run * item_size);
+        memcpy (&dst[run * item_size], ptr, (count - run) * item_size);
+    }
+
+    queue->len -= count;
+    queue->tail += count;
+    if (queue->tail >= queue->cap) queue->tail -= queue->cap;
+    return count;
+}
+
+/**
+ * Obtain the first (`index` 0) or second (`index` 1) contiguous region of items in the order in
+ * which they would be popped. The length is written to `len`, and `NULL` is returned if it is 0.
+ */
+void *
+e_queue__span (E_Queue_Data *queue, int index, size_t *len, size_t item_size)
+{
+    unsigned char *ptr;
+    size_t run;
+
+    ptr = queue->ptr;
+    run = queue->cap - queue->tail;
+    if (run > queue->len) run = queue->len;
+    *len = index == 0 ? run : queue->len - run;
+    if (*len == 0) return NULL;
+    return index == 0 ? &ptr[queue->tail * item_size] : ptr;
+}
+
 #endif /* E_QUEUE_IMPL */
 
 #endif /* E_QUEUE_H_ */
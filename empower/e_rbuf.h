@@ -42,6 +42,44 @@
  *    +---+---+---+---+---+---+---+---+
  *              ^tail           ^head
  *
+ * Items can also be written and read in place, without copying them through an intermediate
+ * buffer. `e_rbuf_reserve` returns free slots at the head that can be written and then added with
+ * `e_rbuf_commit`, and `e_rbuf_peek` returns items at the tail that can be read and then removed
+ * with `e_rbuf_consume`:
+ *
+ * ```
+ * size_t n;
+ * char *dst = e_rbuf_reserve (&rbuf, 512, &n);
+ * n = serialise (dst, n);
+ * e_rbuf_commit (&rbuf, n);
+ * const char *src = e_rbuf_peek (&rbuf, e_rbuf_len (&rbuf), &n);
+ * n = parse (src, n);
+ * e_rbuf_consume (&rbuf, n);
+ * ```
+ *
+ * Usually, only the slots up to the end of the memory are contiguous, so accesses that wrap around
+ * have to be split into two spans.
+ *
+ * On Linux, a mirrored ringbuffer can be created with `e_rbuf_mirror_init` instead (see
+ * `E_CONFIG_RBUF_MIRROR`). Its memory is mapped twice, back to back, so that the item after the
+ * last one is the first one again. Any range of up to `cap` items starting at the head or tail is
+ * then contiguous, so that e.g. `read ()` can write directly into the ringbuffer and a parser can
+ * read a frame that wraps around without copying it:
+ *
+ * ```
+ * E_Rbuf (char) rbuf;
+ * e_rbuf_mirror_init (&rbuf, 65536);
+ * ssize_t n = read (fd, e_rbuf_head_ptr (&rbuf), e_rbuf_cap (&rbuf) - e_rbuf_len (&rbuf));
+ * if (n > 0) e_rbuf_commit (&rbuf, (size_t) n);
+ * parse (e_rbuf_tail_ptr (&rbuf), e_rbuf_len (&rbuf)); // contiguous, even if it wraps around
+ * e_rbuf_mirror_deinit (&rbuf);
+ * ```
+ *
+ * Configuration options:
+ *  - `E_CONFIG_FREESTANDING`: Do not use functions from the standard library.
+ *  - `E_CONFIG_RBUF_MIRROR`: When defined, enables `e_rbuf_mirror_init` and `e_rbuf_mirror_deinit`
+ *    (Linux only). This requires `_GNU_SOURCE` to be defined before any system header is included.
+ *
  **************************************************************************************************/
 
 #include <stddef.h>
@@ -84,7 +122,7 @@
  * rbuf.data.cap = cap;
  * ```
  */
-#define e_rbuf_init(ptr, cap) {{(ptr), (cap), 0, 0, 0}}
+#define e_rbuf_init(ptr, cap) {{(ptr), (cap), 0, 0, 0, 0}}
 
 /**
  * Obtain the length (i.e. the number of contained items) of the ringbuffer.
@@ -166,30 +204,133 @@
 #define e_rbuf_pop_front(rbuf, out)                                                                \
     e_rbuf__pop_front (&(rbuf)->data, (1 ? (out) : (rbuf)->type), sizeof (*(rbuf)->type))
 
+/**
+ * Obtain a pointer to the slot at the head of the ringbuffer, i.e. where the next item that is
+ * added with `e_rbuf_push` or `e_rbuf_commit` is stored.
+ */
+#define e_rbuf_head_ptr(rbuf) (&((E_TYPEOF ((rbuf)->type)) (rbuf)->data.ptr)[(rbuf)->data.head])
+
+/**
+ * Obtain a pointer to the item at the tail of the ringbuffer, i.e. the item that is removed next by
+ * `e_rbuf_pop` or `e_rbuf_consume`.
+ */
+#define e_rbuf_tail_ptr(rbuf) (&((E_TYPEOF ((rbuf)->type)) (rbuf)->data.ptr)[(rbuf)->data.tail])
+
+/**
+ * Reserve space for up to `count` items at the head of the ringbuffer, so that they can be written
+ * in place. A pointer to the first slot is returned, and the number of contiguous free slots that
+ * may be written (at most `count`) is stored in `*reserved` (of type `size_t`). The items are only
+ * added once they are committed with `e_rbuf_commit`.
+ *
+ * Unless the ringbuffer is mirrored, the reserved space ends at the end of the memory, so a second
+ * reservation may be needed after committing the first one.
+ */
+#define e_rbuf_reserve(rbuf, count, reserved)                                                      \
+    ((E_TYPEOF ((rbuf)->type)) e_rbuf__reserve (&(rbuf)->data, (count), (reserved),                \
+                                                sizeof (*(rbuf)->type)))
+
+/**
+ * Obtain up to `count` items at the tail of the ringbuffer, so that they can be read in place. A
+ * pointer to the first item is returned, and the number of contiguous items that may be read (at
+ * most `count`) is stored in `*peeked` (of type `size_t`). The items are only removed once they
+ * are consumed with `e_rbuf_consume`.
+ *
+ * Unless the ringbuffer is mirrored, the items end at the end of the memory, so a second peek may
+ * be needed after consuming the first items.
+ */
+#define e_rbuf_peek(rbuf, count, peeked)                                                           \
+    ((E_TYPEOF ((rbuf)->type)) e_rbuf__peek (&(rbuf)->data, (count), (peeked),                     \
+                                             sizeof (*(rbuf)->type)))
+
+/**
+ * Add `count` items that were written to the memory at the head of the ringbuffer (see
+ * `e_rbuf_reserve` and `e_rbuf_head_ptr`). `count` is limited to the number of free slots.
+ */
+#define e_rbuf_commit(rbuf, count) e_rbuf__commit (&(rbuf)->data, (count))
+
+/**
+ * Remove `count` items from the tail of the ringbuffer without copying them anywhere (see
+ * `e_rbuf_peek`). `count` is limited to the length of the ringbuffer.
+ */
+#define e_rbuf_consume(rbuf, count) e_rbuf__consume (&(rbuf)->data, (count))
+
+#if defined(E_CONFIG_RBUF_MIRROR) && defined(__linux__)
+/**
+ * Initialise a mirrored ringbuffer with space for at least `cap` items. The memory is allocated by
+ * mapping the same pages twice, so the capacity is rounded up to a multiple of the page size (see
+ * `e_rbuf_cap` for the actual capacity).
+ *
+ * On success, a non-zero (true) value is returned. If the memory could not be mapped, the
+ * ringbuffer is not initialised, and zero (false) is returned.
+ */
+# define e_rbuf_mirror_init(rbuf, cap)                                                             \
+     e_rbuf__mirror_init (&(rbuf)->data, (cap), sizeof (*(rbuf)->type))
+
+/**
+ * Unmap the memory of a ringbuffer that was initialised with `e_rbuf_mirror_init`.
+ */
+# define e_rbuf_mirror_deinit(rbuf) e_rbuf__mirror_deinit (&(rbuf)->data, sizeof (*(rbuf)->type))
+#endif /* defined(E_CONFIG_RBUF_MIRROR) && defined(__linux__) */
+
 typedef struct {
     void *ptr;
     size_t cap;
     size_t len;
     size_t head;
     size_t tail;
+    int mirrored; /* the memory after `ptr + cap` maps to `ptr` again */
 } E_Rbuf_Data;
 
 void e_rbuf__push (E_Rbuf_Data *rbuf, const void *item, size_t item_size);
 void e_rbuf__push_back (E_Rbuf_Data *rbuf, const void *item, size_t item_size);
 int e_rbuf__pop (E_Rbuf_Data *rbuf, void *out, size_t item_size);
 int e_rbuf__pop_front (E_Rbuf_Data *rbuf, void *out, size_t item_size);
+void *e_rbuf__reserve (E_Rbuf_Data *rbuf, size_t count, size_t *reserved, size_t item_size);
+void *e_rbuf__peek (E_Rbuf_Data *rbuf, size_t count, size_t *peeked, size_t item_size);
+void e_rbuf__commit (E_Rbuf_Data *rbuf, size_t count);
+void e_rbuf__consume (E_Rbuf_Data *rbuf, size_t count);
+#if defined(E_CONFIG_RBUF_MIRROR) && defined(__linux__)
+int e_rbuf__mirror_init (E_Rbuf_Data *rbuf, size_t cap, size_t item_size);
+void e_rbuf__mirror_deinit (E_Rbuf_Data *rbuf, size_t item_size);
+#endif /* defined(E_CONFIG_RBUF_MIRROR) && defined(__linux__) */
 
 /**************************************************************************************************/
 
 #ifdef E_RBUF_IMPL
 
+# ifndef E_CONFIG_FREESTANDING
+#  include <string.h>
+# endif
+# if defined(E_CONFIG_RBUF_MIRROR) && defined(__linux__)
+#  include <sys/mman.h>
+#  include <unistd.h>
+# endif
+
+void e_rbuf__copy (void *dst, const void *src, size_t item_size);
+
+/**
+ * Copy a single item. In freestanding environments, `memcpy` may not be available.
+ */
+void
+e_rbuf__copy (void *dst, const void *src, size_t item_size)
+{
+# ifdef E_CONFIG_FREESTANDING
+    unsigned char *dst_uchar = dst;
+    const unsigned char *src_uchar = src;
+    size_t i;
+
+    for (i = 0; i < item_size; i++) {
+        dst_uchar[i] = src_uchar[i];
+    }
+# else  /* E_CONFIG_FREESTANDING */
+    memcpy (dst, src, item_size);
+# endif /* E_CONFIG_FREESTANDING */
+}
+
 void
 e_rbuf__push (E_Rbuf_Data *rbuf, const void *item, size_t item_size)
 {
-    const unsigned char *item_uchar;
-    unsigned char *item_ptr;
     unsigned char *ptr;
-    size_t i;
 
     if (rbuf->len == rbuf->cap) {
         /* overwrite tail */
@@ -200,11 +341,7 @@ e_rbuf__push (E_Rbuf_Data *rbuf, const void *item, size_t item_size)
 
     /* copy item into buffer */
     ptr = rbuf->ptr;
-    item_ptr = &ptr[item_size * rbuf->head];
-    item_uchar = item;
-    for (i = 0; i < item_size; i++) {
-        item_ptr[i] = item_uchar[i];
-    }
+    e_rbuf__copy (&ptr[item_size * rbuf->head], item, item_size);
 
     /* advance head */
     rbuf->head = (rbuf->head + 1) % rbuf->cap;
@@ -213,10 +350,7 @@ e_rbuf__push (E_Rbuf_Data *rbuf, const void *item, size_t item_size)
 void
 e_rbuf__push_back (E_Rbuf_Data *rbuf, const void *item, size_t item_size)
 {
-    const unsigned char *item_uchar;
-    unsigned char *item_ptr;
     unsigned char *ptr;
-    size_t i;
 
     if (rbuf->len == rbuf->cap) {
         /* overwrite head */
@@ -230,31 +364,20 @@ e_rbuf__push_back (E_Rbuf_Data *rbuf, const void *item, size_t item_size)
 
     /* copy item into buffer */
     ptr = rbuf->ptr;
-    item_ptr = &ptr[item_size * rbuf->tail];
-    item_uchar = item;
-    for (i = 0; i < item_size; i++) {
-        item_ptr[i] = item_uchar[i];
-    }
+    e_rbuf__copy (&ptr[item_size * rbuf->tail], item, item_size);
 }
 
 int
 e_rbuf__pop (E_Rbuf_Data *rbuf, void *out, size_t item_size)
 {
-    unsigned char *out_uchar;
-    unsigned char *ptr_item;
     unsigned char *ptr;
-    size_t i;
 
     if (rbuf->len == 0) return 0;
 
     rbuf->len -= 1;
     if (out != NULL) {
         ptr = rbuf->ptr;
-        ptr_item = &ptr[item_size * rbuf->tail];
-        out_uchar = out;
-        for (i = 0; i < item_size; i++) {
-            out_uchar[i] = ptr_item[i];
-        }
+        e_rbuf__copy (out, &ptr[item_size * rbuf->tail], item_size);
     }
     rbuf->tail = (rbuf->tail + 1) % rbuf->cap;
     return 1;
@@ -263,10 +386,7 @@ e_rbuf__pop (E_Rbuf_Data *rbuf, void *out, size_t item_size)
 int
 e_rbuf__pop_front (E_Rbuf_Data *rbuf, void *out, size_t item_size)
 {
-    unsigned char *out_uchar;
-    unsigned char *ptr_item;
     unsigned char *ptr;
-    size_t i;
 
     if (rbuf->len == 0) return 0;
 
@@ -274,15 +394,111 @@ e_rbuf__pop_front (E_Rbuf_Data *rbuf, void *out, size_t item_size)
     rbuf->head = (rbuf->head + rbuf->cap - 1) % rbuf->cap;
     if (out != NULL) {
         ptr = rbuf->ptr;
-        ptr_item = &ptr[item_size * rbuf->head];
-        out_uchar = out;
-        for (i = 0; i < item_size; i++) {
-            out_uchar[i] = ptr_item[i];
-        }
+        e_rbuf__copy (out, &ptr[item_size * rbuf->head], item_size);
+    }
+    return 1;
+}
+
+void *
+e_rbuf__reserve (E_Rbuf_Data *rbuf, size_t count, size_t *reserved, size_t item_size)
+{
+    unsigned char *ptr;
+    size_t available;
+
+    available = rbuf->cap - rbuf->len;
+    if (!rbuf->mirrored && available > rbuf->cap - rbuf->head) available = rbuf->cap - rbuf->head;
+    *reserved = count < available ? count : available;
+    ptr = rbuf->ptr;
+    return &ptr[item_size * rbuf->head];
+}
+
+void *
+e_rbuf__peek (E_Rbuf_Data *rbuf, size_t count, size_t *peeked, size_t item_size)
+{
+    unsigned char *ptr;
+    size_t available;
+
+    available = rbuf->len;
+    if (!rbuf->mirrored && available > rbuf->cap - rbuf->tail) available = rbuf->cap - rbuf->tail;
+    *peeked = count < available ? count : available;
+    ptr = rbuf->ptr;
+    return &ptr[item_size * rbuf->tail];
+}
+
+void
+e_rbuf__commit (E_Rbuf_Data *rbuf, size_t count)
+{
+    if (count > rbuf->cap - rbuf->len) count = rbuf->cap - rbuf->len;
+    rbuf->len += count;
+    rbuf->head = (rbuf->head + count) % rbuf->cap;
+}
+
+void
+e_rbuf__consume (E_Rbuf_Data *rbuf, size_t count)
+{
+    if (count > rbuf->len) count = rbuf->len;
+    rbuf->len -= count;
+    rbuf->tail = (rbuf->tail + count) % rbuf->cap;
+}
+
+# if defined(E_CONFIG_RBUF_MIRROR) && defined(__linux__)
+
+int
+e_rbuf__mirror_init (E_Rbuf_Data *rbuf, size_t cap, size_t item_size)
+{
+    unsigned char *ptr;
+    size_t page_size, size;
+    long page_size_long;
+    int fd;
+
+    /* the size must be a multiple of both the page size and the item size */
+    page_size_long = sysconf (_SC_PAGESIZE);
+    page_size = page_size_long > 0 ? (size_t) page_size_long : 4096;
+    size = (cap * item_size + page_size - 1) / page_size * page_size;
+    if (size == 0) size = page_size;
+    while (size % item_size != 0) {
+        size += page_size;
+    }
+
+    fd = memfd_create ("e_rbuf", MFD_CLOEXEC);
+    if (fd < 0) return 0;
+    if (ftruncate (fd, (off_t) size) != 0) {
+        close (fd);
+        return 0;
+    }
+
+    /* reserve twice the address space, then map the file into both halves */
+    ptr = mmap (NULL, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED) {
+        close (fd);
+        return 0;
     }
+    if (mmap (ptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+        mmap (ptr + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) ==
+            MAP_FAILED) {
+        munmap (ptr, 2 * size);
+        close (fd);
+        return 0;
+    }
+    close (fd);
+
+    rbuf->ptr = ptr;
+    rbuf->cap = size / item_size;
+    rbuf->len = 0;
+    rbuf->head = 0;
+    rbuf->tail = 0;
+    rbuf->mirrored = 1;
     return 1;
 }
 
+void
+e_rbuf__mirror_deinit (E_Rbuf_Data *rbuf, size_t item_size)
+{
+    munmap (rbuf->ptr, 2 * rbuf->cap * item_size);
+}
+
+# endif /* defined(E_CONFIG_RBUF_MIRROR) && defined(__linux__) */
+
 #endif /* E_RBUF_IMPL */
 
 #endif /* E_RBUF_H_ */
@@ -10,6 +10,10 @@
  * String builders are dynamically allocated, resizable strings. The string is not null-terminated
  * (unless the user calls `e_sb_append_null()` before using the string).
  *
+ * By default, memory is allocated using `realloc` and `free`. A custom allocator (see `E_Allocator`
+ * in e_alloc.h) can be used by initialising the string builder with `e_sb_init_with_allocator()`.
+ * The allocator must outlive the string builder.
+ *
  * On allocation failure, an error message is printed and the programme is terminated.
  *
  * Configuration options:
@@ -19,6 +23,17 @@
 
 #include <stddef.h>
 
+/* allocator interface (see e_alloc.h): */
+#ifndef E_ALLOCATOR_DEFINED
+# define E_ALLOCATOR_DEFINED
+typedef struct {
+    void *(*alloc_fn) (void *ctx, size_t size);
+    void *(*realloc_fn) (void *ctx, void *ptr, size_t old_size, size_t new_size);
+    void (*free_fn) (void *ctx, void *ptr, size_t size);
+    void *ctx;
+} E_Allocator;
+#endif /* E_ALLOCATOR_DEFINED */
+
 /**
  * String builder.
  *
@@ -28,6 +43,7 @@ typedef struct {
     char *ptr;
     size_t len;
     size_t cap;
+    const E_Allocator *allocator;
 } E_Sb;
 
 /**
@@ -50,6 +66,7 @@ typedef struct {
 #define E_SB_ARG(sb) (int) (sb).len, (sb).ptr
 
 E_Sb e_sb_init (void);
+E_Sb e_sb_init_with_allocator (const E_Allocator *allocator);
 void e_sb_deinit (E_Sb *sb);
 void e_sb_append_char (E_Sb *sb, char c);
 void e_sb_append_buf (E_Sb *sb, const char *ptr, size_t len);
@@ -95,6 +112,22 @@ e_sb_init (void)
     sb.ptr = NULL;
     sb.len = 0;
     sb.cap = 0;
+    sb.allocator = NULL;
+    return sb;
+}
+
+/**
+ * Initialise a new string builder that obtains its memory from `allocator`. Passing `NULL` is
+ * equivalent to `e_sb_init()`.
+ *
+ * No memory is allocated yet.
+ */
+E_Sb
+e_sb_init_with_allocator (const E_Allocator *allocator)
+{
+    E_Sb sb;
+    sb = e_sb_init ();
+    sb.allocator = allocator;
     return sb;
 }
 
@@ -104,7 +137,11 @@ e_sb_init (void)
 void
 e_sb_deinit (E_Sb *sb)
 {
-    free (sb->ptr);
+    if (sb->allocator == NULL) {
+        free (sb->ptr);
+    } else if (sb->ptr != NULL) {
+        sb->allocator->free_fn (sb->allocator->ctx, sb->ptr, sb->cap * sizeof (char));
+    }
 }
 
 /**
@@ -203,12 +240,23 @@ e_sb_append_sv (E_Sb *sb, E_Sv sv)
 void
 e_sb__reserve (E_Sb *sb, size_t cap)
 {
+    size_t old_cap;
     char *ptr;
+
     if (cap <= sb->cap) return;
+    old_cap = sb->cap;
     if (sb->cap == 0) sb->cap = E_SB__INIT_CAP;
     while (sb->cap < cap)
         sb->cap *= 2;
-    ptr = realloc (sb->ptr, sb->cap * sizeof (char));
+
+    if (sb->allocator == NULL) {
+        ptr = realloc (sb->ptr, sb->cap * sizeof (char));
+    } else if (sb->ptr == NULL) {
+        ptr = sb->allocator->alloc_fn (sb->allocator->ctx, sb->cap * sizeof (char));
+    } else {
+        ptr = sb->allocator->realloc_fn (sb->allocator->ctx, sb->ptr, old_cap * sizeof (char),
+                                         sb->cap * sizeof (char));
+    }
     if (ptr == NULL) {
         fprintf (stderr, "[e_sb] allocation failed\n");
         abort ();
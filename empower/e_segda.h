@@ -0,0 +1,382 @@
+#ifndef E_SEGDA_H_
+#define E_SEGDA_H_
+
+/**************************************************************************************************
+ *
+ * Empower / e_segda.h - Public Domain - https://git.tjdev.de/thetek/empower
+ *
+ * This module implements segmented dynamic arrays for generic types.
+ *
+ * Unlike `E_Da`, a segmented dynamic array never moves its items: the storage consists of segments
+ * of exponentially increasing size, and a new segment is added when the existing ones are full.
+ * Pointers to items therefore stay valid until the items are popped or the array is deinitialised,
+ * and growing the array never copies the existing items. Indexing is still O(1), as the segment
+ * that contains an index can be computed with a single bit scan.
+ *
+ * It can be used as follows:
+ *
+ * ```
+ * E_Segda (int) int_list = e_segda_init ();
+ * e_segda_push (&int_list, 1);
+ * int *first = e_segda_nth (&int_list, 0);
+ * e_segda_push (&int_list, 2); // `first` is still valid
+ * e_segda_deinit (&int_list);
+ * ```
+ *
+ * In the case where the segmented dynamic array definition has to be reused for multiple variables
+ * and those variables have to have a compatible type, a `typedef` can be used:
+ *
+ * ```
+ * typedef E_Segda (int) Int_List;
+ * Int_List first_list;
+ * Int_List second_list;
+ * ```
+ *
+ * The first segment holds `E_SEGDA__BASE` items and every following segment is twice as large as
+ * the previous one. Segment `k` thus starts at index `E_SEGDA__BASE * (2^k - 1)`.
+ *
+ * By default, memory is allocated using `realloc` and `free`. A custom allocator (see `E_Allocator`
+ * in e_alloc.h) can be used by initialising the array with `e_segda_init_with_allocator`.
+ *
+ * On allocation failure, an error message is printed and the programme is aborted.
+ *
+ * Configuration options:
+ *  - `E_CONFIG_SEGDA_BASE_SHIFT`: Base-2 logarithm of the number of items in the first segment
+ *    (default: 4, i.e. 16 items).
+ *
+ **************************************************************************************************/
+
+#include <stddef.h>
+
+/* compatibility annoyances: */
+#ifndef E_TYPEOF
+# if __STDC_VERSION__ >= 202311L
+#  define E_TYPEOF(x) typeof (x)
+# else
+#  define E_TYPEOF(x) __typeof__ (x)
+# endif
+#endif /* E_TYPEOF */
+
+/* allocator interface (see e_alloc.h): */
+#ifndef E_ALLOCATOR_DEFINED
+# define E_ALLOCATOR_DEFINED
+typedef struct {
+    void *(*alloc_fn) (void *ctx, size_t size);
+    void *(*realloc_fn) (void *ctx, void *ptr, size_t old_size, size_t new_size);
+    void (*free_fn) (void *ctx, void *ptr, size_t size);
+    void *ctx;
+} E_Allocator;
+#endif /* E_ALLOCATOR_DEFINED */
+
+#ifdef E_CONFIG_SEGDA_BASE_SHIFT
+# define E_SEGDA__BASE_SHIFT E_CONFIG_SEGDA_BASE_SHIFT
+#else
+# define E_SEGDA__BASE_SHIFT 4
+#endif
+#define E_SEGDA__BASE ((size_t) 1 << E_SEGDA__BASE_SHIFT)
+
+/**
+ * Generic segmented dynamic array
+ */
+#define E_Segda(T)                                                                                 \
+    union {                                                                                        \
+        E_Segda_Data data;                                                                         \
+        T *type; /* NOLINT */                                                                      \
+    }
+
+/**
+ * Initialise a new segmented dynamic array.
+ *
+ * No memory is allocated yet.
+ */
+#define e_segda_init() {0}
+
+/**
+ * Initialise a new segmented dynamic array that obtains its memory from `allocator` (of type
+ * `const E_Allocator *`). Passing `NULL` is equivalent to `e_segda_init()`.
+ *
+ * In C89, initialisers must be constant, so you may have to set `data.allocator` manually instead.
+ */
+#define e_segda_init_with_allocator(allocator) {{NULL, 0, 0, (allocator)}}
+
+/**
+ * Free the memory occupied by the segmented dynamic array.
+ */
+#define e_segda_deinit(da) e_segda__deinit (&(da)->data, sizeof (*(da)->type))
+
+/**
+ * Obtain the length (i.e. the number of contained items) of the segmented dynamic array.
+ */
+#define e_segda_len(da) (da)->data.len
+
+/**
+ * Obtain a pointer to the nth item of the segmented dynamic array.
+ *
+ * This does not perform any bounds checks.
+ */
+#define e_segda_nth(da, n)                                                                         \
+    ((E_TYPEOF ((da)->type)) e_segda__nth (&(da)->data, (n), sizeof (*(da)->type)))
+
+/**
+ * Obtain a pointer to the last item of the segmented dynamic array.
+ *
+ * This does not perform any bounds checks.
+ */
+#define e_segda_last(da) e_segda_nth ((da), (da)->data.len - 1)
+
+/**
+ * Append a single item to the end of a segmented dynamic array.
+ */
+#define e_segda_push(da, item)                                                                     \
+    do {                                                                                           \
+        E_TYPEOF (*(da)->type) e_segda__item = (item);                                             \
+        e_segda_extend ((da), &e_segda__item, 1);                                                  \
+    } while (0)
+
+/**
+ * Append a single item to the end of a segmented dynamic array (but the item is a pointer).
+ */
+#define e_segda_push_ref(da, item_ref) e_segda_extend ((da), (1 ? (item_ref) : (da)->type), 1)
+
+/**
+ * Make room for an additional item in the segmented dynamic array, but don’t initialize that
+ * item. The pointer to the new item is returned, so that you can fill it as you please. The length
+ * of the array is adjusted, so not filling in the new memory will cause UB.
+ */
+#define e_segda_push_uninit(da)                                                                    \
+    ((E_TYPEOF ((da)->type)) e_segda__push_uninit (&(da)->data, sizeof (*(da)->type)))
+
+/**
+ * Extend the segmented dynamic array by multiple items.
+ */
+#define e_segda_extend(da, items, count)                                                           \
+    e_segda__extend (&(da)->data, (1 ? (items) : (da)->type), (count), sizeof (*(da)->type))
+
+/**
+ * Remove a certain number of items from the end of the segmented dynamic array.
+ *
+ * The memory of the segments is kept, so that it can be reused by subsequent pushes.
+ */
+#define e_segda_pop(da, count) e_segda__pop (&(da)->data, (count))
+
+/**
+ * Iterate over the segmented dynamic array.
+ *
+ * This macro can be used as follows:
+ *
+ * ```
+ * E_Segda (int) int_list = e_segda_init ();
+ * // ...
+ * e_segda_foreach (&int_list, it) {
+ *     printf ("%d\n", *it);
+ * }
+ * ```
+ *
+ * Within a segment, advancing the iterator is a plain pointer increment. `break` and `continue`
+ * behave as expected.
+ */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+# define e_segda_foreach(da, it)                                                                   \
+     for (size_t e_segda__i = 0; e_segda__i == 0; e_segda__i = (size_t) -1)                        \
+         for (E_TYPEOF ((da)->type) (it) = e_segda__segment_at (&(da)->data, 0);                   \
+              e_segda__i < (da)->data.len;                                                         \
+              e_segda__i += 1,                                                                     \
+                   (it) = ((e_segda__i + E_SEGDA__BASE) & (e_segda__i + E_SEGDA__BASE - 1))        \
+                              ? (it) + 1                                                           \
+                              : e_segda__segment_at (&(da)->data, e_segda__i))
+#endif
+
+typedef struct {
+    void **segments;
+    size_t segment_count;
+    size_t len;
+    const E_Allocator *allocator;
+} E_Segda_Data;
+
+void e_segda__deinit (E_Segda_Data *da, size_t item_size);
+void *e_segda__nth (const E_Segda_Data *da, size_t n, size_t item_size);
+void *e_segda__segment_at (const E_Segda_Data *da, size_t n);
+void e_segda__extend (E_Segda_Data *da, const void *data, size_t count, size_t item_size);
+void *e_segda__push_uninit (E_Segda_Data *da, size_t item_size);
+void e_segda__pop (E_Segda_Data *da, size_t count);
+
+/**************************************************************************************************/
+
+#ifdef E_SEGDA_IMPL
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# if defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+# endif
+
+size_t e_segda__msb (size_t x);
+size_t e_segda__segment_cap (size_t k);
+void e_segda__add_segment (E_Segda_Data *da, size_t item_size);
+void *e_segda__mem_realloc (const E_Allocator *allocator, void *ptr, size_t old_size, size_t size);
+void e_segda__mem_free (const E_Allocator *allocator, void *ptr, size_t size);
+
+/**
+ * Index of the most significant set bit of `x`, which must not be 0.
+ */
+size_t
+e_segda__msb (size_t x)
+{
+# if (defined(__GNUC__) || defined(__clang__)) && defined(__STDC_VERSION__) &&                     \
+     __STDC_VERSION__ >= 199901L
+    return (sizeof (unsigned long long) * 8 - 1) - (size_t) __builtin_clzll (x);
+# elif (defined(__GNUC__) || defined(__clang__)) && __SIZEOF_SIZE_T__ == __SIZEOF_LONG__
+    return (sizeof (unsigned long) * 8 - 1) - (size_t) __builtin_clzl (x);
+# elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanReverse64 (&index, x);
+    return index;
+# else
+    size_t r = 0;
+    while (x >>= 1)
+        r += 1;
+    return r;
+# endif
+}
+
+/**
+ * Number of items in segment `k`.
+ */
+size_t
+e_segda__segment_cap (size_t k)
+{
+    return E_SEGDA__BASE << k;
+}
+
+void *
+e_segda__mem_realloc (const E_Allocator *allocator, void *ptr, size_t old_size, size_t size)
+{
+    void *new_ptr;
+
+    if (allocator == NULL) {
+        new_ptr = realloc (ptr, size);
+    } else if (ptr == NULL) {
+        new_ptr = allocator->alloc_fn (allocator->ctx, size);
+    } else {
+        new_ptr = allocator->realloc_fn (allocator->ctx, ptr, old_size, size);
+    }
+    if (new_ptr == NULL) {
+        fprintf (stderr, "[e_segda] allocation failed!\n");
+        abort ();
+    }
+    return new_ptr;
+}
+
+void
+e_segda__mem_free (const E_Allocator *allocator, void *ptr, size_t size)
+{
+    if (allocator == NULL) {
+        free (ptr);
+    } else if (ptr != NULL) {
+        allocator->free_fn (allocator->ctx, ptr, size);
+    }
+}
+
+void
+e_segda__deinit (E_Segda_Data *da, size_t item_size)
+{
+    size_t k;
+
+    for (k = 0; k < da->segment_count; k++) {
+        e_segda__mem_free (da->allocator, da->segments[k], e_segda__segment_cap (k) * item_size);
+    }
+    e_segda__mem_free (da->allocator, da->segments, da->segment_count * sizeof (void *));
+}
+
+void *
+e_segda__nth (const E_Segda_Data *da, size_t n, size_t item_size)
+{
+    unsigned char *segment;
+    size_t msb;
+
+    n += E_SEGDA__BASE;
+    msb = e_segda__msb (n);
+    segment = da->segments[msb - E_SEGDA__BASE_SHIFT];
+    return &segment[(n - ((size_t) 1 << msb)) * item_size];
+}
+
+/**
+ * Obtain the start of the segment that begins at index `n`, or `NULL` if `n` is out of range.
+ */
+void *
+e_segda__segment_at (const E_Segda_Data *da, size_t n)
+{
+    if (n >= da->len) return NULL;
+    return da->segments[e_segda__msb (n + E_SEGDA__BASE) - E_SEGDA__BASE_SHIFT];
+}
+
+/* gcc's analyzer loses track of the new segment once its pointer is stored into the reallocated
+ * table, and reports it as leaked */
+# if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 10
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wanalyzer-malloc-leak"
+# endif
+void
+e_segda__add_segment (E_Segda_Data *da, size_t item_size)
+{
+    size_t k;
+
+    k = da->segment_count;
+    da->segments = e_segda__mem_realloc (da->allocator, da->segments, k * sizeof (void *),
+                                         (k + 1) * sizeof (void *));
+    da->segments[k] =
+        e_segda__mem_realloc (da->allocator, NULL, 0, e_segda__segment_cap (k) * item_size);
+    da->segment_count = k + 1;
+}
+
+# if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 10
+#  pragma GCC diagnostic pop
+# endif
+
+void
+e_segda__extend (E_Segda_Data *da, const void *data, size_t count, size_t item_size)
+{
+    const unsigned char *src = data;
+    unsigned char *segment;
+    size_t n, k, offset, run;
+
+    while (count > 0) {
+        n = da->len + E_SEGDA__BASE;
+        k = e_segda__msb (n) - E_SEGDA__BASE_SHIFT;
+        if (k >= da->segment_count) e_segda__add_segment (da, item_size);
+
+        /* copy as many items as fit into the current segment */
+        offset = n - ((size_t) 1 << (k + E_SEGDA__BASE_SHIFT));
+        run = e_segda__segment_cap (k) - offset;
+        if (run > count) run = count;
+        segment = da->segments[k];
+        memcpy (&segment[offset * item_size], src, run * item_size);
+
+        src += run * item_size;
+        da->len += run;
+        count -= run;
+    }
+}
+
+void *
+e_segda__push_uninit (E_Segda_Data *da, size_t item_size)
+{
+    size_t k;
+
+    k = e_segda__msb (da->len + E_SEGDA__BASE) - E_SEGDA__BASE_SHIFT;
+    if (k >= da->segment_count) e_segda__add_segment (da, item_size);
+    da->len += 1;
+    return e_segda__nth (da, da->len - 1, item_size);
+}
+
+void
+e_segda__pop (E_Segda_Data *da, size_t count)
+{
+    if (count > da->len) count = da->len;
+    da->len -= count;
+}
+
+#endif /* E_SEGDA_IMPL */
+
+#endif /* E_SEGDA_H_ */
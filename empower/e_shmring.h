@@ -0,0 +1,628 @@
+#ifndef E_SHMRING_H_
+#define E_SHMRING_H_
+
+/**************************************************************************************************
+ *
+ * Empower / e_shmring.h - Public Domain - https://git.tjdev.de/thetek/empower
+ *
+ * This module implements single-producer/single-consumer ringbuffers for generic types that live
+ * in shared memory, so that two processes on the same host can exchange items without pipes or
+ * sockets.
+ *
+ * The shared memory segment starts with a header that holds the capacity, the item size, and the
+ * atomic head and tail indices, followed by the items. In steady state, pushing and popping items
+ * only touches the shared memory and does not perform any system calls. Only when a process has to
+ * wait because the ringbuffer is empty or full, it sleeps on a futex and is woken up by the other
+ * process.
+ *
+ * The producer creates the ringbuffer, and the consumer opens it by its name:
+ *
+ * ```
+ * // in the producer process:
+ * E_Shmring (Sample) ring;
+ * e_shmring_create (&ring, "/telemetry", 4096);
+ * e_shmring_push_wait (&ring, sample);
+ * // in the consumer process:
+ * E_Shmring (Sample) ring;
+ * e_shmring_open (&ring, "/telemetry");
+ * Sample sample;
+ * e_shmring_pop_wait (&ring, &sample);
+ * // in both processes:
+ * e_shmring_close (&ring);
+ * // once it is not needed anymore:
+ * e_shmring_unlink ("/telemetry");
+ * ```
+ *
+ * When `NULL` is passed as the name, an anonymous segment is created with `memfd_create`. It can
+ * be shared with a child process through `fork`, or sent to another process as a file descriptor
+ * (see `e_shmring_fd`) that is opened with `e_shmring_open_fd`.
+ *
+ * Like with `E_Rbuf`, items can be written and read in place with `e_shmring_reserve` and
+ * `e_shmring_commit`, and `e_shmring_peek` and `e_shmring_consume`, so that they are not copied
+ * at all.
+ *
+ * The capacity must be a power of two between 2 and 2^31. Both processes must use the same item
+ * type and must run on the same architecture.
+ *
+ * This module requires C11 atomics and Linux. `_GNU_SOURCE` must be defined before any system
+ * header is included.
+ *
+ **************************************************************************************************/
+
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 201112L || defined(__STDC_NO_ATOMICS__)
+# error e_shmring requires C11 or newer with atomics
+#endif
+#ifndef __linux__
+# error e_shmring requires Linux
+#endif
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* compatibility annoyances: */
+#ifndef E_TYPEOF
+# if __STDC_VERSION__ >= 202311L
+#  define E_TYPEOF(x) typeof (x)
+# else
+#  define E_TYPEOF(x) __typeof__ (x)
+# endif
+#endif /* E_TYPEOF */
+
+#define E_SHMRING__CACHE_LINE 64
+
+/**
+ * Generic shared memory ringbuffer
+ */
+#define E_Shmring(T)                                                                               \
+    union {                                                                                        \
+        E_Shmring_Data data;                                                                       \
+        T *type; /* NOLINT */                                                                      \
+    }
+
+/**
+ * Create a shared memory segment with space for `cap` items and map it. If `name` is not `NULL`,
+ * the segment is created with `shm_open` and can be opened by other processes with
+ * `e_shmring_open`; it must not exist yet. Otherwise, an anonymous segment is created.
+ *
+ * On success, a non-zero (true) value is returned. If `cap` is not a power of two between 2 and
+ * 2^31, or if the segment could not be created, zero (false) is returned and the ringbuffer is left
+ * without a segment (its file descriptor is -1).
+ */
+#define e_shmring_create(shmring, name, cap)                                                       \
+    e_shmring__create (&(shmring)->data, (name), (cap), sizeof (*(shmring)->type))
+
+/**
+ * Open and map a shared memory segment that was created by another process with
+ * `e_shmring_create`.
+ *
+ * On success, a non-zero (true) value is returned. If the segment could not be opened, or if it
+ * does not contain a ringbuffer for items of the same size, zero (false) is returned and the
+ * ringbuffer is left without a segment (its file descriptor is -1).
+ */
+#define e_shmring_open(shmring, name)                                                              \
+    e_shmring__open (&(shmring)->data, (name), sizeof (*(shmring)->type))
+
+/**
+ * Like `e_shmring_open`, but map the segment that is referred to by the file descriptor `fd`
+ * instead. On success, the ringbuffer takes ownership of `fd`.
+ */
+#define e_shmring_open_fd(shmring, fd)                                                             \
+    e_shmring__open_fd (&(shmring)->data, (fd), sizeof (*(shmring)->type))
+
+/**
+ * Unmap the shared memory segment and close its file descriptor. The segment itself is only
+ * removed once it has been unlinked (see `e_shmring_unlink`) and all processes have closed it.
+ */
+#define e_shmring_close(shmring) e_shmring__close (&(shmring)->data)
+
+/**
+ * Obtain the file descriptor of the shared memory segment.
+ */
+#define e_shmring_fd(shmring) (shmring)->data.fd
+
+/**
+ * Obtain the capacity (i.e. the maximum number of items that can be added) of the ringbuffer.
+ */
+#define e_shmring_cap(shmring) ((size_t) (shmring)->data.mask + 1)
+
+/**
+ * Obtain the number of items in the ringbuffer. When called while the other process is active, the
+ * result may already be outdated when it is returned.
+ */
+#define e_shmring_len(shmring) e_shmring__len (&(shmring)->data)
+
+/**
+ * Try to add an item to the ringbuffer. Must only be called by the producer.
+ *
+ * If the ringbuffer is full, nothing is added and zero (false) is returned. Otherwise, a non-zero
+ * (true) value is returned.
+ */
+#define e_shmring_push(shmring, item)                                                              \
+    e_shmring__push (&(shmring)->data, (E_TYPEOF (*(shmring)->type)[1]) {(item)},                  \
+                     sizeof (*(shmring)->type))
+
+/**
+ * Try to add an item to the ringbuffer (but the item is a pointer). Must only be called by the
+ * producer.
+ *
+ * If the ringbuffer is full, nothing is added and zero (false) is returned. Otherwise, a non-zero
+ * (true) value is returned.
+ */
+#define e_shmring_push_ref(shmring, item_ptr)                                                      \
+    e_shmring__push (&(shmring)->data, (1 ? (item_ptr) : (shmring)->type),                         \
+                     sizeof (*(shmring)->type))
+
+/**
+ * Add an item to the ringbuffer, sleeping until the consumer makes space if it is full. Must only
+ * be called by the producer.
+ */
+#define e_shmring_push_wait(shmring, item)                                                         \
+    e_shmring__push_wait (&(shmring)->data, (E_TYPEOF (*(shmring)->type)[1]) {(item)},             \
+                          sizeof (*(shmring)->type))
+
+/**
+ * Try to pop an item from the ringbuffer. Must only be called by the consumer.
+ *
+ * If the ringbuffer is not empty, the item will be removed and written to `out`, and a non-zero
+ * (true) value will be returned. If the ringbuffer is empty, no action will be performed, and
+ * zero (false) will be returned.
+ *
+ * If the `out` parameter is `NULL`, nothing will be written to it, but the item will still be
+ * popped and `true` or `false` will be returned.
+ */
+#define e_shmring_pop(shmring, out)                                                                \
+    e_shmring__pop (&(shmring)->data, (1 ? (out) : (shmring)->type), sizeof (*(shmring)->type))
+
+/**
+ * Pop an item from the ringbuffer and write it to `out`, sleeping until the producer adds an item
+ * if it is empty. If the `out` parameter is `NULL`, nothing will be written to it. Must only be
+ * called by the consumer.
+ */
+#define e_shmring_pop_wait(shmring, out)                                                           \
+    e_shmring__pop_wait (&(shmring)->data, (1 ? (out) : (shmring)->type),                          \
+                         sizeof (*(shmring)->type))
+
+/**
+ * Reserve space for up to `count` items, so that they can be written in place. A pointer to the
+ * first slot is returned, and the number of contiguous free slots that may be written (at most
+ * `count`) is stored in `*reserved` (of type `size_t`). The items are only added once they are
+ * committed with `e_shmring_commit`. Must only be called by the producer.
+ *
+ * The reserved space ends at the end of the memory, so a second reservation may be needed after
+ * committing the first one.
+ */
+#define e_shmring_reserve(shmring, count, reserved)                                                \
+    ((E_TYPEOF ((shmring)->type)) e_shmring__reserve (&(shmring)->data, (count), (reserved),       \
+                                                      sizeof (*(shmring)->type)))
+
+/**
+ * Add `count` items that were written to the space returned by `e_shmring_reserve`, and wake up
+ * the consumer if it is waiting. `count` must not exceed the number of reserved items. Must only
+ * be called by the producer.
+ */
+#define e_shmring_commit(shmring, count) e_shmring__commit (&(shmring)->data, (count))
+
+/**
+ * Obtain up to `count` items, so that they can be read in place. A pointer to the first item is
+ * returned, and the number of contiguous items that may be read (at most `count`) is stored in
+ * `*peeked` (of type `size_t`). The items are only removed once they are consumed with
+ * `e_shmring_consume`. Must only be called by the consumer.
+ *
+ * The items end at the end of the memory, so a second peek may be needed after consuming the
+ * first items.
+ */
+#define e_shmring_peek(shmring, count, peeked)                                                     \
+    ((const E_TYPEOF (*(shmring)->type) *) e_shmring__peek (&(shmring)->data, (count), (peeked),   \
+                                                            sizeof (*(shmring)->type)))
+
+/**
+ * Remove `count` items that were read from the space returned by `e_shmring_peek`, and wake up the
+ * producer if it is waiting. `count` must not exceed the number of peeked items. Must only be
+ * called by the consumer.
+ */
+#define e_shmring_consume(shmring, count) e_shmring__consume (&(shmring)->data, (count))
+
+/**
+ * Header at the start of the shared memory segment
+ */
+typedef struct {
+    /* written once by the creator */
+    _Atomic (uint32_t) magic;
+    uint32_t cap;
+    uint64_t item_size;
+    unsigned char pad0_[E_SHMRING__CACHE_LINE - 2 * sizeof (uint32_t) - sizeof (uint64_t)];
+    /* written by the producer */
+    _Atomic (uint32_t) head;
+    _Atomic (uint32_t) producer_waiting;
+    unsigned char pad1_[E_SHMRING__CACHE_LINE - 2 * sizeof (uint32_t)];
+    /* written by the consumer */
+    _Atomic (uint32_t) tail;
+    _Atomic (uint32_t) consumer_waiting;
+    unsigned char pad2_[E_SHMRING__CACHE_LINE - 2 * sizeof (uint32_t)];
+} E_Shmring_Header;
+
+typedef struct {
+    E_Shmring_Header *header;
+    unsigned char *items;
+    size_t size; /* size of the mapping */
+    uint32_t mask;
+    uint32_t cached_head; /* last head seen by the consumer */
+    uint32_t cached_tail; /* last tail seen by the producer */
+    int fd;
+} E_Shmring_Data;
+
+int e_shmring__create (E_Shmring_Data *shmring, const char *name, size_t cap, size_t item_size);
+int e_shmring__open (E_Shmring_Data *shmring, const char *name, size_t item_size);
+int e_shmring__open_fd (E_Shmring_Data *shmring, int fd, size_t item_size);
+void e_shmring__close (E_Shmring_Data *shmring);
+size_t e_shmring__len (E_Shmring_Data *shmring);
+int e_shmring__push (E_Shmring_Data *shmring, const void *item, size_t item_size);
+void e_shmring__push_wait (E_Shmring_Data *shmring, const void *item, size_t item_size);
+int e_shmring__pop (E_Shmring_Data *shmring, void *out, size_t item_size);
+void e_shmring__pop_wait (E_Shmring_Data *shmring, void *out, size_t item_size);
+void *e_shmring__reserve (E_Shmring_Data *shmring, size_t count, size_t *reserved,
+                          size_t item_size);
+void e_shmring__commit (E_Shmring_Data *shmring, size_t count);
+const void *e_shmring__peek (E_Shmring_Data *shmring, size_t count, size_t *peeked,
+                             size_t item_size);
+void e_shmring__consume (E_Shmring_Data *shmring, size_t count);
+
+/**
+ * Remove the shared memory segment called `name`. Processes that have opened it can continue to use
+ * it until they close it. On success, a non-zero (true) value is returned.
+ */
+int e_shmring_unlink (const char *name);
+
+/**************************************************************************************************/
+
+#ifdef E_SHMRING_IMPL
+
+# include <fcntl.h>
+# include <linux/futex.h>
+# include <string.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+
+# define E_SHMRING__MAGIC      0x52485345u /* "ESHR" */
+# define E_SHMRING__SPIN_LIMIT 64
+
+void e_shmring__reset (E_Shmring_Data *shmring);
+int e_shmring__valid_cap (size_t cap);
+int e_shmring__map (E_Shmring_Data *shmring, int fd, size_t size);
+void e_shmring__futex_wait (_Atomic (uint32_t) *word, uint32_t value);
+void e_shmring__futex_wake (_Atomic (uint32_t) *word);
+void e_shmring__spin (unsigned int *spins);
+
+/**
+ * Put the handle into the state of a ringbuffer without a segment, so that it is defined even when
+ * creating or opening the segment fails.
+ */
+void
+e_shmring__reset (E_Shmring_Data *shmring)
+{
+    shmring->header = NULL;
+    shmring->items = NULL;
+    shmring->size = 0;
+    shmring->mask = 0;
+    shmring->cached_head = 0;
+    shmring->cached_tail = 0;
+    shmring->fd = -1;
+}
+
+/**
+ * Check that `cap` is a power of two between 2 and 2^31.
+ */
+int
+e_shmring__valid_cap (size_t cap)
+{
+    return cap >= 2 && cap <= ((size_t) 1 << 31) && (cap & (cap - 1)) == 0;
+}
+
+/**
+ * Map `size` bytes of the segment referred to by `fd`.
+ */
+int
+e_shmring__map (E_Shmring_Data *shmring, int fd, size_t size)
+{
+    void *ptr;
+
+    ptr = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) return 0;
+    shmring->header = ptr;
+    shmring->items = (unsigned char *) ptr + sizeof (E_Shmring_Header);
+    shmring->size = size;
+    shmring->fd = fd;
+    return 1;
+}
+
+/**
+ * Sleep until `word` is woken up, unless it no longer contains `value`. The futex is not private
+ * to the process, since the other process wakes it up.
+ */
+void
+e_shmring__futex_wait (_Atomic (uint32_t) *word, uint32_t value)
+{
+    syscall (SYS_futex, (void *) word, FUTEX_WAIT, value, NULL, NULL, 0);
+}
+
+void
+e_shmring__futex_wake (_Atomic (uint32_t) *word)
+{
+    syscall (SYS_futex, (void *) word, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+/**
+ * Spin for a little while before going to sleep, since the other process is likely to make
+ * progress soon.
+ */
+void
+e_shmring__spin (unsigned int *spins)
+{
+    *spins += 1;
+# if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_ia32_pause ();
+# elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+    __asm__ volatile ("yield");
+# endif
+}
+
+int
+e_shmring__create (E_Shmring_Data *shmring, const char *name, size_t cap, size_t item_size)
+{
+    E_Shmring_Header *header;
+    size_t size;
+    int fd;
+
+    e_shmring__reset (shmring);
+    if (!e_shmring__valid_cap (cap)) return 0;
+    size = sizeof (E_Shmring_Header) + cap * item_size;
+
+    if (name != NULL) {
+        fd = shm_open (name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    } else {
+        fd = memfd_create ("e_shmring", MFD_CLOEXEC);
+    }
+    if (fd < 0) return 0;
+    if (ftruncate (fd, (off_t) size) != 0 || !e_shmring__map (shmring, fd, size)) {
+        close (fd);
+        if (name != NULL) shm_unlink (name);
+        e_shmring__reset (shmring);
+        return 0;
+    }
+
+    /* the magic number is stored last, so that the header is complete once it can be opened */
+    header = shmring->header;
+    header->cap = (uint32_t) cap;
+    header->item_size = item_size;
+    atomic_init (&header->head, 0);
+    atomic_init (&header->producer_waiting, 0);
+    atomic_init (&header->tail, 0);
+    atomic_init (&header->consumer_waiting, 0);
+    atomic_store_explicit (&header->magic, E_SHMRING__MAGIC, memory_order_release);
+
+    shmring->mask = (uint32_t) cap - 1;
+    shmring->cached_head = 0;
+    shmring->cached_tail = 0;
+    return 1;
+}
+
+int
+e_shmring__open (E_Shmring_Data *shmring, const char *name, size_t item_size)
+{
+    int fd;
+
+    fd = shm_open (name, O_RDWR, 0);
+    if (fd < 0) return 0;
+    if (!e_shmring__open_fd (shmring, fd, item_size)) {
+        close (fd);
+        return 0;
+    }
+    return 1;
+}
+
+int
+e_shmring__open_fd (E_Shmring_Data *shmring, int fd, size_t item_size)
+{
+    E_Shmring_Header *header;
+    struct stat st;
+    size_t size;
+
+    e_shmring__reset (shmring);
+    if (fstat (fd, &st) != 0 || st.st_size < (off_t) sizeof (E_Shmring_Header)) return 0;
+    size = (size_t) st.st_size;
+    if (!e_shmring__map (shmring, fd, size)) return 0;
+
+    /* the header was written by another process, so it is checked like the arguments of
+     * `e_shmring__create` before it is used */
+    header = shmring->header;
+    if (atomic_load_explicit (&header->magic, memory_order_acquire) != E_SHMRING__MAGIC ||
+        header->item_size != item_size || !e_shmring__valid_cap (header->cap) ||
+        sizeof (E_Shmring_Header) + (size_t) header->cap * item_size > size) {
+        munmap (shmring->header, size);
+        e_shmring__reset (shmring);
+        return 0;
+    }
+
+    shmring->mask = header->cap - 1;
+    shmring->cached_head = atomic_load_explicit (&header->head, memory_order_acquire);
+    shmring->cached_tail = atomic_load_explicit (&header->tail, memory_order_acquire);
+    return 1;
+}
+
+void
+e_shmring__close (E_Shmring_Data *shmring)
+{
+    munmap (shmring->header, shmring->size);
+    close (shmring->fd);
+}
+
+int
+e_shmring_unlink (const char *name)
+{
+    return shm_unlink (name) == 0;
+}
+
+size_t
+e_shmring__len (E_Shmring_Data *shmring)
+{
+    uint32_t head, tail;
+
+    tail = atomic_load_explicit (&shmring->header->tail, memory_order_acquire);
+    head = atomic_load_explicit (&shmring->header->head, memory_order_acquire);
+    return (uint32_t) (head - tail);
+}
+
+void *
+e_shmring__reserve (E_Shmring_Data *shmring, size_t count, size_t *reserved, size_t item_size)
+{
+    E_Shmring_Header *header = shmring->header;
+    uint32_t head, len, space, until_end;
+
+    /* the cached tail may be outdated (or even a full round behind, if this handle was used by the
+     * consumer before) */
+    head = atomic_load_explicit (&header->head, memory_order_relaxed);
+    len = (uint32_t) (head - shmring->cached_tail);
+    if (len > shmring->mask + 1 || shmring->mask + 1 - len < count) {
+        shmring->cached_tail = atomic_load_explicit (&header->tail, memory_order_acquire);
+        len = (uint32_t) (head - shmring->cached_tail);
+    }
+    space = shmring->mask + 1 - len;
+    until_end = shmring->mask + 1 - (head & shmring->mask);
+    if (space > until_end) space = until_end;
+
+    *reserved = count < space ? count : space;
+    return &shmring->items[(head & shmring->mask) * item_size];
+}
+
+void
+e_shmring__commit (E_Shmring_Data *shmring, size_t count)
+{
+    E_Shmring_Header *header = shmring->header;
+    uint32_t head;
+
+    if (count == 0) return;
+    head = atomic_load_explicit (&header->head, memory_order_relaxed);
+    atomic_store_explicit (&header->head, head + (uint32_t) count, memory_order_release);
+
+    /* pairs with the fence in `e_shmring__pop_wait`: either the consumer sees the new head, or
+     * the producer sees that the consumer is waiting */
+    atomic_thread_fence (memory_order_seq_cst);
+    if (atomic_load_explicit (&header->consumer_waiting, memory_order_relaxed)) {
+        e_shmring__futex_wake (&header->head);
+    }
+}
+
+const void *
+e_shmring__peek (E_Shmring_Data *shmring, size_t count, size_t *peeked, size_t item_size)
+{
+    E_Shmring_Header *header = shmring->header;
+    uint32_t tail, len, until_end;
+
+    /* the cached head may be outdated (or even behind the tail, if this handle was used by the
+     * producer before) */
+    tail = atomic_load_explicit (&header->tail, memory_order_relaxed);
+    len = (uint32_t) (shmring->cached_head - tail);
+    if (len < count || len > shmring->mask + 1) {
+        shmring->cached_head = atomic_load_explicit (&header->head, memory_order_acquire);
+        len = (uint32_t) (shmring->cached_head - tail);
+    }
+    until_end = shmring->mask + 1 - (tail & shmring->mask);
+    if (len > until_end) len = until_end;
+
+    *peeked = count < len ? count : len;
+    return &shmring->items[(tail & shmring->mask) * item_size];
+}
+
+void
+e_shmring__consume (E_Shmring_Data *shmring, size_t count)
+{
+    E_Shmring_Header *header = shmring->header;
+    uint32_t tail;
+
+    if (count == 0) return;
+    tail = atomic_load_explicit (&header->tail, memory_order_relaxed);
+    atomic_store_explicit (&header->tail, tail + (uint32_t) count, memory_order_release);
+
+    /* pairs with the fence in `e_shmring__push_wait` */
+    atomic_thread_fence (memory_order_seq_cst);
+    if (atomic_load_explicit (&header->producer_waiting, memory_order_relaxed)) {
+        e_shmring__futex_wake (&header->tail);
+    }
+}
+
+int
+e_shmring__push (E_Shmring_Data *shmring, const void *item, size_t item_size)
+{
+    size_t reserved;
+    void *slot;
+
+    slot = e_shmring__reserve (shmring, 1, &reserved, item_size);
+    if (reserved == 0) return 0;
+    memcpy (slot, item, item_size);
+    e_shmring__commit (shmring, 1);
+    return 1;
+}
+
+void
+e_shmring__push_wait (E_Shmring_Data *shmring, const void *item, size_t item_size)
+{
+    E_Shmring_Header *header = shmring->header;
+    unsigned int spins = 0;
+    uint32_t head, tail;
+
+    while (!e_shmring__push (shmring, item, item_size)) {
+        if (spins < E_SHMRING__SPIN_LIMIT) {
+            e_shmring__spin (&spins);
+            continue;
+        }
+        atomic_store_explicit (&header->producer_waiting, 1, memory_order_relaxed);
+        atomic_thread_fence (memory_order_seq_cst);
+        head = atomic_load_explicit (&header->head, memory_order_relaxed);
+        tail = atomic_load_explicit (&header->tail, memory_order_relaxed);
+        if (head - tail > shmring->mask) e_shmring__futex_wait (&header->tail, tail);
+        atomic_store_explicit (&header->producer_waiting, 0, memory_order_relaxed);
+        spins = 0;
+    }
+}
+
+int
+e_shmring__pop (E_Shmring_Data *shmring, void *out, size_t item_size)
+{
+    const void *slot;
+    size_t peeked;
+
+    slot = e_shmring__peek (shmring, 1, &peeked, item_size);
+    if (peeked == 0) return 0;
+    if (out != NULL) memcpy (out, slot, item_size);
+    e_shmring__consume (shmring, 1);
+    return 1;
+}
+
+void
+e_shmring__pop_wait (E_Shmring_Data *shmring, void *out, size_t item_size)
+{
+    E_Shmring_Header *header = shmring->header;
+    unsigned int spins = 0;
+    uint32_t head, tail;
+
+    while (!e_shmring__pop (shmring, out, item_size)) {
+        if (spins < E_SHMRING__SPIN_LIMIT) {
+            e_shmring__spin (&spins);
+            continue;
+        }
+        atomic_store_explicit (&header->consumer_waiting, 1, memory_order_relaxed);
+        atomic_thread_fence (memory_order_seq_cst);
+        head = atomic_load_explicit (&header->head, memory_order_relaxed);
+        tail = atomic_load_explicit (&header->tail, memory_order_relaxed);
+        if (head == tail) e_shmring__futex_wait (&header->head, head);
+        atomic_store_explicit (&header->consumer_waiting, 0, memory_order_relaxed);
+        spins = 0;
+    }
+}
+
+#endif /* E_SHMRING_IMPL */
+
+#endif /* E_SHMRING_H_ */
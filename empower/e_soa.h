@@ -0,0 +1,253 @@
+#ifndef E_SOA_H_
+#define E_SOA_H_
+
+/**************************************************************************************************
+ *
+ * Empower / e_soa.h - Public Domain - https://git.tjdev.de/thetek/empower
+ *
+ * This module implements structure-of-arrays containers.
+ *
+ * Instead of storing an array of structs like `E_Da` does, a structure-of-arrays container keeps
+ * one contiguous column per field, while the length and capacity are shared between all columns.
+ * Loops that only access a few fields thus only touch the memory of those fields, which makes
+ * better use of the cache and allows the compiler to vectorise them.
+ *
+ * The fields are described by an X-macro in the style of `E_MACRO_DECL_STRINGIFY_ENUM`, which is
+ * passed to `E_SOA_DECL_TYPE` and `E_SOA_IMPL_TYPE`. The container type and its functions are
+ * generated from it. Example:
+ *
+ *     // ----- (particles.h) -----
+ *     #define PARTICLE_FIELDS_(X)                                                                 \
+ *             X(float, x)                                                                         \
+ *             X(float, y)                                                                         \
+ *             X(int, id)
+ *     E_SOA_DECL_TYPE (PARTICLE_FIELDS_, Particles, particles);
+ *
+ *     // ----- (particles.c) -----
+ *     #include "particles.h"
+ *     E_SOA_IMPL_TYPE (PARTICLE_FIELDS_, Particles, particles)
+ *
+ *     // ----- (usage) -----
+ *     Particles ps = e_soa_init ();
+ *     particles_push (&ps, 1.0f, 2.0f, 42);
+ *     for (i = 0; i < e_soa_len (&ps); i++) {
+ *             e_soa_col (&ps, x)[i] += 1.0f;
+ *     }
+ *     particles_deinit (&ps);
+ *
+ * Generated output of example:
+ *
+ *     typedef struct {
+ *             E_Soa_Data data;
+ *             float *x;
+ *             float *y;
+ *             int *id;
+ *     } Particles;
+ *     Particles particles_init_with_allocator (const E_Allocator *allocator);
+ *     void particles_deinit (Particles *soa);
+ *     void particles_reserve (Particles *soa, size_t cap);
+ *     void particles_push (Particles *soa, float x, float y, int id);
+ *     size_t particles_push_uninit (Particles *soa);
+ *     void particles_pop (Particles *soa, size_t count);
+ *
+ * Fields must not be called `data` or `soa`.
+ *
+ * By default, memory is allocated using `realloc` and `free`. A custom allocator (see `E_Allocator`
+ * in e_alloc.h) can be used by initialising the container with the generated
+ * `<prefix>_init_with_allocator` function.
+ *
+ * On allocation failure, an error message is printed and the programme is aborted.
+ *
+ * Configuration options:
+ *  - `E_CONFIG_SOA_INIT_CAP`: The capacity that is allocated on the first push (default: 32).
+ *
+ **************************************************************************************************/
+
+#include <stddef.h>
+
+/* allocator interface (see e_alloc.h): */
+#ifndef E_ALLOCATOR_DEFINED
+# define E_ALLOCATOR_DEFINED
+typedef struct {
+    void *(*alloc_fn) (void *ctx, size_t size);
+    void *(*realloc_fn) (void *ctx, void *ptr, size_t old_size, size_t new_size);
+    void (*free_fn) (void *ctx, void *ptr, size_t size);
+    void *ctx;
+} E_Allocator;
+#endif /* E_ALLOCATOR_DEFINED */
+
+typedef struct {
+    size_t len;
+    size_t cap;
+    const E_Allocator *allocator;
+} E_Soa_Data;
+
+/**
+ * Initialise a new structure-of-arrays container.
+ *
+ * No memory is allocated yet.
+ */
+#define e_soa_init() {0}
+
+/**
+ * Obtain the length (i.e. the number of contained rows) of the structure-of-arrays container.
+ */
+#define e_soa_len(soa) (soa)->data.len
+
+/**
+ * Obtain a pointer to the column of the field `field`.
+ *
+ * The pointer is invalidated when the container grows.
+ */
+#define e_soa_col(soa, field) ((soa)->field)
+
+/**
+ * Obtain a pointer to the field `field` of the nth row.
+ *
+ * This does not perform any bounds checks.
+ */
+#define e_soa_nth(soa, field, n) (&(soa)->field[(n)])
+
+#define E_SOA__COLUMN(T, name) T *name;
+#define E_SOA__PARAM(T, name) , T name
+#define E_SOA__STORE(T, name) soa->name[soa->data.len] = name;
+#define E_SOA__FREE(T, name)                                                                       \
+    e_soa__mem_free (soa->data.allocator, soa->name, soa->data.cap * sizeof (T));
+#define E_SOA__RESIZE(T, name)                                                                     \
+    soa->name = e_soa__mem_realloc (soa->data.allocator, soa->name, soa->data.cap * sizeof (T),    \
+                                    new_cap * sizeof (T));
+
+/**
+ * Declare a structure-of-arrays type `type_name` with the fields in `FIELDS`, along with the
+ * functions that operate on it. The functions are prefixed with `prefix`.
+ */
+#define E_SOA_DECL_TYPE(FIELDS, type_name, prefix)                                                 \
+    typedef struct {                                                                               \
+        E_Soa_Data data;                                                                           \
+        FIELDS (E_SOA__COLUMN)                                                                     \
+    } type_name;                                                                                   \
+    type_name prefix##_init_with_allocator (const E_Allocator *allocator);                         \
+    void prefix##_deinit (type_name *soa);                                                         \
+    void prefix##_reserve (type_name *soa, size_t cap);                                            \
+    void prefix##_push (type_name *soa FIELDS (E_SOA__PARAM));                                     \
+    size_t prefix##_push_uninit (type_name *soa);                                                  \
+    void prefix##_pop (type_name *soa, size_t count)
+
+/**
+ * Implement the functions declared by `E_SOA_DECL_TYPE`:
+ *  - `init_with_allocator`: Initialise a container that obtains its memory from `allocator`.
+ *  - `deinit`: Free the memory occupied by the container.
+ *  - `reserve`: Make sure that every column has space for at least `cap` rows in total.
+ *  - `push`: Append a row, with one parameter per field.
+ *  - `push_uninit`: Append a row without initialising it and return its index.
+ *  - `pop`: Remove a certain number of rows from the end of the container.
+ */
+#define E_SOA_IMPL_TYPE(FIELDS, type_name, prefix)                                                 \
+    type_name prefix##_init_with_allocator (const E_Allocator *allocator)                          \
+    {                                                                                              \
+        type_name soa = e_soa_init ();                                                             \
+        soa.data.allocator = allocator;                                                            \
+        return soa;                                                                                \
+    }                                                                                              \
+                                                                                                   \
+    void prefix##_deinit (type_name *soa)                                                          \
+    {                                                                                              \
+        FIELDS (E_SOA__FREE)                                                                       \
+    }                                                                                              \
+                                                                                                   \
+    void prefix##_reserve (type_name *soa, size_t cap)                                             \
+    {                                                                                              \
+        size_t new_cap;                                                                            \
+                                                                                                   \
+        new_cap = e_soa__grow_cap (&soa->data, cap);                                               \
+        if (new_cap == soa->data.cap) return;                                                      \
+        FIELDS (E_SOA__RESIZE)                                                                     \
+        soa->data.cap = new_cap;                                                                   \
+    }                                                                                              \
+                                                                                                   \
+    void prefix##_push (type_name *soa FIELDS (E_SOA__PARAM))                                      \
+    {                                                                                              \
+        prefix##_reserve (soa, soa->data.len + 1);                                                 \
+        FIELDS (E_SOA__STORE)                                                                      \
+        soa->data.len += 1;                                                                        \
+    }                                                                                              \
+                                                                                                   \
+    size_t prefix##_push_uninit (type_name *soa)                                                   \
+    {                                                                                              \
+        prefix##_reserve (soa, soa->data.len + 1);                                                 \
+        soa->data.len += 1;                                                                        \
+        return soa->data.len - 1;                                                                  \
+    }                                                                                              \
+                                                                                                   \
+    void prefix##_pop (type_name *soa, size_t count)                                               \
+    {                                                                                              \
+        if (count > soa->data.len) count = soa->data.len;                                          \
+        soa->data.len -= count;                                                                    \
+    }
+
+size_t e_soa__grow_cap (const E_Soa_Data *soa, size_t cap);
+void *e_soa__mem_realloc (const E_Allocator *allocator, void *ptr, size_t old_size, size_t size);
+void e_soa__mem_free (const E_Allocator *allocator, void *ptr, size_t size);
+
+/**************************************************************************************************/
+
+#ifdef E_SOA_IMPL
+
+# include <stdio.h>
+# include <stdlib.h>
+
+# ifdef E_CONFIG_SOA_INIT_CAP
+#  define E_SOA__INIT_CAP E_CONFIG_SOA_INIT_CAP
+# else
+#  define E_SOA__INIT_CAP 32
+# endif
+
+/**
+ * Compute the capacity that is required to hold `cap` rows. If the current capacity suffices, it is
+ * returned unchanged.
+ */
+size_t
+e_soa__grow_cap (const E_Soa_Data *soa, size_t cap)
+{
+    size_t new_cap;
+
+    if (cap <= soa->cap) return soa->cap;
+    new_cap = soa->cap > 0 ? soa->cap : E_SOA__INIT_CAP;
+    while (new_cap < cap) {
+        new_cap *= 2;
+    }
+    return new_cap;
+}
+
+void *
+e_soa__mem_realloc (const E_Allocator *allocator, void *ptr, size_t old_size, size_t size)
+{
+    void *new_ptr;
+
+    if (allocator == NULL) {
+        new_ptr = realloc (ptr, size);
+    } else if (ptr == NULL) {
+        new_ptr = allocator->alloc_fn (allocator->ctx, size);
+    } else {
+        new_ptr = allocator->realloc_fn (allocator->ctx, ptr, old_size, size);
+    }
+    if (new_ptr == NULL) {
+        fprintf (stderr, "[e_soa] allocation failed!\n");
+        abort ();
+    }
+    return new_ptr;
+}
+
+void
+e_soa__mem_free (const E_Allocator *allocator, void *ptr, size_t size)
+{
+    if (allocator == NULL) {
+        free (ptr);
+    } else if (ptr != NULL) {
+        allocator->free_fn (allocator->ctx, ptr, size);
+    }
+}
+
+#endif /* E_SOA_IMPL */
+
+#endif /* E_SOA_H_ */
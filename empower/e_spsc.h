@@ -0,0 +1,244 @@
+#ifndef E_SPSC_H_
+#define E_SPSC_H_
+
+/**************************************************************************************************
+ *
+ * Empower / e_spsc.h - Public Domain - https://git.tjdev.de/thetek/empower
+ *
+ * This module implements lock-free single-producer/single-consumer ringbuffers for generic types.
+ *
+ * Like in e_rbuf.h, no allocations are performed in the library as the user has to provide the
+ * memory for the ringbuffer. Exactly one thread may push items while exactly one other thread pops
+ * them, without any locks. The head index is only written by the producer and the tail index is
+ * only written by the consumer, and both are kept on separate cache lines. Each side also keeps a
+ * cached copy of the other side's index, so that the shared cache line is only read when the
+ * ringbuffer appears to be full or empty.
+ *
+ * The capacity must be a power of two, so that indices can be wrapped with a mask.
+ *
+ * It can be used as follows:
+ *
+ * ```
+ * int *memory = malloc (sizeof (int) * 1024);
+ * E_Spsc (int) spsc;
+ * e_spsc_init (&spsc, memory, 1024);
+ * // producer thread:
+ * while (!e_spsc_push (&spsc, 42)) { ... }
+ * // consumer thread:
+ * int popped;
+ * if (e_spsc_pop (&spsc, &popped)) { ... }
+ * ```
+ *
+ * Batches of items can be moved with `e_spsc_push_n` and `e_spsc_pop_n`, which copy them with at
+ * most two `memcpy` calls and only publish the new index once.
+ *
+ * This module requires C11 atomics.
+ *
+ **************************************************************************************************/
+
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 201112L || defined(__STDC_NO_ATOMICS__)
+# error e_spsc requires C11 or newer with atomics
+#endif
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/* compatibility annoyances: */
+#ifndef E_TYPEOF
+# if __STDC_VERSION__ >= 202311L
+#  define E_TYPEOF(x) typeof (x)
+# else
+#  define E_TYPEOF(x) __typeof__ (x)
+# endif
+#endif /* E_TYPEOF */
+
+#define E_SPSC__CACHE_LINE 64
+
+/**
+ * Generic single-producer/single-consumer ringbuffer
+ */
+#define E_Spsc(T)                                                                                  \
+    union {                                                                                        \
+        E_Spsc_Data data;                                                                          \
+        T *type; /* NOLINT */                                                                      \
+    }
+
+/**
+ * Initialise a single-producer/single-consumer ringbuffer that uses the memory at `ptr` (of type
+ * `T *`), which has space for `cap` items. `cap` must be a power of two; otherwise, the ringbuffer
+ * is not initialised and zero (false) is returned. On success, a non-zero (true) value is
+ * returned.
+ *
+ * The ringbuffer must be initialised before it is shared with the other thread.
+ */
+#define e_spsc_init(spsc, ptr, cap) e_spsc__init (&(spsc)->data, (1 ? (ptr) : (spsc)->type), (cap))
+
+/**
+ * Obtain the capacity (i.e. the maximum number of items that can be added) of the ringbuffer.
+ */
+#define e_spsc_cap(spsc) ((spsc)->data.mask + 1)
+
+/**
+ * Obtain the number of items in the ringbuffer. When called while the other thread is active, the
+ * result may already be outdated when it is returned.
+ */
+#define e_spsc_len(spsc) e_spsc__len (&(spsc)->data)
+
+/**
+ * Try to add an item to the ringbuffer. Must only be called by the producer.
+ *
+ * If the ringbuffer is full, nothing is added and zero (false) is returned. Otherwise, a non-zero
+ * (true) value is returned.
+ */
+#define e_spsc_push(spsc, item)                                                                    \
+    (int) e_spsc__push_n (&(spsc)->data, (E_TYPEOF (*(spsc)->type)[1]) {(item)}, 1,                \
+                          sizeof (*(spsc)->type))
+
+/**
+ * Try to add an item to the ringbuffer (but the item is a pointer). Must only be called by the
+ * producer.
+ *
+ * If the ringbuffer is full, nothing is added and zero (false) is returned. Otherwise, a non-zero
+ * (true) value is returned.
+ */
+#define e_spsc_push_ref(spsc, item_ptr)                                                            \
+    (int) e_spsc__push_n (&(spsc)->data, (1 ? (item_ptr) : (spsc)->type), 1, sizeof (*(spsc)->type))
+
+/**
+ * Add up to `count` items to the ringbuffer. Must only be called by the producer.
+ *
+ * Only as many items as there is space for are added. The number of added items is returned.
+ */
+#define e_spsc_push_n(spsc, items, count)                                                          \
+    e_spsc__push_n (&(spsc)->data, (1 ? (items) : (spsc)->type), (count), sizeof (*(spsc)->type))
+
+/**
+ * Try to pop an item from the ringbuffer. Must only be called by the consumer.
+ *
+ * If the ringbuffer is not empty, the item will be removed and written to `out`, and a non-zero
+ * (true) value will be returned. If the ringbuffer is empty, no action will be performed, and
+ * zero (false) will be returned.
+ *
+ * If the `out` parameter is `NULL`, nothing will be written to it, but the item will still be
+ * popped and `true` or `false` will be returned.
+ */
+#define e_spsc_pop(spsc, out)                                                                      \
+    (int) e_spsc__pop_n (&(spsc)->data, (1 ? (out) : (spsc)->type), 1, sizeof (*(spsc)->type))
+
+/**
+ * Pop up to `count` items from the ringbuffer and write them to `out`. Must only be called by the
+ * consumer.
+ *
+ * The number of popped items is returned. If the `out` parameter is `NULL`, nothing will be written
+ * to it, but the items will still be popped.
+ */
+#define e_spsc_pop_n(spsc, out, count)                                                             \
+    e_spsc__pop_n (&(spsc)->data, (1 ? (out) : (spsc)->type), (count), sizeof (*(spsc)->type))
+
+typedef struct {
+    /* read-only after initialisation */
+    void *ptr;
+    size_t mask;
+    unsigned char pad0_[E_SPSC__CACHE_LINE];
+    /* written by the producer */
+    _Atomic (size_t) head;
+    size_t tail_cache;
+    unsigned char pad1_[E_SPSC__CACHE_LINE];
+    /* written by the consumer */
+    _Atomic (size_t) tail;
+    size_t head_cache;
+    unsigned char pad2_[E_SPSC__CACHE_LINE];
+} E_Spsc_Data;
+
+int e_spsc__init (E_Spsc_Data *spsc, void *ptr, size_t cap);
+size_t e_spsc__len (E_Spsc_Data *spsc);
+size_t e_spsc__push_n (E_Spsc_Data *spsc, const void *items, size_t count, size_t item_size);
+size_t e_spsc__pop_n (E_Spsc_Data *spsc, void *out, size_t count, size_t item_size);
+
+/**************************************************************************************************/
+
+#ifdef E_SPSC_IMPL
+
+# include <string.h>
+
+int
+e_spsc__init (E_Spsc_Data *spsc, void *ptr, size_t cap)
+{
+    if (cap == 0 || (cap & (cap - 1)) != 0) return 0;
+    spsc->ptr = ptr;
+    spsc->mask = cap - 1;
+    atomic_init (&spsc->head, 0);
+    atomic_init (&spsc->tail, 0);
+    spsc->tail_cache = 0;
+    spsc->head_cache = 0;
+    return 1;
+}
+
+size_t
+e_spsc__len (E_Spsc_Data *spsc)
+{
+    size_t tail, head;
+
+    tail = atomic_load_explicit (&spsc->tail, memory_order_acquire);
+    head = atomic_load_explicit (&spsc->head, memory_order_acquire);
+    return head - tail;
+}
+
+size_t
+e_spsc__push_n (E_Spsc_Data *spsc, const void *items, size_t count, size_t item_size)
+{
+    const unsigned char *src = items;
+    unsigned char *ptr = spsc->ptr;
+    size_t head, free_count, index, run;
+
+    /* indices are free-running and only masked on access, so `head - tail` is the length */
+    head = atomic_load_explicit (&spsc->head, memory_order_relaxed);
+    free_count = spsc->mask + 1 - (head - spsc->tail_cache);
+    if (free_count < count) {
+        spsc->tail_cache = atomic_load_explicit (&spsc->tail, memory_order_acquire);
+        free_count = spsc->mask + 1 - (head - spsc->tail_cache);
+    }
+    if (count > free_count) count = free_count;
+    if (count == 0) return 0;
+
+    index = head & spsc->mask;
+    run = spsc->mask + 1 - index;
+    if (run > count) run = count;
+    memcpy (&ptr[index * item_size], src, run * item_size);
+    memcpy (ptr, &src[run * item_size], (count - run) * item_size);
+
+    atomic_store_explicit (&spsc->head, head + count, memory_order_release);
+    return count;
+}
+
+size_t
+e_spsc__pop_n (E_Spsc_Data *spsc, void *out, size_t count, size_t item_size)
+{
+    unsigned char *dst = out;
+    unsigned char *ptr = spsc->ptr;
+    size_t tail, len, index, run;
+
+    tail = atomic_load_explicit (&spsc->tail, memory_order_relaxed);
+    len = spsc->head_cache - tail;
+    if (len < count) {
+        spsc->head_cache = atomic_load_explicit (&spsc->head, memory_order_acquire);
+        len = spsc->head_cache - tail;
+    }
+    if (count > len) count = len;
+    if (count == 0) return 0;
+
+    if (out != NULL) {
+        index = tail & spsc->mask;
+        run = spsc->mask + 1 - index;
+        if (run > count) run = count;
+        memcpy (dst, &ptr[index * item_size], run * item_size);
+        memcpy (&dst[run * item_size], ptr, (count - run) * item_size);
+    }
+
+    atomic_store_explicit (&spsc->tail, tail + count, memory_order_release);
+    return count;
+}
+
+#endif /* E_SPSC_IMPL */
+
+#endif /* E_SPSC_H_ */
@@ -0,0 +1,300 @@
+#ifndef E_WSDEQUE_H_
+#define E_WSDEQUE_H_
+
+/**************************************************************************************************
+ *
+ * Empower / e_wsdeque.h - Public Domain - https://git.tjdev.de/thetek/empower
+ *
+ * This module implements dynamically growing work-stealing deques (Chase-Lev deques) for generic
+ * types.
+ *
+ * A work-stealing deque is owned by a single thread, which pushes and pops items at its bottom end
+ * in LIFO order. Any number of other threads ("thieves") can concurrently steal items from its top
+ * end in FIFO order. This is the building block of most parallel task schedulers: every worker
+ * thread owns a deque for the tasks that it spawns and steals from the deques of other workers
+ * when it runs out of work.
+ *
+ * The owner's push only uses relaxed loads and stores plus a release fence, and the owner's pop
+ * only needs a compare-and-swap when it races with a thief for the last item. Thieves claim an item
+ * with a single compare-and-swap.
+ *
+ * It can be used as follows:
+ *
+ * ```
+ * E_Wsdeque (Task) tasks = e_wsdeque_init ();
+ * // in the owner thread:
+ * e_wsdeque_push (&tasks, task);
+ * while (e_wsdeque_pop (&tasks, &task)) { run (task); }
+ * // in any other thread:
+ * if (e_wsdeque_steal (&tasks, &task)) { run (task); }
+ * // after all threads are done:
+ * e_wsdeque_deinit (&tasks);
+ * ```
+ *
+ * When the deque is full, the owner moves the items to a buffer that is twice as large. Since
+ * thieves may still be reading from the old buffer, it is only freed by `e_wsdeque_deinit`. The
+ * memory overhead of this is bounded by the size of the largest buffer.
+ *
+ * Items are copied into and out of the deque with `memcpy`. A thief that loses the race for an
+ * item may have already copied it, so it should be a plain value (such as a pointer to a task).
+ *
+ * This module requires C11 atomics.
+ *
+ * On allocation failure, an error message is printed and the programme is aborted.
+ *
+ * Configuration options:
+ *  - `E_CONFIG_WSDEQUE_INIT_CAP`: The capacity that is allocated on the first push. Must be a power
+ *    of two (default: 32).
+ *
+ **************************************************************************************************/
+
+#if !defined(__STDC_VERSION__) || __STDC_VERSION__ < 201112L || defined(__STDC_NO_ATOMICS__)
+# error e_wsdeque requires C11 or newer with atomics
+#endif
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/* compatibility annoyances: */
+#ifndef E_TYPEOF
+# if __STDC_VERSION__ >= 202311L
+#  define E_TYPEOF(x) typeof (x)
+# else
+#  define E_TYPEOF(x) __typeof__ (x)
+# endif
+#endif /* E_TYPEOF */
+
+#define E_WSDEQUE__CACHE_LINE 64
+
+/**
+ * Generic work-stealing deque
+ */
+#define E_Wsdeque(T)                                                                               \
+    union {                                                                                        \
+        E_Wsdeque_Data data;                                                                       \
+        T *type; /* NOLINT */                                                                      \
+    }
+
+/**
+ * Initialise a new work-stealing deque.
+ *
+ * No memory is allocated yet.
+ */
+#define e_wsdeque_init() {0}
+
+/**
+ * Free the memory occupied by the work-stealing deque. Must only be called once no other thread
+ * uses it anymore.
+ */
+#define e_wsdeque_deinit(wsdeque) e_wsdeque__deinit (&(wsdeque)->data)
+
+/**
+ * Obtain the number of items in the work-stealing deque. When called while other threads are
+ * active, the result is only an approximation.
+ */
+#define e_wsdeque_len(wsdeque) e_wsdeque__len (&(wsdeque)->data)
+
+/**
+ * Add an item to the bottom of the work-stealing deque. Must only be called by the owner.
+ */
+#define e_wsdeque_push(wsdeque, item)                                                              \
+    e_wsdeque__push (&(wsdeque)->data, (E_TYPEOF (*(wsdeque)->type)[1]) {(item)},                  \
+                     sizeof (*(wsdeque)->type))
+
+/**
+ * Add an item to the bottom of the work-stealing deque (but the item is a pointer). Must only be
+ * called by the owner.
+ */
+#define e_wsdeque_push_ref(wsdeque, item_ptr)                                                      \
+    e_wsdeque__push (&(wsdeque)->data, (1 ? (item_ptr) : (wsdeque)->type),                         \
+                     sizeof (*(wsdeque)->type))
+
+/**
+ * Pop the item that was pushed last from the bottom of the work-stealing deque. Must only be called
+ * by the owner.
+ *
+ * If an item was popped, it is written to `out` and a non-zero (true) value is returned. If the
+ * deque is empty (or a thief stole the last item), zero (false) is returned and `out` is left
+ * untouched.
+ *
+ * If the `out` parameter is `NULL`, nothing will be written to it, but the item will still be
+ * popped and `true` or `false` will be returned.
+ */
+#define e_wsdeque_pop(wsdeque, out)                                                                \
+    e_wsdeque__pop (&(wsdeque)->data, (1 ? (out) : (wsdeque)->type), sizeof (*(wsdeque)->type))
+
+/**
+ * Steal the oldest item from the top of the work-stealing deque. Can be called from any thread.
+ *
+ * If an item was stolen, it is written to `out` and a non-zero (true) value is returned. If the
+ * deque is empty or another thread took the item first, zero (false) is returned; in the latter
+ * case, `out` may have been overwritten nevertheless.
+ */
+#define e_wsdeque_steal(wsdeque, out)                                                              \
+    e_wsdeque__steal (&(wsdeque)->data, (1 ? (out) : (wsdeque)->type), sizeof (*(wsdeque)->type))
+
+typedef struct E_Wsdeque__Buffer {
+    size_t mask;
+    struct E_Wsdeque__Buffer *prev;
+    _Alignas (max_align_t) unsigned char items[];
+} E_Wsdeque__Buffer;
+
+typedef struct {
+    /* written by thieves */
+    _Atomic (ptrdiff_t) top;
+    unsigned char pad_[E_WSDEQUE__CACHE_LINE - sizeof (ptrdiff_t)];
+    /* written by the owner */
+    _Atomic (ptrdiff_t) bottom;
+    _Atomic (E_Wsdeque__Buffer *) buffer;
+} E_Wsdeque_Data;
+
+void e_wsdeque__deinit (E_Wsdeque_Data *wsdeque);
+size_t e_wsdeque__len (E_Wsdeque_Data *wsdeque);
+void e_wsdeque__push (E_Wsdeque_Data *wsdeque, const void *item, size_t item_size);
+int e_wsdeque__pop (E_Wsdeque_Data *wsdeque, void *out, size_t item_size);
+int e_wsdeque__steal (E_Wsdeque_Data *wsdeque, void *out, size_t item_size);
+
+/**************************************************************************************************/
+
+#ifdef E_WSDEQUE_IMPL
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+
+# ifdef E_CONFIG_WSDEQUE_INIT_CAP
+#  define E_WSDEQUE__INIT_CAP E_CONFIG_WSDEQUE_INIT_CAP
+# else
+#  define E_WSDEQUE__INIT_CAP 32
+# endif
+
+E_Wsdeque__Buffer *e_wsdeque__grow (E_Wsdeque_Data *wsdeque, E_Wsdeque__Buffer *buffer,
+                                    ptrdiff_t top, ptrdiff_t bottom, size_t item_size);
+
+/**
+ * Replace `buffer` with one that is twice as large (or allocate the first buffer) and copy the
+ * items from `top` to `bottom` into it. The old buffer is kept for thieves that still read from it.
+ */
+E_Wsdeque__Buffer *
+e_wsdeque__grow (E_Wsdeque_Data *wsdeque, E_Wsdeque__Buffer *buffer, ptrdiff_t top,
+                 ptrdiff_t bottom, size_t item_size)
+{
+    E_Wsdeque__Buffer *new_buffer;
+    size_t cap;
+    ptrdiff_t i;
+
+    cap = buffer != NULL ? (buffer->mask + 1) * 2 : E_WSDEQUE__INIT_CAP;
+    new_buffer = malloc (sizeof (E_Wsdeque__Buffer) + cap * item_size);
+    if (new_buffer == NULL) {
+        fprintf (stderr, "[e_wsdeque] allocation failed!\n");
+        abort ();
+    }
+    new_buffer->mask = cap - 1;
+    new_buffer->prev = buffer;
+    for (i = top; i < bottom; i++) {
+        memcpy (&new_buffer->items[((size_t) i & new_buffer->mask) * item_size],
+                &buffer->items[((size_t) i & buffer->mask) * item_size], item_size);
+    }
+    atomic_store_explicit (&wsdeque->buffer, new_buffer, memory_order_release);
+    return new_buffer;
+}
+
+void
+e_wsdeque__deinit (E_Wsdeque_Data *wsdeque)
+{
+    E_Wsdeque__Buffer *buffer, *prev;
+
+    buffer = atomic_load_explicit (&wsdeque->buffer, memory_order_relaxed);
+    while (buffer != NULL) {
+        prev = buffer->prev;
+        free (buffer);
+        buffer = prev;
+    }
+}
+
+size_t
+e_wsdeque__len (E_Wsdeque_Data *wsdeque)
+{
+    ptrdiff_t top, bottom;
+
+    top = atomic_load_explicit (&wsdeque->top, memory_order_acquire);
+    bottom = atomic_load_explicit (&wsdeque->bottom, memory_order_acquire);
+    return bottom > top ? (size_t) (bottom - top) : 0;
+}
+
+void
+e_wsdeque__push (E_Wsdeque_Data *wsdeque, const void *item, size_t item_size)
+{
+    E_Wsdeque__Buffer *buffer;
+    ptrdiff_t top, bottom;
+
+    bottom = atomic_load_explicit (&wsdeque->bottom, memory_order_relaxed);
+    top = atomic_load_explicit (&wsdeque->top, memory_order_acquire);
+    buffer = atomic_load_explicit (&wsdeque->buffer, memory_order_relaxed);
+    if (buffer == NULL || (size_t) (bottom - top) > buffer->mask) {
+        buffer = e_wsdeque__grow (wsdeque, buffer, top, bottom, item_size);
+    }
+    memcpy (&buffer->items[((size_t) bottom & buffer->mask) * item_size], item, item_size);
+    /* publish the item before the new bottom becomes visible to thieves */
+    atomic_thread_fence (memory_order_release);
+    atomic_store_explicit (&wsdeque->bottom, bottom + 1, memory_order_relaxed);
+}
+
+int
+e_wsdeque__pop (E_Wsdeque_Data *wsdeque, void *out, size_t item_size)
+{
+    E_Wsdeque__Buffer *buffer;
+    ptrdiff_t top, bottom;
+    int popped;
+
+    /* claim the bottom item first, so that thieves that have not read `bottom` yet back off */
+    bottom = atomic_load_explicit (&wsdeque->bottom, memory_order_relaxed) - 1;
+    buffer = atomic_load_explicit (&wsdeque->buffer, memory_order_relaxed);
+    atomic_store_explicit (&wsdeque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence (memory_order_seq_cst);
+    top = atomic_load_explicit (&wsdeque->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        /* empty */
+        atomic_store_explicit (&wsdeque->bottom, bottom + 1, memory_order_relaxed);
+        return 0;
+    }
+
+    popped = 1;
+    if (top == bottom) {
+        /* last item: race against thieves */
+        if (!atomic_compare_exchange_strong_explicit (&wsdeque->top, &top, top + 1,
+                                                      memory_order_seq_cst, memory_order_relaxed)) {
+            popped = 0;
+        }
+        atomic_store_explicit (&wsdeque->bottom, bottom + 1, memory_order_relaxed);
+    }
+    /* only the owner writes to the slots, so the item is still there after winning the race */
+    if (popped && out != NULL) {
+        memcpy (out, &buffer->items[((size_t) bottom & buffer->mask) * item_size], item_size);
+    }
+    return popped;
+}
+
+int
+e_wsdeque__steal (E_Wsdeque_Data *wsdeque, void *out, size_t item_size)
+{
+    E_Wsdeque__Buffer *buffer;
+    ptrdiff_t top, bottom;
+
+    top = atomic_load_explicit (&wsdeque->top, memory_order_acquire);
+    atomic_thread_fence (memory_order_seq_cst);
+    bottom = atomic_load_explicit (&wsdeque->bottom, memory_order_acquire);
+    if (top >= bottom) return 0;
+
+    buffer = atomic_load_explicit (&wsdeque->buffer, memory_order_acquire);
+    if (out != NULL) {
+        memcpy (out, &buffer->items[((size_t) top & buffer->mask) * item_size], item_size);
+    }
+    return atomic_compare_exchange_strong_explicit (&wsdeque->top, &top, top + 1,
+                                                    memory_order_seq_cst, memory_order_relaxed);
+}
+
+#endif /* E_WSDEQUE_IMPL */
+
+#endif /* E_WSDEQUE_H_ */
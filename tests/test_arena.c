@@ -7,8 +7,11 @@
 void
 test_arena (void)
 {
+    E_Allocator allocator;
     E_Arena arena;
     unsigned char buf[32];
+    unsigned char allocator_buf[32 + 64];
+    unsigned char *start, *bytes;
     void *ptr;
 
     arena = e_arena_init (buf, sizeof (buf));
@@ -24,4 +27,22 @@ test_arena (void)
 
     ptr = e_arena_alloc_size (&arena, 64);
     e_test_assert_null ("e_arena_alloc too large", ptr);
+
+    /* e_arena_allocator (the arena starts at an `E_ALIGN_MAX` boundary, so that no padding is
+     * inserted before the first allocation) */
+    start = allocator_buf;
+    start += ((size_t) E_ALIGN_MAX - (size_t) start % (size_t) E_ALIGN_MAX) % (size_t) E_ALIGN_MAX;
+    arena = e_arena_init (start, 32);
+    allocator = e_arena_allocator (&arena);
+    bytes = allocator.alloc_fn (allocator.ctx, 4);
+    e_test_assert_ptr_eq ("e_arena_allocator alloc", bytes, start);
+    bytes[0] = 42;
+    ptr = allocator.realloc_fn (allocator.ctx, bytes, 4, 8);
+    e_test_assert_ptr_eq ("e_arena_allocator realloc in place", ptr, bytes);
+    e_test_assert_eq ("e_arena_allocator realloc in place len", size_t,
+                      e_arena_allocated_byte_count (&arena), 8);
+    ptr = allocator.realloc_fn (allocator.ctx, bytes, 8, 64);
+    e_test_assert_null ("e_arena_allocator realloc too large", ptr);
+    allocator.free_fn (allocator.ctx, bytes, 8);
+    e_test_assert_eq ("e_arena_allocator free", size_t, e_arena_allocated_byte_count (&arena), 0);
 }
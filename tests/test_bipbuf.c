@@ -0,0 +1,99 @@
+#define E_BIPBUF_IMPL
+#include "e_bipbuf.h"
+#include "e_test.h"
+
+#include <stddef.h>
+#include <string.h>
+
+void
+test_bipbuf (void)
+{
+    static size_t memory[12]; /* static for C89 compliance */
+    size_t cap = sizeof (memory), header = sizeof (size_t), len = 0;
+    unsigned char *record, *dst;
+
+    /* e_bipbuf_init */
+    E_Bipbuf bipbuf;
+    e_bipbuf_init (&bipbuf, memory, sizeof (memory) + 3);
+    e_test_assert_eq ("e_bipbuf_init cap", size_t, bipbuf.rbuf.data.cap, cap);
+    e_test_assert_eq ("e_bipbuf_init len", size_t, e_bipbuf_len (&bipbuf), 0);
+    e_test_assert ("e_bipbuf_init is_empty", e_bipbuf_is_empty (&bipbuf));
+    e_test_assert_null ("e_bipbuf_peek empty", e_bipbuf_peek (&bipbuf, &len));
+    e_test_assert ("e_bipbuf_pop empty", !e_bipbuf_pop (&bipbuf));
+
+    /* e_bipbuf_push, e_bipbuf_peek, e_bipbuf_pop */
+    e_test_assert ("e_bipbuf_push", e_bipbuf_push (&bipbuf, "hello", 5));
+    e_test_assert ("e_bipbuf_push empty record", e_bipbuf_push (&bipbuf, "", 0));
+    e_test_assert_eq ("e_bipbuf_push len", size_t, e_bipbuf_len (&bipbuf), 2);
+    e_test_assert_eq ("e_bipbuf_push bytes", size_t, bipbuf.rbuf.data.len,
+                      header + ((5 + header - 1) / header * header) + header);
+    record = e_bipbuf_peek (&bipbuf, &len);
+    e_test_assert_ptr_eq ("e_bipbuf_peek ptr", record, (unsigned char *) memory + header);
+    e_test_assert_eq ("e_bipbuf_peek len", size_t, len, 5);
+    e_test_assert ("e_bipbuf_peek data", record != NULL && memcmp (record, "hello", 5) == 0);
+    e_test_assert ("e_bipbuf_pop", e_bipbuf_pop (&bipbuf));
+    e_bipbuf_peek (&bipbuf, &len);
+    e_test_assert_eq ("e_bipbuf_peek empty record", size_t, len, 0);
+    e_test_assert ("e_bipbuf_pop empty record", e_bipbuf_pop (&bipbuf));
+    e_test_assert ("e_bipbuf_pop is_empty", e_bipbuf_is_empty (&bipbuf));
+    e_test_assert_eq ("e_bipbuf_pop bytes", size_t, bipbuf.rbuf.data.len, 0);
+
+    /* e_bipbuf_reserve, e_bipbuf_commit */
+    e_test_assert_null ("e_bipbuf_reserve too large", e_bipbuf_reserve (&bipbuf, cap));
+    dst = e_bipbuf_reserve (&bipbuf, cap - header);
+    e_test_assert_ptr_eq ("e_bipbuf_reserve whole", dst, (unsigned char *) memory + header);
+    e_bipbuf_reserve (&bipbuf, 5);
+    e_bipbuf_commit (&bipbuf, 100);
+    record = e_bipbuf_peek (&bipbuf, &len);
+    e_test_assert_eq ("e_bipbuf_commit limited to requested len", size_t, len, 5);
+    e_test_assert_eq ("e_bipbuf_commit requested bytes", size_t, bipbuf.rbuf.data.len,
+                      header + ((5 + header - 1) / header * header));
+    e_bipbuf_pop (&bipbuf);
+    dst = e_bipbuf_reserve (&bipbuf, 4 * header);
+    e_test_assert_ptr_eq ("e_bipbuf_reserve again", dst, (unsigned char *) memory + header);
+    if (dst != NULL) memset (dst, 'a', 2 * header);
+    e_bipbuf_commit (&bipbuf, 2 * header);
+    e_test_assert_eq ("e_bipbuf_commit shorter", size_t, bipbuf.rbuf.data.len, 3 * header);
+    e_bipbuf_commit (&bipbuf, 1);
+    e_test_assert_eq ("e_bipbuf_commit twice", size_t, e_bipbuf_len (&bipbuf), 1);
+    dst = e_bipbuf_reserve (&bipbuf, 2 * header);
+    e_test_assert ("e_bipbuf_reserve after commit", dst != NULL);
+    if (dst != NULL) memset (dst, 'b', 2 * header);
+    e_bipbuf_commit (&bipbuf, 100 * header);
+    e_test_assert_eq ("e_bipbuf_commit limited", size_t, bipbuf.rbuf.data.len, 6 * header);
+    e_test_assert_eq ("e_bipbuf_commit len", size_t, e_bipbuf_len (&bipbuf), 2);
+    e_bipbuf_pop (&bipbuf);
+
+    /* the records occupy words 3..5 of 12, so 6 words are free at the end and 3 at the start */
+    e_test_assert_null ("e_bipbuf_reserve no space", e_bipbuf_reserve (&bipbuf, 6 * header));
+    dst = e_bipbuf_reserve (&bipbuf, 3 * header);
+    e_test_assert_ptr_eq ("e_bipbuf_reserve end", dst, (unsigned char *) &memory[7]);
+    if (dst != NULL) memset (dst, 'c', 3 * header);
+    e_bipbuf_commit (&bipbuf, 3 * header);
+    e_test_assert_null ("e_bipbuf_reserve wrapped too large",
+                        e_bipbuf_reserve (&bipbuf, 3 * header));
+    dst = e_bipbuf_reserve (&bipbuf, 2 * header);
+    e_test_assert_ptr_eq ("e_bipbuf_reserve wrapped", dst, (unsigned char *) &memory[1]);
+    e_test_assert_eq ("e_bipbuf_reserve padding", size_t, bipbuf.rbuf.data.len, 9 * header);
+    if (dst != NULL) memset (dst, 'd', 2 * header);
+    e_bipbuf_commit (&bipbuf, 2 * header - 1);
+    e_test_assert_eq ("e_bipbuf_commit wrapped len", size_t, e_bipbuf_len (&bipbuf), 3);
+    e_test_assert_null ("e_bipbuf_reserve full", e_bipbuf_reserve (&bipbuf, 0));
+    e_test_assert ("e_bipbuf_push full", !e_bipbuf_push (&bipbuf, "x", 1));
+
+    /* the padding at the end is skipped and reclaimed while reading */
+    record = e_bipbuf_peek (&bipbuf, &len);
+    e_test_assert ("e_bipbuf_peek first", record != NULL && len == 2 * header && record[0] == 'b');
+    e_bipbuf_pop (&bipbuf);
+    record = e_bipbuf_peek (&bipbuf, &len);
+    e_test_assert ("e_bipbuf_peek second", record != NULL && len == 3 * header && record[0] == 'c');
+    e_bipbuf_pop (&bipbuf);
+    record = e_bipbuf_peek (&bipbuf, &len);
+    e_test_assert_ptr_eq ("e_bipbuf_peek after padding", record, (unsigned char *) &memory[1]);
+    e_test_assert ("e_bipbuf_peek third",
+                   record != NULL && len == 2 * header - 1 && record[0] == 'd');
+    e_test_assert_eq ("e_bipbuf_peek padding reclaimed", size_t, bipbuf.rbuf.data.len, 3 * header);
+    e_bipbuf_pop (&bipbuf);
+    e_test_assert ("e_bipbuf_pop all", e_bipbuf_is_empty (&bipbuf));
+    e_test_assert_eq ("e_bipbuf_pop all bytes", size_t, bipbuf.rbuf.data.len, 0);
+}
@@ -4,29 +4,235 @@
 
 #include <stddef.h>
 
+static unsigned char
+test_bitvec_byte (const E_Bitvec_Word *data, size_t n)
+{
+    return (unsigned char) (data[n * 8 / E_BITVEC_WORD_BITS] >> (n * 8 % E_BITVEC_WORD_BITS));
+}
+
+static void
+test_bitvec_ops (void)
+{
+    static E_Bitvec_Word a_data[E_BITVEC_WORDS (1000)]; /* static for C89 compliance */
+    static E_Bitvec_Word b_data[E_BITVEC_WORDS (1000)];
+    static E_Bitvec_Word d_data[E_BITVEC_WORDS (1000)];
+    E_Bitvec a, b, d;
+    size_t i, count;
+    int ok_and, ok_or, ok_xor, ok_andnot, ok_not;
+    int x, y;
+
+    a = e_bitvec_init (a_data, 1000);
+    b = e_bitvec_init (b_data, 1000);
+    d = e_bitvec_init (d_data, 1000);
+    count = 0;
+    for (i = 0; i < 1000; i++) {
+        e_bitvec_put (&a, i, i % 3 == 0 || i % 11 == 0);
+        e_bitvec_put (&b, i, i % 5 == 0 || i > 900);
+        if (e_bitvec_get (&a, i) && e_bitvec_get (&b, i)) count += 1;
+    }
+    e_test_assert_eq ("e_bitvec_count_and", size_t, e_bitvec_count_and (&a, &b), count);
+
+    e_bitvec_and (&d, &a, &b);
+    ok_and = e_bitvec_count (&d, 0, 1000) == count;
+    for (i = 0; i < 1000; i++) {
+        x = e_bitvec_get (&a, i);
+        y = e_bitvec_get (&b, i);
+        if (e_bitvec_get (&d, i) != (x && y)) ok_and = 0;
+    }
+    e_bitvec_or (&d, &a, &b);
+    ok_or = 1;
+    for (i = 0; i < 1000; i++) {
+        if (e_bitvec_get (&d, i) != (e_bitvec_get (&a, i) || e_bitvec_get (&b, i))) ok_or = 0;
+    }
+    e_bitvec_xor (&d, &a, &b);
+    ok_xor = 1;
+    for (i = 0; i < 1000; i++) {
+        if (e_bitvec_get (&d, i) != (e_bitvec_get (&a, i) != e_bitvec_get (&b, i))) ok_xor = 0;
+    }
+    e_bitvec_andnot (&d, &a, &b);
+    ok_andnot = 1;
+    for (i = 0; i < 1000; i++) {
+        if (e_bitvec_get (&d, i) != (e_bitvec_get (&a, i) && !e_bitvec_get (&b, i))) ok_andnot = 0;
+    }
+    e_bitvec_not (&d, &a);
+    ok_not = e_bitvec_count (&d, 0, 1000) + e_bitvec_count (&a, 0, 1000) == 1000;
+    for (i = 0; i < 1000; i++) {
+        if (e_bitvec_get (&d, i) == e_bitvec_get (&a, i)) ok_not = 0;
+    }
+    e_test_assert ("e_bitvec_and", ok_and);
+    e_test_assert ("e_bitvec_or", ok_or);
+    e_test_assert ("e_bitvec_xor", ok_xor);
+    e_test_assert ("e_bitvec_andnot", ok_andnot);
+    e_test_assert ("e_bitvec_not", ok_not);
+    e_test_assert_eq ("e_bitvec_not end", E_Bitvec_Word,
+                      d_data[E_BITVEC_WORDS (1000) - 1] >> (1000 % E_BITVEC_WORD_BITS), 0);
+
+    /* in place */
+    e_bitvec_not (&d, &d);
+    e_test_assert_eq ("e_bitvec_not in place", size_t, e_bitvec_count_and (&d, &a),
+                      e_bitvec_count (&a, 0, 1000));
+    e_bitvec_and (&a, &a, &b);
+    e_test_assert_eq ("e_bitvec_and in place", size_t, e_bitvec_count (&a, 0, 1000), count);
+    e_bitvec_andnot (&b, &b, &a);
+    e_test_assert_eq ("e_bitvec_andnot in place", size_t, e_bitvec_count_and (&a, &b), 0);
+    e_bitvec_or (&b, &b, &a);
+    e_test_assert_eq ("e_bitvec_or in place", size_t, e_bitvec_count_and (&a, &b), count);
+    e_bitvec_xor (&b, &b, &b);
+    e_test_assert ("e_bitvec_xor in place", !e_bitvec_any (&b, 0, 1000));
+
+    /* different capacities */
+    a.cap = 100;
+    e_bitvec_not (&d, &b);
+    e_bitvec_or (&d, &a, &b);
+    e_test_assert ("e_bitvec_or smaller", e_bitvec_all (&d, 100, 1000));
+    e_test_assert_eq ("e_bitvec_or smaller count", size_t, e_bitvec_count (&d, 0, 100),
+                      e_bitvec_count (&a, 0, 100));
+    e_test_assert_eq ("e_bitvec_count_and smaller", size_t, e_bitvec_count_and (&a, &d),
+                      e_bitvec_count (&a, 0, 100));
+}
+
+static void
+test_bitvec_ranges (void)
+{
+    static E_Bitvec_Word data[E_BITVEC_WORDS (300)]; /* static for C89 compliance */
+    E_Bitvec bv;
+    size_t i;
+    int ok;
+
+    bv = e_bitvec_init (data, 300);
+
+    /* e_bitvec_set_range */
+    e_bitvec_set_range (&bv, 3, 250);
+    e_test_assert_eq ("e_bitvec_set_range count", size_t, e_bitvec_count (&bv, 0, 300), 247);
+    e_test_assert ("e_bitvec_set_range all", e_bitvec_all (&bv, 3, 250));
+    e_test_assert ("e_bitvec_set_range before", !e_bitvec_get (&bv, 2));
+    e_test_assert ("e_bitvec_set_range after", !e_bitvec_get (&bv, 250));
+    e_bitvec_set_range (&bv, 290, 1000);
+    e_test_assert_eq ("e_bitvec_set_range trimmed", size_t, e_bitvec_count (&bv, 250, 300), 10);
+    e_test_assert_eq ("e_bitvec_set_range end", E_Bitvec_Word,
+                      data[E_BITVEC_WORDS (300) - 1] >> (300 % E_BITVEC_WORD_BITS), 0);
+    e_bitvec_set_range (&bv, 260, 260);
+    e_bitvec_set_range (&bv, 300, 310);
+    e_test_assert_eq ("e_bitvec_set_range empty", size_t, e_bitvec_count (&bv, 0, 300), 257);
+
+    /* e_bitvec_unset_range */
+    e_bitvec_unset_range (&bv, 10, 20);
+    e_test_assert_eq ("e_bitvec_unset_range word", size_t, e_bitvec_count (&bv, 0, 300), 247);
+    e_test_assert ("e_bitvec_unset_range none", !e_bitvec_any (&bv, 10, 20));
+    e_test_assert ("e_bitvec_unset_range edges", e_bitvec_get (&bv, 9) && e_bitvec_get (&bv, 20));
+    e_bitvec_unset_range (&bv, 0, 300);
+    e_test_assert ("e_bitvec_unset_range all", !e_bitvec_any (&bv, 0, 300));
+
+    /* e_bitvec_negate_range */
+    for (i = 0; i < 300; i += 2) {
+        e_bitvec_set (&bv, i);
+    }
+    e_bitvec_negate_range (&bv, 1, 299);
+    ok = e_bitvec_get (&bv, 0) && !e_bitvec_get (&bv, 299);
+    for (i = 1; i < 299; i++) {
+        if (e_bitvec_get (&bv, i) != (i % 2 == 1)) ok = 0;
+    }
+    e_test_assert ("e_bitvec_negate_range", ok);
+
+    /* e_bitvec_find_first_unset */
+    e_bitvec_set_range (&bv, 0, 300);
+    e_test_assert_eq ("e_bitvec_find_first_unset full", size_t,
+                      e_bitvec_find_first_unset (&bv, 0, 300), E_BITVEC_NONE);
+    e_bitvec_unset (&bv, 70);
+    e_bitvec_unset (&bv, 200);
+    e_test_assert_eq ("e_bitvec_find_first_unset", size_t, e_bitvec_find_first_unset (&bv, 0, 300),
+                      70);
+    e_test_assert_eq ("e_bitvec_find_first_unset start", size_t,
+                      e_bitvec_find_first_unset (&bv, 71, 1000), 200);
+    e_test_assert_eq ("e_bitvec_find_first_unset end", size_t,
+                      e_bitvec_find_first_unset (&bv, 71, 200), E_BITVEC_NONE);
+    e_test_assert_eq ("e_bitvec_find_first_unset empty", size_t,
+                      e_bitvec_find_first_unset (&bv, 70, 70), E_BITVEC_NONE);
+}
+
+static void
+test_bitvec_rank (void)
+{
+    static E_Bitvec_Word data[E_BITVEC_WORDS (200000)]; /* static for C89 compliance */
+    static size_t memory[256];
+    E_Bitvec bv;
+    E_Bitvec_Rank rank;
+    size_t i, k, ones;
+    int ok_rank, ok_select;
+
+    /* empty */
+    bv = e_bitvec_init (data, 0);
+    rank = e_bitvec_rank_init (&bv, memory);
+    e_test_assert_eq ("e_bitvec_rank1 empty", size_t, e_bitvec_rank1 (&rank, 0), 0);
+    e_test_assert_eq ("e_bitvec_select1 empty", size_t, e_bitvec_select1 (&rank, 0),
+                      E_BITVEC_NONE);
+
+    /* more set bits than one select sample, with a full superblock and a gap of more than a
+     * superblock */
+    bv = e_bitvec_init (data, 200000);
+    for (i = 0; i < 200000; i++) {
+        e_bitvec_put (&bv, i, i < 65536 || (i % 3 != 0 && (i < 70000 || i >= 140000)) ||
+                                  i == 100000);
+    }
+    data[E_BITVEC_WORDS (200000) - 1] |= ~(E_Bitvec_Word) 0 << (200000 % E_BITVEC_WORD_BITS);
+    e_test_assert ("e_bitvec_rank_size", e_bitvec_rank_size (200000) <= sizeof (memory));
+    e_test_assert ("e_bitvec_rank_size overhead",
+                   e_bitvec_rank_size (200000) * 8 <= (size_t) 200000 * 4 / 100);
+    rank = e_bitvec_rank_init (&bv, memory);
+    ones = e_bitvec_count (&bv, 0, 200000);
+    e_test_assert_eq ("e_bitvec_rank1 all", size_t, e_bitvec_rank1 (&rank, 200000), ones);
+    e_test_assert_eq ("e_bitvec_rank1 out of range", size_t, e_bitvec_rank1 (&rank, 300000),
+                      ones);
+    e_test_assert_eq ("e_bitvec_rank1 full superblock", size_t, e_bitvec_rank1 (&rank, 65536),
+                      65536);
+    e_test_assert_eq ("e_bitvec_rank0", size_t, e_bitvec_rank0 (&rank, 90000),
+                      90000 - e_bitvec_count (&bv, 0, 90000));
+
+    ok_rank = 1;
+    ok_select = 1;
+    k = 0;
+    for (i = 0; i < 200000; i++) {
+        if (e_bitvec_rank1 (&rank, i) != k) ok_rank = 0;
+        if (e_bitvec_get (&bv, i)) {
+            if (e_bitvec_select1 (&rank, k) != i) ok_select = 0;
+            k += 1;
+        }
+    }
+    e_test_assert ("e_bitvec_rank1", ok_rank);
+    e_test_assert ("e_bitvec_select1", ok_select);
+    e_test_assert_eq ("e_bitvec_select1 gap", size_t,
+                      e_bitvec_select1 (&rank, e_bitvec_rank1 (&rank, 70000)), 100000);
+    e_test_assert_eq ("e_bitvec_select1 none", size_t, e_bitvec_select1 (&rank, ones),
+                      E_BITVEC_NONE);
+}
+
 void
 test_bitvec (void)
 {
     E_Bitvec bv;
-    unsigned char data[8];
-    size_t i;
+    E_Bitvec_Word data[E_BITVEC_WORDS (64)];
+    static E_Bitvec_Word big_data[E_BITVEC_WORDS (200)]; /* static for C89 compliance */
+    size_t i, expected;
+    int ok;
 
     bv = e_bitvec_init (data, 64);
 
     e_bitvec_set (&bv, 19);
     e_bitvec_set (&bv, 21);
-    e_test_assert_eq ("e_bitvec_set", unsigned char, data[2], 0x28); /* 0b00101000 */
+    e_test_assert_eq ("e_bitvec_set", unsigned char, test_bitvec_byte (data, 2), 0x28);
 
     e_bitvec_negate (&bv, 23);
     e_bitvec_negate (&bv, 21);
-    e_test_assert_eq ("e_bitvec_negate", unsigned char, data[2], 0x88); /* 0b10001000 */
+    e_test_assert_eq ("e_bitvec_negate", unsigned char, test_bitvec_byte (data, 2), 0x88);
 
     e_bitvec_unset (&bv, 23);
-    e_test_assert_eq ("e_bitvec_unset", unsigned char, data[2], 0x8); /* 0b00001000 */
+    e_test_assert_eq ("e_bitvec_unset", unsigned char, test_bitvec_byte (data, 2), 0x8);
 
     e_bitvec_put (&bv, 22, 1);
     e_bitvec_put (&bv, 19, 0);
-    e_test_assert_eq ("e_bitvec_put", unsigned char, data[2], 0x40); /* 0b01000000 */
+    e_test_assert_eq ("e_bitvec_put", unsigned char, test_bitvec_byte (data, 2), 0x40);
+    e_test_assert ("e_bitvec_get", e_bitvec_get (&bv, 22) && !e_bitvec_get (&bv, 21));
+    e_test_assert ("e_bitvec_get out of range", !e_bitvec_get (&bv, 64));
 
     for (i = 35; i < 55; i++) {
         e_bitvec_set (&bv, i);
@@ -40,4 +246,61 @@ test_bitvec (void)
     e_test_assert ("e_bitvec_any 3", e_bitvec_any (&bv, 54, 60));
     e_test_assert ("e_bitvec_any 4", !e_bitvec_any (&bv, 55, 60));
     e_test_assert ("e_bitvec_any 5", !e_bitvec_any (&bv, 4, 4));
+
+    /* e_bitvec_count, e_bitvec_find_first_set, e_bitvec_find_next_set */
+    e_test_assert_eq ("e_bitvec_count", size_t, e_bitvec_count (&bv, 0, 64), 21);
+    e_test_assert_eq ("e_bitvec_count range", size_t, e_bitvec_count (&bv, 22, 40), 6);
+    e_test_assert_eq ("e_bitvec_count empty", size_t, e_bitvec_count (&bv, 40, 40), 0);
+    e_test_assert_eq ("e_bitvec_find_first_set", size_t, e_bitvec_find_first_set (&bv), 22);
+    e_test_assert_eq ("e_bitvec_find_next_set", size_t, e_bitvec_find_next_set (&bv, 23), 35);
+    e_test_assert_eq ("e_bitvec_find_next_set same", size_t, e_bitvec_find_next_set (&bv, 35), 35);
+    e_test_assert_eq ("e_bitvec_find_next_set none", size_t, e_bitvec_find_next_set (&bv, 55),
+                      E_BITVEC_NONE);
+    e_test_assert_eq ("e_bitvec_find_next_set out of range", size_t,
+                      e_bitvec_find_next_set (&bv, 64), E_BITVEC_NONE);
+
+    /* bit vectors that span several words and do not end on a word boundary */
+    bv = e_bitvec_init (big_data, 200);
+    e_test_assert_eq ("e_bitvec_find_first_set empty", size_t, e_bitvec_find_first_set (&bv),
+                      E_BITVEC_NONE);
+    for (i = 60; i < 200; i++) {
+        e_bitvec_set (&bv, i);
+    }
+    e_test_assert ("e_bitvec_all words", e_bitvec_all (&bv, 60, 200));
+    e_test_assert ("e_bitvec_all trimmed", e_bitvec_all (&bv, 60, 1000));
+    e_test_assert ("e_bitvec_any last bit", e_bitvec_any (&bv, 199, 1000));
+    e_test_assert_eq ("e_bitvec_count words", size_t, e_bitvec_count (&bv, 0, 200), 140);
+    e_test_assert_eq ("e_bitvec_count trimmed", size_t, e_bitvec_count (&bv, 100, 1000), 100);
+    e_bitvec_unset (&bv, 130);
+    e_test_assert ("e_bitvec_all words unset", !e_bitvec_all (&bv, 60, 200));
+    for (i = 60; i < 200; i++) {
+        e_bitvec_put (&bv, i, i % 7 == 0);
+    }
+    e_bitvec_set (&bv, 200);
+    e_test_assert ("e_bitvec_set out of range", !e_bitvec_any (&bv, 197, 200));
+    e_test_assert_eq ("e_bitvec_find_next_set words", size_t, e_bitvec_find_next_set (&bv, 64),
+                      70);
+    e_test_assert_eq ("e_bitvec_find_next_set end", size_t, e_bitvec_find_next_set (&bv, 197),
+                      E_BITVEC_NONE);
+    ok = 1;
+    expected = 63;
+    for (i = e_bitvec_find_first_set (&bv); i != E_BITVEC_NONE;
+         i = e_bitvec_find_next_set (&bv, i + 1)) {
+        if (i != expected) ok = 0;
+        expected += 7;
+    }
+    e_test_assert ("e_bitvec_find_next_set iteration", ok && expected == 203);
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+    ok = 1;
+    expected = 63;
+    e_bitvec_foreach_set (&bv, index) {
+        if (index != expected) ok = 0;
+        expected += 7;
+    }
+    e_test_assert ("e_bitvec_foreach_set", ok && expected == 203);
+#endif
+
+    test_bitvec_ops ();
+    test_bitvec_ranges ();
+    test_bitvec_rank ();
 }
@@ -0,0 +1,130 @@
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+
+# define E_CDA_IMPL
+# include "e_cda.h"
+# include "e_da.h"
+# include "e_test.h"
+
+# if !defined(__STDC_NO_THREADS__) && !defined(__MINGW32__)
+#  define TEST_CDA_THREADS
+#  include <threads.h>
+# endif
+
+# define TEST_CDA_THREAD_COUNT 4
+# define TEST_CDA_PER_THREAD   20000
+
+typedef E_Cda (int) Test_Cda_Ints;
+
+# ifdef TEST_CDA_THREADS
+static int
+test_cda_worker (void *arg)
+{
+    Test_Cda_Ints *cda = arg;
+    int i, batch[3];
+    size_t len;
+
+    for (i = 0; i < TEST_CDA_PER_THREAD; i++) {
+        if (i % 10 == 0 && i + 3 <= TEST_CDA_PER_THREAD) {
+            batch[0] = i;
+            batch[1] = i + 1;
+            batch[2] = i + 2;
+            e_cda_extend (cda, batch, 3);
+            i += 2;
+        } else {
+            e_cda_push (cda, i);
+        }
+        /* every committed item must already be written */
+        len = e_cda_len (cda);
+        if (len > 0 && *e_cda_nth (cda, len - 1) < 0) return 1;
+    }
+    return 0;
+}
+# endif
+
+void
+test_cda (void)
+{
+    Test_Cda_Ints cda = e_cda_init ();
+    E_Da (int) da = e_da_init ();
+    int items[200];
+    size_t i, index;
+    int ok;
+
+    /* e_cda_init */
+    e_test_assert_eq ("e_cda_init len", size_t, e_cda_len (&cda), 0);
+
+    /* e_cda_push, e_cda_extend, e_cda_nth (single-threaded) */
+    e_cda_push (&cda, 7);
+    for (i = 0; i < 200; i++) {
+        items[i] = (int) i;
+    }
+    index = e_cda_extend (&cda, items, 200);
+    e_test_assert_eq ("e_cda_extend index", size_t, index, 1);
+    e_test_assert_eq ("e_cda_extend len", size_t, e_cda_len (&cda), 201);
+    e_test_assert_eq ("e_cda_nth first", int, *e_cda_nth (&cda, 0), 7);
+    ok = 1;
+    for (i = 0; i < 200; i++) {
+        if (*e_cda_nth (&cda, i + 1) != (int) i) ok = 0;
+    }
+    e_test_assert ("e_cda_nth across segments", ok);
+
+    /* e_cda_to_da */
+    e_da_push (&da, -1);
+    e_cda_to_da (&cda, &da);
+    e_test_assert_eq ("e_cda_to_da len", size_t, e_da_len (&da), 202);
+    e_test_assert_eq ("e_cda_to_da first", int, *e_da_nth (&da, 1), 7);
+    e_test_assert_eq ("e_cda_to_da last", int, *e_da_last (&da), 199);
+    e_da_deinit (&da);
+
+    /* an append whose slot is reserved but not committed yet does not block later appends */
+    index = atomic_fetch_add (&cda.data.reserved, 1);
+    e_cda_push (&cda, 8);
+    e_test_assert_eq ("e_cda stalled len", size_t, e_cda_len (&cda), 201);
+    *e_cda_nth (&cda, index) = 9;
+    e_cda__commit (&cda.data, index, 1, sizeof (int));
+    e_test_assert_eq ("e_cda stalled commit len", size_t, e_cda_len (&cda), 203);
+    e_test_assert_eq ("e_cda stalled commit nth", int, *e_cda_nth (&cda, 202), 8);
+    e_cda_deinit (&cda);
+
+# ifdef TEST_CDA_THREADS
+    {
+        Test_Cda_Ints shared = e_cda_init ();
+        thrd_t threads[TEST_CDA_THREAD_COUNT];
+        int results[TEST_CDA_THREAD_COUNT];
+        long sum, expected;
+        E_Da (int) out = e_da_init ();
+
+        for (i = 0; i < TEST_CDA_THREAD_COUNT; i++) {
+            thrd_create (&threads[i], test_cda_worker, &shared);
+        }
+        ok = 1;
+        for (i = 0; i < TEST_CDA_THREAD_COUNT; i++) {
+            thrd_join (threads[i], &results[i]);
+            if (results[i] != 0) ok = 0;
+        }
+        e_test_assert ("e_cda concurrent len snapshot", ok);
+        e_test_assert_eq ("e_cda concurrent len", size_t, e_cda_len (&shared),
+                          TEST_CDA_THREAD_COUNT * TEST_CDA_PER_THREAD);
+
+        e_cda_to_da (&shared, &out);
+        sum = 0;
+        e_da_foreach (&out, it) {
+            sum += *it;
+        }
+        expected = (long) TEST_CDA_PER_THREAD * (TEST_CDA_PER_THREAD - 1) / 2;
+        expected *= TEST_CDA_THREAD_COUNT;
+        e_test_assert_eq ("e_cda concurrent items", long, sum, expected);
+        e_da_deinit (&out);
+        e_cda_deinit (&shared);
+    }
+# endif
+}
+
+#else /* __STDC_VERSION__ >= 201112L && !defined (__STDC_NO_ATOMICS__) */
+
+void
+test_cda (void)
+{
+}
+
+#endif /* __STDC_VERSION__ >= 201112L && !defined (__STDC_NO_ATOMICS__) */
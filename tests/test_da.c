@@ -1,15 +1,358 @@
+#ifdef __linux__
+# define _GNU_SOURCE
+# define E_CONFIG_DA_MREMAP
+#endif
 #define E_DA_IMPL
+#include "e_arena.h"
 #include "e_da.h"
 #include "e_macro.h"
 #include "e_test.h"
 
 #include <stddef.h>
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+# include <stdint.h>
+#endif
+
+#define INT_GREATER(a, b) ((a) > (b))
+
+E_DA_DECL_SORT (int_sort, int);
+E_DA_DECL_SORT (int_sort_desc, int);
+E_DA_IMPL_SORT (int_sort, int)
+E_DA_IMPL_SORT_BY (int_sort_desc, int, INT_GREATER)
+
+static unsigned long
+next_rand (unsigned long *state)
+{
+    *state = (*state * 1103515245UL + 12345UL) & 0x7fffffffUL;
+    return *state >> 8;
+}
+
+static void
+test_da_sort (void)
+{
+    E_Da (int) da = e_da_init ();
+    unsigned long state = 42;
+    int is_sorted;
+    long sum, sorted_sum;
+    size_t i;
+
+    /* e_da_sort (random, with many duplicates) */
+    sum = 0;
+    for (i = 0; i < 5000; i++) {
+        e_da_push (&da, (int) (next_rand (&state) % 1000) - 500);
+        sum += *e_da_last (&da);
+    }
+    e_da_sort (&da, int_sort);
+    is_sorted = 1;
+    sorted_sum = 0;
+    for (i = 0; i < e_da_len (&da); i++) {
+        if (i > 0 && *e_da_nth (&da, i - 1) > *e_da_nth (&da, i)) is_sorted = 0;
+        sorted_sum += *e_da_nth (&da, i);
+    }
+    e_test_assert ("e_da_sort random", is_sorted);
+    e_test_assert_eq ("e_da_sort random sum", long, sorted_sum, sum);
+
+    /* e_da_lower_bound, e_da_upper_bound */
+    e_test_assert_eq ("e_da_lower_bound first", size_t, e_da_lower_bound (&da, int_sort, -1000), 0);
+    e_test_assert_eq ("e_da_lower_bound last", size_t, e_da_lower_bound (&da, int_sort, 1000),
+                      e_da_len (&da));
+    i = e_da_lower_bound (&da, int_sort, 17);
+    e_test_assert ("e_da_lower_bound", *e_da_nth (&da, i) >= 17 && *e_da_nth (&da, i - 1) < 17);
+    i = e_da_upper_bound (&da, int_sort, 17);
+    e_test_assert ("e_da_upper_bound", *e_da_nth (&da, i) > 17 && *e_da_nth (&da, i - 1) <= 17);
+
+    /* e_da_sort (sorted input, custom ordering) */
+    e_da_sort (&da, int_sort_desc);
+    is_sorted = 1;
+    for (i = 1; i < e_da_len (&da); i++) {
+        if (*e_da_nth (&da, i - 1) < *e_da_nth (&da, i)) is_sorted = 0;
+    }
+    e_test_assert ("e_da_sort sorted desc", is_sorted);
+
+    /* e_da_sort (all equal) */
+    for (i = 0; i < e_da_len (&da); i++) {
+        *e_da_nth (&da, i) = 7;
+    }
+    e_da_sort (&da, int_sort);
+    e_test_assert_eq ("e_da_sort equal", int, *e_da_nth (&da, 100), 7);
+
+    e_da_deinit (&da);
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+    {
+        E_Da (uint64_t) u64s = e_da_init ();
+        E_Da (int32_t) i32s = e_da_init ();
+        E_Da (double) f64s = e_da_init ();
+        double f64_vals[] = {3.5, -0.25, 1e10, -1e10, 0.0, -7.0, 2.0};
+        double f64_sorted[] = {-1e10, -7.0, -0.25, 0.0, 2.0, 3.5, 1e10};
+
+        /* e_da_radix_sort_u64 */
+        for (i = 0; i < 3000; i++) {
+            e_da_push (&u64s, ((uint64_t) next_rand (&state) << 40) ^ next_rand (&state));
+        }
+        e_da_radix_sort_u64 (&u64s);
+        is_sorted = 1;
+        for (i = 1; i < e_da_len (&u64s); i++) {
+            if (*e_da_nth (&u64s, i - 1) > *e_da_nth (&u64s, i)) is_sorted = 0;
+        }
+        e_test_assert ("e_da_radix_sort_u64", is_sorted);
+
+        /* e_da_radix_sort_i32 */
+        for (i = 0; i < 3000; i++) {
+            e_da_push (&i32s, (int32_t) next_rand (&state) - (int32_t) 0x400000);
+        }
+        e_da_radix_sort_i32 (&i32s);
+        is_sorted = 1;
+        for (i = 1; i < e_da_len (&i32s); i++) {
+            if (*e_da_nth (&i32s, i - 1) > *e_da_nth (&i32s, i)) is_sorted = 0;
+        }
+        e_test_assert ("e_da_radix_sort_i32", is_sorted);
+
+        /* e_da_radix_sort_f64 */
+        e_da_extend (&f64s, f64_vals, E_COUNTOF (f64_vals));
+        e_da_radix_sort_f64 (&f64s);
+        e_test_assert_mem_eq ("e_da_radix_sort_f64", e_da_first (&f64s), f64_sorted,
+                              sizeof (f64_sorted));
+
+        e_da_deinit (&u64s);
+        e_da_deinit (&i32s);
+        e_da_deinit (&f64s);
+    }
+#endif
+}
+
+static void
+test_da_small (void)
+{
+    E_Da_Small (int, 4) small;
+    int vals[] = {3, 4, 5, 6, 7};
+    size_t i;
+
+    /* e_da_small_init */
+    e_da_small_init (&small);
+    e_test_assert_eq ("e_da_small_init len", size_t, e_da_len (&small), 0);
+
+    /* e_da_push (inline) */
+    e_da_push (&small, 1);
+    e_da_push (&small, 2);
+    e_test_assert_eq ("e_da_small push len", size_t, e_da_len (&small), 2);
+    e_test_assert_ptr_eq ("e_da_small push inline", e_da_first (&small), small.small.items);
+
+    /* e_da_extend (spill to heap) */
+    e_da_extend (&small, vals, E_COUNTOF (vals));
+    e_test_assert_eq ("e_da_small extend len", size_t, e_da_len (&small), 7);
+    e_test_assert ("e_da_small extend heap", e_da_first (&small) != small.small.items);
+    for (i = 0; i < e_da_len (&small); i++) {
+        e_test_assert_eq ("e_da_small extend items", int, *e_da_nth (&small, i), (int) i + 1);
+    }
+
+    /* e_da_pop */
+    e_da_pop (&small, 3);
+    e_test_assert_eq ("e_da_small pop", int, *e_da_last (&small), 4);
+
+    e_da_deinit (&small);
+}
+
+static void
+test_da_capacity (void)
+{
+    E_Da (int) da = e_da_init ();
+    size_t i;
+
+    /* e_da_reserve_exact */
+    e_da_reserve_exact (&da, 5);
+    e_test_assert_eq ("e_da_reserve_exact cap", size_t, da.data.cap, 5);
+    e_da_reserve_exact (&da, 3);
+    e_test_assert_eq ("e_da_reserve_exact smaller cap", size_t, da.data.cap, 5);
+
+    /* e_da_set_growth */
+    e_da_set_growth (&da, E_DA_GROWTH_1_5);
+    e_da_reserve (&da, 6);
+    e_test_assert_eq ("e_da_set_growth 1.5", size_t, da.data.cap, 7);
+    e_da_set_growth (&da, E_DA_GROWTH_1_25);
+    e_da_reserve (&da, 8);
+    e_test_assert_eq ("e_da_set_growth 1.25", size_t, da.data.cap, 8);
+    e_da_set_growth (&da, E_DA_GROWTH_2);
+    e_da_reserve (&da, 9);
+    e_test_assert_eq ("e_da_set_growth 2", size_t, da.data.cap, 16);
+
+    /* e_da_shrink_to_fit */
+    e_da_push (&da, 1);
+    e_da_push (&da, 2);
+    e_da_shrink_to_fit (&da);
+    e_test_assert_eq ("e_da_shrink_to_fit cap", size_t, da.data.cap, 2);
+    e_test_assert_eq ("e_da_shrink_to_fit item", int, *e_da_last (&da), 2);
+    e_da_pop (&da, 2);
+    e_da_shrink_to_fit (&da);
+    e_test_assert_eq ("e_da_shrink_to_fit empty cap", size_t, da.data.cap, 0);
+    e_test_assert_null ("e_da_shrink_to_fit empty ptr", da.data.ptr);
+
+#if defined(E_CONFIG_DA_MREMAP) && defined(__linux__)
+    /* e_da_mremap_allocator */
+    da.data.allocator = &e_da_mremap_allocator;
+    for (i = 0; i < 1000000; i++) {
+        e_da_push (&da, (int) i);
+    }
+    e_test_assert_eq ("e_da_mremap_allocator first", int, *e_da_first (&da), 0);
+    e_test_assert_eq ("e_da_mremap_allocator nth", int, *e_da_nth (&da, 654321), 654321);
+    e_test_assert_eq ("e_da_mremap_allocator last", int, *e_da_last (&da), 999999);
+    e_da_pop (&da, 999990);
+    e_da_shrink_to_fit (&da);
+    e_test_assert_eq ("e_da_mremap_allocator shrink", int, *e_da_last (&da), 9);
+#else
+    (void) i;
+#endif
+
+    e_da_deinit (&da);
+}
+
+static void
+test_da_edit (void)
+{
+    E_Da (int) da = e_da_init ();
+    E_Da32 (int) da32 = e_da32_init ();
+    int vals[] = {10, 11, 12};
+    int expected_insert[] = {0, 10, 11, 12, 1, 2, 3, 42};
+    int expected_erase[] = {0, 10, 2, 42};
+    int expected_splice[] = {0, 11, 12, 42};
+    int expected_swap[] = {42, 11, 12};
+    size_t i;
+
+    for (i = 0; i < 4; i++) {
+        e_da_push (&da, (int) i);
+    }
+
+    /* e_da_insert_n, e_da_insert */
+    e_da_insert_n (&da, 1, vals, 3);
+    e_da_insert (&da, 7, 42);
+    e_test_assert_eq ("e_da_insert_n len", size_t, e_da_len (&da), 8);
+    e_test_assert_mem_eq ("e_da_insert_n items", e_da_first (&da), expected_insert,
+                          sizeof (expected_insert));
+
+    /* e_da_erase_range */
+    e_da_erase_range (&da, 2, 3);
+    e_test_assert_eq ("e_da_erase_range len", size_t, e_da_len (&da), 5);
+    e_da_erase_range (&da, 3, 1);
+    e_test_assert_mem_eq ("e_da_erase_range items", e_da_first (&da), expected_erase,
+                          sizeof (expected_erase));
+    e_da_erase_range (&da, 4, 10);
+    e_test_assert_eq ("e_da_erase_range at end", size_t, e_da_len (&da), 4);
+
+    /* e_da_splice */
+    e_da_splice (&da, 1, 2, vals + 1, 2);
+    e_test_assert_mem_eq ("e_da_splice same count", e_da_first (&da), expected_splice,
+                          sizeof (expected_splice));
+    e_da_splice (&da, 1, 0, vals, 1);
+    e_da_splice (&da, 1, 1, vals, 0);
+    e_test_assert_mem_eq ("e_da_splice insert and remove", e_da_first (&da), expected_splice,
+                          sizeof (expected_splice));
+
+    /* e_da_swap_remove */
+    e_da_swap_remove (&da, 0);
+    e_test_assert_mem_eq ("e_da_swap_remove", e_da_first (&da), expected_swap,
+                          sizeof (expected_swap));
+    e_da_swap_remove (&da, 2);
+    e_test_assert_eq ("e_da_swap_remove last", size_t, e_da_len (&da), 2);
+
+    /* e_da_retain */
+    e_da_pop (&da, 2);
+    for (i = 0; i < 10; i++) {
+        e_da_push (&da, (int) i);
+    }
+    e_da_retain (&da, it, *it % 3 != 0);
+    e_test_assert_eq ("e_da_retain len", size_t, e_da_len (&da), 6);
+    e_test_assert_eq ("e_da_retain first", int, *e_da_first (&da), 1);
+    e_test_assert_eq ("e_da_retain nth", int, *e_da_nth (&da, 3), 5);
+    e_test_assert_eq ("e_da_retain last", int, *e_da_last (&da), 8);
+    e_da_retain (&da, it, 0);
+    e_test_assert_eq ("e_da_retain none", size_t, e_da_len (&da), 0);
+    e_da_retain (&da, it, 1);
+    e_test_assert_eq ("e_da_retain empty", size_t, e_da_len (&da), 0);
+
+    e_da32_extend (&da32, vals, 3);
+    e_da_retain (&da32, it, *it != 11);
+    e_test_assert_eq ("e_da_retain E_Da32", int, *e_da_last (&da32), 12);
+    e_test_assert_eq ("e_da_retain E_Da32 len", size_t, e_da_len (&da32), 2);
+
+    e_da32_deinit (&da32);
+    e_da_deinit (&da);
+}
+
+static void
+test_da32 (void)
+{
+    E_Da32 (int) da = e_da32_init ();
+    int vals[] = {4, 5, 6};
+    int *p;
+    size_t i;
+    int ok;
+
+    e_test_assert ("E_Da32 header size", sizeof (da) == sizeof (void *) + 8);
+
+    /* e_da32_push, e_da32_extend */
+    e_da32_push (&da, 1);
+    e_da32_push_ref (&da, &vals[0]);
+    e_da32_extend (&da, vals + 1, 2);
+    e_test_assert_eq ("e_da32_push len", size_t, e_da_len (&da), 4);
+    e_test_assert_eq ("e_da32_push cap", size_t, da.data.cap, 4);
+    e_test_assert_eq ("e_da32_push first", int, *e_da_first (&da), 1);
+    e_test_assert_eq ("e_da32_push nth", int, *e_da_nth (&da, 2), 5);
+    e_test_assert_eq ("e_da32_push last", int, *e_da_last (&da), 6);
+
+    /* growth by 1.5 */
+    p = e_da32_push_uninit (&da);
+    *p = 7;
+    e_test_assert_eq ("e_da32_push_uninit cap", size_t, da.data.cap, 6);
+    e_test_assert_eq ("e_da32_push_uninit", int, *e_da_last (&da), 7);
+    p = e_da32_extend_uninit (&da, 100);
+    for (i = 0; i < 100; i++) {
+        p[i] = (int) i;
+    }
+    e_test_assert_eq ("e_da32_extend_uninit len", size_t, e_da_len (&da), 105);
+    ok = 1;
+    for (i = 0; i < 100; i++) {
+        if (*e_da_nth (&da, i + 5) != (int) i) ok = 0;
+    }
+    e_test_assert ("e_da32_extend_uninit items", ok);
+
+    /* e_da32_pop, e_da32_shrink_to_fit, e_da32_reserve */
+    e_da32_pop (&da, 101);
+    e_da32_shrink_to_fit (&da);
+    e_test_assert_eq ("e_da32_shrink_to_fit cap", size_t, da.data.cap, 4);
+    e_test_assert_eq ("e_da32_shrink_to_fit last", int, *e_da_last (&da), 6);
+    e_da32_reserve (&da, 5);
+    e_test_assert_eq ("e_da32_reserve cap", size_t, da.data.cap, 6);
+    e_da32_pop (&da, 10);
+    e_test_assert_eq ("e_da32_pop too many", size_t, e_da_len (&da), 0);
+    e_da32_shrink_to_fit (&da);
+    e_test_assert_null ("e_da32_shrink_to_fit empty", da.data.ptr);
+    e_da32_push (&da, 1);
+    e_da32_shrink_to_fit (&da);
+    e_da32_push (&da, 2);
+    e_test_assert_eq ("e_da32_push after shrink to one", size_t, da.data.cap, 2);
+    e_test_assert_eq ("e_da32_push after shrink to one last", int, *e_da_last (&da), 2);
+    e_da32_pop (&da, 2);
+
+    /* e_da_sort works on E_Da32 */
+    e_da32_push (&da, 3);
+    e_da32_push (&da, 1);
+    e_da32_push (&da, 2);
+    e_da_sort (&da, int_sort);
+    e_test_assert ("e_da_sort E_Da32", *e_da_nth (&da, 0) == 1 && *e_da_nth (&da, 2) == 3);
+
+    e_da32_deinit (&da);
+}
 
 void
 test_da (void)
 {
     int vals[] = {4, 5, 6};
+    unsigned char arena_buf[1024];
+    unsigned char *arena_start;
+    E_Allocator allocator;
+    E_Arena arena;
     int *ptr;
+    int i;
 
     /* e_da_init */
     E_Da (int) da = e_da_init ();
@@ -55,4 +398,37 @@ test_da (void)
 #endif
 
     e_da_deinit (&da);
+
+    /* e_da_init_with_allocator */
+    arena_start = arena_buf;
+    arena_start += ((size_t) E_ALIGN_MAX - (size_t) arena_start % (size_t) E_ALIGN_MAX) %
+                   (size_t) E_ALIGN_MAX;
+    arena = e_arena_init (arena_start, 512);
+    allocator = e_arena_allocator (&arena);
+    {
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+        E_Da (int) arena_da = e_da_init_with_allocator (&allocator);
+#else
+        E_Da (int) arena_da = e_da_init ();
+        arena_da.data.allocator = &allocator;
+#endif
+        for (i = 0; i < 40; i++) {
+            e_da_push (&arena_da, i);
+        }
+        e_test_assert_eq ("e_da_init_with_allocator len", size_t, e_da_len (&arena_da), 40);
+        e_test_assert_eq ("e_da_init_with_allocator nth", int, *e_da_nth (&arena_da, 39), 39);
+        e_test_assert ("e_da_init_with_allocator in arena",
+                       (unsigned char *) e_da_first (&arena_da) == arena_start);
+        e_test_assert_eq ("e_da_init_with_allocator arena usage", size_t,
+                          e_arena_allocated_byte_count (&arena), 64 * sizeof (int));
+        e_da_deinit (&arena_da);
+        e_test_assert_eq ("e_da_init_with_allocator deinit", size_t,
+                          e_arena_allocated_byte_count (&arena), 0);
+    }
+
+    test_da_small ();
+    test_da_capacity ();
+    test_da_sort ();
+    test_da_edit ();
+    test_da32 ();
 }
@@ -0,0 +1,209 @@
+#define E_DEQUE_IMPL
+#include "e_deque.h"
+#include "e_test.h"
+
+#define TEST_DEQUE_MODEL_CAP  4096
+#define TEST_DEQUE_GROWTH_CAP 65536
+
+static unsigned long
+test_deque_rand (unsigned long *state)
+{
+    *state = (*state * 1103515245UL + 12345UL) & 0x7fffffffUL;
+    return *state >> 8;
+}
+
+/* grow the block map several times while popping at both ends, so that blocks are pushed and
+ * popped while their pointers are being moved to a new map */
+static void
+test_deque_growth (void)
+{
+    E_Deque (int) deque = e_deque_init ();
+    E_Deque (int) edges = e_deque_init ();
+    static int model[TEST_DEQUE_GROWTH_CAP];
+    size_t model_head, model_len, i, j, n;
+    unsigned long state = 3;
+    int item, ok, migrating;
+
+    model_head = TEST_DEQUE_GROWTH_CAP / 2;
+    model_len = 0;
+    ok = 1;
+    migrating = 0;
+    for (i = 0; model_head > 0 && model_head + model_len < TEST_DEQUE_GROWTH_CAP; i++) {
+        switch (test_deque_rand (&state) % 8) {
+        case 0:
+            if (e_deque_pop_back (&deque, &item) != (model_len > 0)) ok = 0;
+            if (model_len == 0) break;
+            model_len -= 1;
+            if (item != model[model_head + model_len]) ok = 0;
+            break;
+        case 1:
+            if (e_deque_pop_front (&deque, &item) != (model_len > 0)) ok = 0;
+            if (model_len == 0) break;
+            if (item != model[model_head]) ok = 0;
+            model_head += 1;
+            model_len -= 1;
+            break;
+        case 2:
+        case 3:
+        case 4:
+            model_head -= 1;
+            model_len += 1;
+            model[model_head] = (int) i;
+            e_deque_push_front (&deque, (int) i);
+            break;
+        default:
+            model[model_head + model_len] = (int) i;
+            model_len += 1;
+            e_deque_push_back (&deque, (int) i);
+            break;
+        }
+        if (deque.data.old_map != NULL) migrating = 1;
+        if (i % 512 == 0) {
+            if (e_deque_len (&deque) != model_len) ok = 0;
+            for (j = 0; j < model_len; j++) {
+                if (*e_deque_nth (&deque, j) != model[model_head + j]) ok = 0;
+            }
+        }
+    }
+    e_test_assert ("e_deque map growth", ok);
+    e_test_assert ("e_deque map growth migrating", migrating);
+    e_deque_deinit (&deque);
+
+    /* pop the blocks at both ends right after the map has grown, before they have been moved */
+    for (i = 0; edges.data.map_cap == 0 || edges.data.block_count < edges.data.map_cap; i++) {
+        e_deque_push_back (&edges, (int) i);
+    }
+    e_deque_push_front (&edges, -1);
+    e_test_assert ("e_deque map growth started", edges.data.old_map != NULL);
+    n = e_deque__block_items (sizeof (int));
+    for (j = 0; j < 2 * n; j++) {
+        e_deque_pop_back (&edges, NULL);
+    }
+    for (j = 0; j < 4 * n; j++) {
+        e_deque_pop_front (&edges, NULL);
+    }
+    /* the blocks that have not been moved yet must all still be in use */
+    e_test_assert ("e_deque map growth pop range",
+                   ((edges.data.migrate_head - edges.data.map_head) & (edges.data.map_cap - 1)) +
+                           edges.data.migrate_len <=
+                       edges.data.block_count);
+    for (j = 0; j < 2 * n; j++) {
+        e_deque_push_back (&edges, 7);
+    }
+    for (j = 0; j < 4 * n; j++) {
+        e_deque_push_front (&edges, 7);
+    }
+    ok = 1;
+    for (j = 0; j < e_deque_len (&edges); j++) {
+        item = *e_deque_nth (&edges, j);
+        if (j < 4 * n || j >= e_deque_len (&edges) - 2 * n) {
+            if (item != 7) ok = 0;
+        } else if (item != (int) j - 1) {
+            ok = 0;
+        }
+    }
+    e_test_assert ("e_deque map growth pop", ok);
+    e_deque_deinit (&edges);
+}
+
+void
+test_deque (void)
+{
+    E_Deque (int) deque = e_deque_init ();
+    static int model[TEST_DEQUE_MODEL_CAP];
+    size_t model_head, model_len;
+    unsigned long state = 7;
+    int item, *first, *middle;
+    size_t i;
+    int ok;
+
+    /* e_deque_init */
+    e_test_assert_eq ("e_deque_init len", size_t, e_deque_len (&deque), 0);
+    e_test_assert ("e_deque_pop_back empty", !e_deque_pop_back (&deque, &item));
+    e_test_assert ("e_deque_pop_front empty", !e_deque_pop_front (&deque, &item));
+
+    /* e_deque_push_back, e_deque_push_front, e_deque_nth */
+    e_deque_push_back (&deque, 1);
+    e_deque_push_front (&deque, 0);
+    item = 2;
+    e_deque_push_back_ref (&deque, &item);
+    item = -1;
+    e_deque_push_front_ref (&deque, &item);
+    e_test_assert_eq ("e_deque_push len", size_t, e_deque_len (&deque), 4);
+    e_test_assert_eq ("e_deque_first", int, *e_deque_first (&deque), -1);
+    e_test_assert_eq ("e_deque_nth", int, *e_deque_nth (&deque, 2), 1);
+    e_test_assert_eq ("e_deque_last", int, *e_deque_last (&deque), 2);
+
+    /* items never move */
+    first = e_deque_first (&deque);
+    middle = e_deque_nth (&deque, 2);
+    for (i = 0; i < 1000; i++) {
+        e_deque_push_back (&deque, (int) i + 3);
+        e_deque_push_front (&deque, -(int) i - 2);
+    }
+    e_test_assert_ptr_eq ("e_deque_push stable first", e_deque_nth (&deque, 1000), first);
+    e_test_assert_ptr_eq ("e_deque_push stable middle", e_deque_nth (&deque, 1002), middle);
+    ok = 1;
+    for (i = 0; i < e_deque_len (&deque); i++) {
+        if (*e_deque_nth (&deque, i) != (int) i - 1001) ok = 0;
+    }
+    e_test_assert ("e_deque_push order", ok);
+
+    /* e_deque_pop_back, e_deque_pop_front */
+    e_test_assert ("e_deque_pop_back", e_deque_pop_back (&deque, &item));
+    e_test_assert_eq ("e_deque_pop_back out", int, item, 1002);
+    e_test_assert ("e_deque_pop_front", e_deque_pop_front (&deque, &item));
+    e_test_assert_eq ("e_deque_pop_front out", int, item, -1001);
+    while (e_deque_pop_front (&deque, NULL)) {
+    }
+    e_test_assert_eq ("e_deque_pop len", size_t, e_deque_len (&deque), 0);
+    e_test_assert_eq ("e_deque_pop block_count", size_t, deque.data.block_count, 0);
+    e_test_assert_eq ("e_deque_pop cache", size_t, deque.data.cache_len, E_DEQUE__BLOCK_CACHE);
+
+    /* empty blocks are reused */
+    first = deque.data.cache[deque.data.cache_len - 1];
+    e_deque_push_back (&deque, 5);
+    e_test_assert_ptr_eq ("e_deque block cache", e_deque_first (&deque), first);
+    e_deque_pop_back (&deque, NULL);
+
+    /* random operations compared against a model */
+    model_head = TEST_DEQUE_MODEL_CAP / 2;
+    model_len = 0;
+    ok = 1;
+    for (i = 0; i < 20000; i++) {
+        switch (test_deque_rand (&state) % 4) {
+        case 0:
+            if (model_head + model_len == TEST_DEQUE_MODEL_CAP) break;
+            model[model_head + model_len] = (int) i;
+            model_len += 1;
+            e_deque_push_back (&deque, (int) i);
+            break;
+        case 1:
+            if (model_head == 0) break;
+            model_head -= 1;
+            model_len += 1;
+            model[model_head] = (int) i;
+            e_deque_push_front (&deque, (int) i);
+            break;
+        case 2:
+            if (e_deque_pop_back (&deque, &item) != (model_len > 0)) ok = 0;
+            if (model_len == 0) break;
+            model_len -= 1;
+            if (item != model[model_head + model_len]) ok = 0;
+            break;
+        default:
+            if (e_deque_pop_front (&deque, &item) != (model_len > 0)) ok = 0;
+            if (model_len == 0) break;
+            if (item != model[model_head]) ok = 0;
+            model_head += 1;
+            model_len -= 1;
+            break;
+        }
+        if (e_deque_len (&deque) != model_len) ok = 0;
+        if (model_len > 0 && *e_deque_nth (&deque, 0) != model[model_head]) ok = 0;
+    }
+    e_test_assert ("e_deque random operations", ok);
+    e_deque_deinit (&deque);
+
+    test_deque_growth ();
+}
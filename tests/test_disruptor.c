@@ -0,0 +1,174 @@
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+
+# define E_DISRUPTOR_IMPL
+# include "e_disruptor.h"
+# include "e_test.h"
+
+# if !defined(__STDC_NO_THREADS__) && !defined(__MINGW32__)
+#  define TEST_DISRUPTOR_THREADS
+#  include <threads.h>
+# endif
+
+# define TEST_DISRUPTOR_COUNT     100000
+# define TEST_DISRUPTOR_CONSUMERS 3
+
+typedef E_Disruptor (unsigned int) Test_Disruptor_Uints;
+
+# ifdef TEST_DISRUPTOR_THREADS
+typedef struct {
+    Test_Disruptor_Uints *disruptor;
+    size_t consumer;
+    int ok;
+} Test_Disruptor_Consumer;
+
+static int
+test_disruptor_producer (void *arg)
+{
+    Test_Disruptor_Uints *disruptor = arg;
+    unsigned int i, *slot;
+
+    for (i = 0; i < TEST_DISRUPTOR_COUNT; i++) {
+        if (i % 2 == 0) {
+            e_disruptor_push_wait (disruptor, i);
+        } else {
+            slot = e_disruptor_claim_wait (disruptor);
+            *slot = i;
+            e_disruptor_publish (disruptor);
+        }
+    }
+    return 0;
+}
+
+static int
+test_disruptor_consumer (void *arg)
+{
+    Test_Disruptor_Consumer *consumer = arg;
+    unsigned int next = 0, item;
+    size_t i, n;
+
+    while (next < TEST_DISRUPTOR_COUNT) {
+        if (consumer->consumer == 0) {
+            e_disruptor_pop_wait (consumer->disruptor, 0, &item);
+            if (item != next) consumer->ok = 0;
+            next += 1;
+            continue;
+        }
+        n = e_disruptor_available (consumer->disruptor, consumer->consumer);
+        if (n == 0) {
+            thrd_yield ();
+            continue;
+        }
+        for (i = 0; i < n; i++) {
+            if (*e_disruptor_at (consumer->disruptor, consumer->consumer, i) != next) {
+                consumer->ok = 0;
+            }
+            next += 1;
+        }
+        e_disruptor_consume (consumer->disruptor, consumer->consumer, n);
+    }
+    return 0;
+}
+# endif
+
+void
+test_disruptor (void)
+{
+    Test_Disruptor_Uints disruptor;
+    unsigned int item, next, *slot;
+    int ok;
+    size_t i;
+
+    /* e_disruptor_init */
+    e_test_assert ("e_disruptor_init not power of two", !e_disruptor_init (&disruptor, 12, 2));
+    e_test_assert ("e_disruptor_init too small", !e_disruptor_init (&disruptor, 1, 2));
+    e_test_assert ("e_disruptor_init no consumers", !e_disruptor_init (&disruptor, 4, 0));
+    e_test_assert ("e_disruptor_init", e_disruptor_init (&disruptor, 4, 3));
+    e_test_assert_eq ("e_disruptor_cap", size_t, e_disruptor_cap (&disruptor), 4);
+    e_disruptor_depend (&disruptor, 2, 1);
+
+    /* e_disruptor_push, e_disruptor_claim, e_disruptor_publish */
+    e_test_assert ("e_disruptor_pop empty", !e_disruptor_pop (&disruptor, 0, &item));
+    e_test_assert ("e_disruptor_push", e_disruptor_push (&disruptor, 10));
+    slot = e_disruptor_claim (&disruptor);
+    e_test_assert ("e_disruptor_claim", slot != NULL);
+    if (slot != NULL) *slot = 11;
+    e_test_assert_ptr_eq ("e_disruptor_claim again", e_disruptor_claim (&disruptor), slot);
+    e_test_assert_eq ("e_disruptor_available unpublished", size_t,
+                      e_disruptor_available (&disruptor, 0), 1);
+    e_disruptor_publish (&disruptor);
+    e_disruptor_push_wait (&disruptor, 12);
+    e_disruptor_push_wait (&disruptor, 13);
+    e_test_assert ("e_disruptor_push full", !e_disruptor_push (&disruptor, 14));
+    e_test_assert_null ("e_disruptor_claim full", e_disruptor_claim (&disruptor));
+
+    /* every consumer reads every item */
+    e_test_assert_eq ("e_disruptor_available", size_t, e_disruptor_available (&disruptor, 0), 4);
+    e_test_assert_eq ("e_disruptor_available dependency", size_t,
+                      e_disruptor_available (&disruptor, 2), 0);
+    e_test_assert ("e_disruptor_pop", e_disruptor_pop (&disruptor, 0, &item) && item == 10);
+    e_test_assert ("e_disruptor_pop NULL", e_disruptor_pop (&disruptor, 0, NULL));
+    e_test_assert ("e_disruptor_push slowest consumer", !e_disruptor_push (&disruptor, 14));
+    e_test_assert_eq ("e_disruptor_at", unsigned int, *e_disruptor_at (&disruptor, 1, 1), 11);
+    e_disruptor_consume (&disruptor, 1, 3);
+    e_test_assert_eq ("e_disruptor_consume", size_t, e_disruptor_available (&disruptor, 1), 1);
+    e_test_assert_eq ("e_disruptor_available after dependency", size_t,
+                      e_disruptor_available (&disruptor, 2), 3);
+    e_disruptor_consume (&disruptor, 2, 10);
+    e_test_assert_eq ("e_disruptor_consume limited", size_t,
+                      e_disruptor_available (&disruptor, 2), 0);
+
+    /* wrapping around */
+    e_test_assert ("e_disruptor_push after consume", e_disruptor_push (&disruptor, 14));
+    e_test_assert ("e_disruptor_push until slowest", e_disruptor_push (&disruptor, 15));
+    e_test_assert ("e_disruptor_push full again", !e_disruptor_push (&disruptor, 16));
+    e_disruptor_consume (&disruptor, 0, 10);
+    e_disruptor_consume (&disruptor, 1, 10);
+    e_disruptor_consume (&disruptor, 2, 10);
+    ok = 1;
+    for (next = 16; next < 30; next++) {
+        if (!e_disruptor_push (&disruptor, next)) ok = 0;
+        for (i = 0; i < 3; i++) {
+            if (!e_disruptor_pop (&disruptor, i, &item) || item != next) ok = 0;
+        }
+    }
+    e_test_assert ("e_disruptor wrap around", ok);
+    e_test_assert ("e_disruptor_pop empty again", !e_disruptor_pop (&disruptor, 1, &item));
+    e_disruptor_deinit (&disruptor);
+
+# ifdef TEST_DISRUPTOR_THREADS
+    {
+        Test_Disruptor_Consumer consumers[TEST_DISRUPTOR_CONSUMERS];
+        thrd_t consumer_threads[TEST_DISRUPTOR_CONSUMERS];
+        thrd_t producer;
+
+        e_disruptor_init (&disruptor, 64, TEST_DISRUPTOR_CONSUMERS);
+        e_disruptor_depend (&disruptor, 2, 1);
+        for (i = 0; i < TEST_DISRUPTOR_CONSUMERS; i++) {
+            consumers[i].disruptor = &disruptor;
+            consumers[i].consumer = i;
+            consumers[i].ok = 1;
+            thrd_create (&consumer_threads[i], test_disruptor_consumer, &consumers[i]);
+        }
+        thrd_create (&producer, test_disruptor_producer, &disruptor);
+        thrd_join (producer, NULL);
+        ok = 1;
+        for (i = 0; i < TEST_DISRUPTOR_CONSUMERS; i++) {
+            thrd_join (consumer_threads[i], NULL);
+            if (!consumers[i].ok) ok = 0;
+        }
+        e_test_assert ("e_disruptor concurrent order", ok);
+        e_test_assert_eq ("e_disruptor concurrent available", size_t,
+                          e_disruptor_available (&disruptor, 2), 0);
+        e_disruptor_deinit (&disruptor);
+    }
+# endif
+}
+
+#else /* __STDC_VERSION__ >= 201112L && !defined (__STDC_NO_ATOMICS__) */
+
+void
+test_disruptor (void)
+{
+}
+
+#endif /* __STDC_VERSION__ >= 201112L && !defined (__STDC_NO_ATOMICS__) */
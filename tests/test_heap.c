@@ -0,0 +1,136 @@
+#include "e_heap.h"
+#include "e_test.h"
+
+typedef struct {
+    int priority;
+    size_t index;
+} Test_Heap_Node;
+
+typedef Test_Heap_Node *Test_Heap_Node_Ptr;
+
+#define TEST_HEAP_GREATER(a, b)       ((a) > (b))
+#define TEST_HEAP_NODE_LESS(a, b)     ((a)->priority < (b)->priority)
+#define TEST_HEAP_NODE_SET_INDEX(n, i) ((n)->index = (i))
+
+E_HEAP_DECL (test_int_heap, int);
+E_HEAP_DECL (test_int_max_heap4, int);
+E_HEAP_DECL (test_node_heap, Test_Heap_Node_Ptr);
+E_HEAP_IMPL (test_int_heap, int)
+E_HEAP_IMPL_BY (test_int_max_heap4, int, TEST_HEAP_GREATER, 4)
+E_HEAP_IMPL_INDEXED (test_node_heap, Test_Heap_Node_Ptr, TEST_HEAP_NODE_LESS, 3,
+                     TEST_HEAP_NODE_SET_INDEX)
+
+static unsigned long
+test_heap_rand (unsigned long *state)
+{
+    *state = (*state * 1103515245UL + 12345UL) & 0x7fffffffUL;
+    return *state >> 8;
+}
+
+void
+test_heap (void)
+{
+    E_Heap (int) heap = e_heap_init ();
+    E_Heap (int) heap4 = e_heap_init ();
+    E_Da (int) da = e_da_init ();
+    E_Heap (Test_Heap_Node_Ptr) nodes = e_heap_init ();
+    Test_Heap_Node node_storage[50];
+    Test_Heap_Node_Ptr node, *node_top;
+    unsigned long state = 42;
+    int item, prev;
+    int *top;
+    size_t i;
+    int ok;
+
+    /* e_heap_init, e_heap_peek */
+    e_test_assert_eq ("e_heap_init len", size_t, e_heap_len (&heap), 0);
+    e_test_assert_null ("e_heap_peek empty", e_heap_peek (&heap));
+    e_test_assert ("e_heap_pop empty", !e_heap_pop (&heap, test_int_heap, &item));
+
+    /* e_heap_push, e_heap_pop */
+    for (i = 0; i < 1000; i++) {
+        e_heap_push (&heap, test_int_heap, (int) (test_heap_rand (&state) % 500));
+    }
+    e_test_assert_eq ("e_heap_push len", size_t, e_heap_len (&heap), 1000);
+    ok = 1;
+    prev = -1;
+    for (i = 0; i < 1000; i++) {
+        top = e_heap_peek (&heap);
+        if (top == NULL || *top < prev) ok = 0;
+        if (!e_heap_pop (&heap, test_int_heap, &item)) {
+            ok = 0;
+            break;
+        }
+        if (item < prev) ok = 0;
+        prev = item;
+    }
+    e_test_assert ("e_heap_pop order", ok);
+    e_test_assert_eq ("e_heap_pop len", size_t, e_heap_len (&heap), 0);
+
+    /* e_heap_replace_top */
+    e_test_assert ("e_heap_replace_top empty", !e_heap_replace_top (&heap, test_int_heap, 5, NULL));
+    e_heap_push (&heap, test_int_heap, 3);
+    e_heap_push (&heap, test_int_heap, 8);
+    item = 0;
+    e_test_assert ("e_heap_replace_top", e_heap_replace_top (&heap, test_int_heap, 9, &item));
+    e_test_assert_eq ("e_heap_replace_top out", int, item, 3);
+    top = e_heap_peek (&heap);
+    e_test_assert ("e_heap_replace_top peek", top != NULL && *top == 5);
+    e_test_assert ("e_heap_pop NULL", e_heap_pop (&heap, test_int_heap, NULL));
+    top = e_heap_peek (&heap);
+    e_test_assert ("e_heap_pop NULL peek", top != NULL && *top == 8);
+    e_heap_deinit (&heap);
+
+    /* e_heap_heapify (4-ary max-heap from a dynamic array) */
+    for (i = 0; i < 777; i++) {
+        e_da_push (&da, (int) (test_heap_rand (&state) % 1000));
+    }
+    heap4.data = da.data;
+    e_heap_heapify (&heap4, test_int_max_heap4);
+    ok = 1;
+    for (i = 1; i < e_heap_len (&heap4); i++) {
+        if (*e_da_nth (&heap4, i) > *e_da_nth (&heap4, (i - 1) / 4)) ok = 0;
+    }
+    e_test_assert ("e_heap_heapify invariant", ok);
+    ok = 1;
+    prev = 1000;
+    while (e_heap_pop (&heap4, test_int_max_heap4, &item)) {
+        if (item > prev) ok = 0;
+        prev = item;
+    }
+    e_test_assert ("e_heap_heapify order", ok);
+    e_heap_deinit (&heap4);
+
+    /* e_heap_update, e_heap_remove (3-ary heap with index tracking) */
+    for (i = 0; i < 50; i++) {
+        node_storage[i].priority = (int) (test_heap_rand (&state) % 100);
+        e_heap_push (&nodes, test_node_heap, &node_storage[i]);
+    }
+    ok = 1;
+    for (i = 0; i < 50; i++) {
+        if (*e_da_nth (&nodes, node_storage[i].index) != &node_storage[i]) ok = 0;
+    }
+    e_test_assert ("e_heap set_index", ok);
+    node_storage[17].priority = -5;
+    e_heap_update (&nodes, test_node_heap, node_storage[17].index);
+    node_top = e_heap_peek (&nodes);
+    e_test_assert ("e_heap_update decrease", node_top != NULL && *node_top == &node_storage[17]);
+    node_storage[17].priority = 1000;
+    e_heap_update (&nodes, test_node_heap, node_storage[17].index);
+    e_heap_remove (&nodes, test_node_heap, node_storage[17].index, &node);
+    e_test_assert_ptr_eq ("e_heap_remove out", node, &node_storage[17]);
+    e_heap_remove (&nodes, test_node_heap, node_storage[3].index, NULL);
+    e_test_assert_eq ("e_heap_remove len", size_t, e_heap_len (&nodes), 48);
+    ok = 1;
+    prev = -1;
+    while (e_heap_pop (&nodes, test_node_heap, &node)) {
+        if (node == &node_storage[17] || node == &node_storage[3]) ok = 0;
+        if (node->priority < prev) ok = 0;
+        prev = node->priority;
+        for (i = 0; i < e_heap_len (&nodes); i++) {
+            if ((*e_da_nth (&nodes, i))->index != i) ok = 0;
+        }
+    }
+    e_test_assert ("e_heap_update order", ok);
+    e_heap_deinit (&nodes);
+}
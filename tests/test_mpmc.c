@@ -0,0 +1,173 @@
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+
+# define E_MPMC_IMPL
+# include "e_mpmc.h"
+# include "e_test.h"
+
+# if !defined(__STDC_NO_THREADS__) && !defined(__MINGW32__)
+#  define TEST_MPMC_THREADS
+#  include <threads.h>
+# endif
+
+# define TEST_MPMC_THREAD_COUNT 4
+# define TEST_MPMC_PER_THREAD   20000
+
+typedef E_Mpmc (int) Test_Mpmc_Ints;
+
+# ifdef TEST_MPMC_THREADS
+static int
+test_mpmc_producer (void *arg)
+{
+    Test_Mpmc_Ints *mpmc = arg;
+    int i;
+
+    for (i = 0; i < TEST_MPMC_PER_THREAD; i++) {
+        if (i % 2) {
+            e_mpmc_push_wait (mpmc, i);
+        } else {
+            while (!e_mpmc_push (mpmc, i)) {
+                thrd_yield ();
+            }
+        }
+    }
+    return 0;
+}
+
+static int
+test_mpmc_consumer (void *arg)
+{
+    Test_Mpmc_Ints *mpmc = arg;
+    int i, item, sum = 0;
+
+    for (i = 0; i < TEST_MPMC_PER_THREAD; i++) {
+        e_mpmc_pop_wait (mpmc, &item);
+        sum += item % 1000;
+    }
+    return sum;
+}
+
+static int
+test_mpmc_blocked_consumer (void *arg)
+{
+    int item;
+
+    e_mpmc_pop_wait ((Test_Mpmc_Ints *) arg, &item);
+    return item;
+}
+
+static int
+test_mpmc_blocked_producer (void *arg)
+{
+    e_mpmc_push_wait ((Test_Mpmc_Ints *) arg, 3);
+    return 0;
+}
+# endif
+
+void
+test_mpmc (void)
+{
+    Test_Mpmc_Ints mpmc;
+    int item, i;
+    int ok;
+
+    /* e_mpmc_init */
+    e_test_assert ("e_mpmc_init not power of two", !e_mpmc_init (&mpmc, 12));
+    e_test_assert ("e_mpmc_init too small", !e_mpmc_init (&mpmc, 1));
+    e_test_assert ("e_mpmc_init", e_mpmc_init (&mpmc, 8));
+    e_test_assert_eq ("e_mpmc_cap", size_t, e_mpmc_cap (&mpmc), 8);
+    e_test_assert_eq ("e_mpmc_len", size_t, e_mpmc_len (&mpmc), 0);
+
+    /* e_mpmc_push, e_mpmc_pop */
+    e_test_assert ("e_mpmc_pop empty", !e_mpmc_pop (&mpmc, &item));
+    ok = 1;
+    for (i = 0; i < 8; i++) {
+        if (!e_mpmc_push (&mpmc, i)) ok = 0;
+    }
+    e_test_assert ("e_mpmc_push", ok);
+    e_test_assert ("e_mpmc_push full", !e_mpmc_push (&mpmc, 8));
+    e_test_assert_eq ("e_mpmc_push len", size_t, e_mpmc_len (&mpmc), 8);
+    e_test_assert ("e_mpmc_pop", e_mpmc_pop (&mpmc, &item));
+    e_test_assert_eq ("e_mpmc_pop out", int, item, 0);
+    e_test_assert ("e_mpmc_pop NULL", e_mpmc_pop (&mpmc, NULL));
+
+    /* wrapping around */
+    item = 8;
+    e_test_assert ("e_mpmc_push_ref", e_mpmc_push_ref (&mpmc, &item));
+    e_mpmc_push_wait (&mpmc, 9);
+    ok = 1;
+    for (i = 2; i < 10; i++) {
+        e_mpmc_pop_wait (&mpmc, &item);
+        if (item != i) ok = 0;
+    }
+    e_test_assert ("e_mpmc_pop_wait order", ok);
+    e_test_assert ("e_mpmc_pop empty again", !e_mpmc_pop (&mpmc, &item));
+    e_test_assert_eq ("e_mpmc_pop len", size_t, e_mpmc_len (&mpmc), 0);
+    e_mpmc_deinit (&mpmc);
+
+# ifdef TEST_MPMC_THREADS
+    {
+        thrd_t producers[TEST_MPMC_THREAD_COUNT];
+        thrd_t consumers[TEST_MPMC_THREAD_COUNT];
+        long sum, expected;
+        int result;
+
+        e_mpmc_init (&mpmc, 64);
+        for (i = 0; i < TEST_MPMC_THREAD_COUNT; i++) {
+            thrd_create (&producers[i], test_mpmc_producer, &mpmc);
+            thrd_create (&consumers[i], test_mpmc_consumer, &mpmc);
+        }
+        sum = 0;
+        for (i = 0; i < TEST_MPMC_THREAD_COUNT; i++) {
+            thrd_join (producers[i], NULL);
+            thrd_join (consumers[i], &result);
+            sum += result;
+        }
+        expected = 0;
+        for (i = 0; i < TEST_MPMC_PER_THREAD; i++) {
+            expected += i % 1000;
+        }
+        expected *= TEST_MPMC_THREAD_COUNT;
+        e_test_assert_eq ("e_mpmc concurrent items", long, sum, expected);
+        e_test_assert_eq ("e_mpmc concurrent len", size_t, e_mpmc_len (&mpmc), 0);
+        e_mpmc_deinit (&mpmc);
+    }
+#  ifdef E_MPMC__BLOCKING
+    {
+        thrd_t thread;
+        int result;
+
+        /* an idle consumer blocks until an item is pushed */
+        e_mpmc_init (&mpmc, 2);
+        thrd_create (&thread, test_mpmc_blocked_consumer, &mpmc);
+        while (atomic_load (&mpmc.data.pop_waiters) == 0) {
+            thrd_yield ();
+        }
+        e_mpmc_push (&mpmc, 42);
+        thrd_join (thread, &result);
+        e_test_assert_eq ("e_mpmc_pop_wait blocked", int, result, 42);
+
+        /* a producer blocks until an item is popped */
+        e_mpmc_push (&mpmc, 1);
+        e_mpmc_push (&mpmc, 2);
+        thrd_create (&thread, test_mpmc_blocked_producer, &mpmc);
+        while (atomic_load (&mpmc.data.push_waiters) == 0) {
+            thrd_yield ();
+        }
+        e_mpmc_pop (&mpmc, &item);
+        thrd_join (thread, NULL);
+        ok = e_mpmc_pop (&mpmc, &item) && item == 2 && e_mpmc_pop (&mpmc, &item) && item == 3;
+        e_test_assert ("e_mpmc_push_wait blocked", ok);
+        e_mpmc_deinit (&mpmc);
+    }
+#  endif /* E_MPMC__BLOCKING */
+# endif
+}
+
+#else /* __STDC_VERSION__ >= 201112L && !defined (__STDC_NO_ATOMICS__) */
+
+void
+test_mpmc (void)
+{
+}
+
+#endif /* __STDC_VERSION__ >= 201112L && !defined (__STDC_NO_ATOMICS__) */
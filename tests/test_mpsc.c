@@ -0,0 +1,126 @@
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+
+# define E_MPSC_IMPL
+# include "e_macro.h"
+# include "e_mpsc.h"
+# include "e_test.h"
+
+# if !defined(__STDC_NO_THREADS__) && !defined(__MINGW32__)
+#  define TEST_MPSC_THREADS
+#  include <threads.h>
+# endif
+
+# define TEST_MPSC_THREAD_COUNT 4
+# define TEST_MPSC_PER_THREAD   20000
+
+typedef struct {
+    E_Mpsc_Node node;
+    int producer;
+    int seq;
+} Test_Mpsc_Message;
+
+# ifdef TEST_MPSC_THREADS
+typedef struct {
+    E_Mpsc *mpsc;
+    Test_Mpsc_Message *messages;
+} Test_Mpsc_Producer;
+
+static int
+test_mpsc_producer (void *arg)
+{
+    Test_Mpsc_Producer *producer = arg;
+    int i;
+
+    for (i = 0; i < TEST_MPSC_PER_THREAD; i++) {
+        e_mpsc_push (producer->mpsc, &producer->messages[i].node);
+        if (i % 64 == 0) thrd_yield ();
+    }
+    return 0;
+}
+# endif
+
+void
+test_mpsc (void)
+{
+    E_Mpsc mpsc;
+    Test_Mpsc_Message messages[3];
+    E_Mpsc_Node *node;
+    int i;
+
+    /* e_mpsc_init */
+    e_mpsc_init (&mpsc);
+    e_test_assert ("e_mpsc_init empty", e_mpsc_is_empty (&mpsc));
+    e_test_assert_null ("e_mpsc_pop empty", e_mpsc_pop (&mpsc));
+
+    /* e_mpsc_push, e_mpsc_pop */
+    for (i = 0; i < 3; i++) {
+        messages[i].seq = i;
+        e_mpsc_push (&mpsc, &messages[i].node);
+    }
+    e_test_assert ("e_mpsc_push not empty", !e_mpsc_is_empty (&mpsc));
+    node = e_mpsc_pop (&mpsc);
+    e_test_assert_ptr_eq ("e_mpsc_pop first", node, &messages[0].node);
+    e_test_assert ("e_mpsc_pop E_CONTAINER_OF",
+                   node != NULL && E_CONTAINER_OF (node, Test_Mpsc_Message, node)->seq == 0);
+    e_test_assert_ptr_eq ("e_mpsc_pop second", e_mpsc_pop (&mpsc), &messages[1].node);
+    e_test_assert ("e_mpsc_pop last not empty", !e_mpsc_is_empty (&mpsc));
+    e_test_assert_ptr_eq ("e_mpsc_pop last", e_mpsc_pop (&mpsc), &messages[2].node);
+    e_test_assert ("e_mpsc_pop empty again", e_mpsc_is_empty (&mpsc));
+    e_test_assert_null ("e_mpsc_pop null again", e_mpsc_pop (&mpsc));
+
+    /* nodes can be pushed again after they have been popped */
+    e_mpsc_push (&mpsc, &messages[2].node);
+    e_mpsc_push (&mpsc, &messages[0].node);
+    e_test_assert_ptr_eq ("e_mpsc_push reuse first", e_mpsc_pop (&mpsc), &messages[2].node);
+    e_test_assert_ptr_eq ("e_mpsc_push reuse second", e_mpsc_pop (&mpsc), &messages[0].node);
+    e_test_assert_null ("e_mpsc_push reuse empty", e_mpsc_pop (&mpsc));
+
+# ifdef TEST_MPSC_THREADS
+    {
+        static Test_Mpsc_Message shared[TEST_MPSC_THREAD_COUNT][TEST_MPSC_PER_THREAD];
+        Test_Mpsc_Producer producers[TEST_MPSC_THREAD_COUNT];
+        thrd_t threads[TEST_MPSC_THREAD_COUNT];
+        int next[TEST_MPSC_THREAD_COUNT] = {0};
+        Test_Mpsc_Message *message;
+        int received, ok, j;
+
+        for (i = 0; i < TEST_MPSC_THREAD_COUNT; i++) {
+            for (j = 0; j < TEST_MPSC_PER_THREAD; j++) {
+                shared[i][j].producer = i;
+                shared[i][j].seq = j;
+            }
+            producers[i].mpsc = &mpsc;
+            producers[i].messages = shared[i];
+            thrd_create (&threads[i], test_mpsc_producer, &producers[i]);
+        }
+        ok = 1;
+        received = 0;
+        while (received < TEST_MPSC_THREAD_COUNT * TEST_MPSC_PER_THREAD) {
+            node = e_mpsc_pop (&mpsc);
+            if (node == NULL) {
+                thrd_yield ();
+                continue;
+            }
+            message = E_CONTAINER_OF (node, Test_Mpsc_Message, node);
+            /* items of the same producer arrive in order */
+            if (message->seq != next[message->producer]) ok = 0;
+            next[message->producer] = message->seq + 1;
+            received += 1;
+        }
+        for (i = 0; i < TEST_MPSC_THREAD_COUNT; i++) {
+            thrd_join (threads[i], NULL);
+        }
+        e_test_assert ("e_mpsc concurrent order", ok);
+        e_test_assert ("e_mpsc concurrent empty", e_mpsc_is_empty (&mpsc));
+    }
+# endif
+}
+
+#else /* __STDC_VERSION__ >= 201112L && !defined (__STDC_NO_ATOMICS__) */
+
+void
+test_mpsc (void)
+{
+}
+
+#endif /* __STDC_VERSION__ >= 201112L && !defined (__STDC_NO_ATOMICS__) */
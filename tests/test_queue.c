@@ -4,6 +4,7 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 void
 test_queue (void)
@@ -69,4 +70,60 @@ test_queue (void)
     e_test_assert_eq ("e_queue_pop_front 1 head", size_t, queue.data.head, 6);
 
     e_queue_deinit (&queue);
+
+    /* e_queue_push_n, e_queue_pop_n */
+    {
+        E_Queue (int) q = e_queue_init ();
+        int items[40], popped[40];
+        int *first, *second;
+        size_t first_len, second_len, i;
+        int ok;
+
+        for (i = 0; i < 40; i++) {
+            items[i] = (int) i;
+        }
+        e_queue_push_n (&q, items, 30);
+        e_test_assert_eq ("e_queue_push_n len", size_t, e_queue_len (&q), 30);
+        e_test_assert_eq ("e_queue_push_n cap", size_t, q.data.cap, 32);
+        e_test_assert_eq ("e_queue_pop_n count", size_t, e_queue_pop_n (&q, popped, 20), 20);
+        e_test_assert_mem_eq ("e_queue_pop_n items", popped, items, 20 * sizeof (int));
+
+        /* wraps around the end of the buffer */
+        e_queue_push_n (&q, items + 30, 10);
+        e_test_assert_eq ("e_queue_push_n wrap head", size_t, q.data.head, 8);
+        e_test_assert_eq ("e_queue_push_n wrap cap", size_t, q.data.cap, 32);
+
+        /* e_queue_peek_spans */
+        e_test_assert_eq ("e_queue_peek_spans count", int,
+                          e_queue_peek_spans (&q, &first, &first_len, &second, &second_len), 2);
+        e_test_assert_eq ("e_queue_peek_spans first_len", size_t, first_len, 12);
+        e_test_assert_eq ("e_queue_peek_spans second_len", size_t, second_len, 8);
+        e_test_assert_mem_eq ("e_queue_peek_spans first", first, items + 20, 12 * sizeof (int));
+        e_test_assert_mem_eq ("e_queue_peek_spans second", second, items + 32, 8 * sizeof (int));
+
+        /* pops across the wrap point */
+        e_test_assert_eq ("e_queue_pop_n wrap count", size_t, e_queue_pop_n (&q, popped, 15), 15);
+        e_test_assert_mem_eq ("e_queue_pop_n wrap items", popped, items + 20, 15 * sizeof (int));
+        e_test_assert_eq ("e_queue_pop_n wrap tail", size_t, q.data.tail, 3);
+        e_test_assert_eq ("e_queue_peek_spans one", int,
+                          e_queue_peek_spans (&q, &first, &first_len, &second, &second_len), 1);
+        e_test_assert_eq ("e_queue_peek_spans one first_len", size_t, first_len, 5);
+        e_test_assert_null ("e_queue_peek_spans one second", second);
+        e_test_assert_eq ("e_queue_pop_n too many", size_t, e_queue_pop_n (&q, NULL, 100), 5);
+        e_test_assert_eq ("e_queue_peek_spans empty", int,
+                          e_queue_peek_spans (&q, &first, &first_len, &second, &second_len), 0);
+        e_test_assert_null ("e_queue_peek_spans empty first", first);
+
+        /* reallocation while wrapped */
+        e_queue_push_n (&q, items, 30);
+        e_queue_push_n (&q, items, 40);
+        e_test_assert_eq ("e_queue_push_n grow len", size_t, e_queue_len (&q), 70);
+        ok = e_queue_pop_n (&q, popped, 30) == 30;
+        ok = ok && memcmp (popped, items, 30 * sizeof (int)) == 0;
+        ok = ok && e_queue_pop_n (&q, popped, 40) == 40;
+        ok = ok && memcmp (popped, items, 40 * sizeof (int)) == 0;
+        e_test_assert ("e_queue_push_n grow items", ok);
+
+        e_queue_deinit (&q);
+    }
 }
@@ -1,3 +1,7 @@
+#ifdef __linux__
+# define _GNU_SOURCE
+# define E_CONFIG_RBUF_MIRROR
+#endif
 #define E_RBUF_IMPL
 #include "e_macro.h"
 #include "e_rbuf.h"
@@ -10,6 +14,8 @@ test_rbuf (void)
 {
     static int buffer[4]; /* static for C89 compliance */
     int out = 0;
+    int *span;
+    size_t n;
 
     /* e_rbuf_init */
     E_Rbuf (int) rbuf = e_rbuf_init (buffer, E_COUNTOF (buffer));
@@ -79,4 +85,90 @@ test_rbuf (void)
 
     e_test_assert ("e_rbuf_pop failure", !e_rbuf_pop (&rbuf, &out));
     e_test_assert ("e_rbuf_pop_front failure", !e_rbuf_pop_front (&rbuf, &out));
+
+    /* e_rbuf_head_ptr, e_rbuf_commit, e_rbuf_tail_ptr, e_rbuf_consume */
+    e_test_assert_ptr_eq ("e_rbuf_head_ptr", e_rbuf_head_ptr (&rbuf), &buffer[rbuf.data.head]);
+    *e_rbuf_head_ptr (&rbuf) = 70;
+    e_rbuf_commit (&rbuf, 1);
+    e_test_assert_eq ("e_rbuf_commit len", size_t, e_rbuf_len (&rbuf), 1);
+    e_test_assert_eq ("e_rbuf_commit head", size_t, rbuf.data.head, 2);
+    e_test_assert_eq ("e_rbuf_tail_ptr", int, *e_rbuf_tail_ptr (&rbuf), 70);
+    e_rbuf_commit (&rbuf, 10);
+    e_test_assert_eq ("e_rbuf_commit limited", size_t, e_rbuf_len (&rbuf), 4);
+    e_rbuf_consume (&rbuf, 3);
+    e_test_assert_eq ("e_rbuf_consume len", size_t, e_rbuf_len (&rbuf), 1);
+    e_test_assert_eq ("e_rbuf_consume tail", size_t, rbuf.data.tail, 0);
+    e_rbuf_consume (&rbuf, 10);
+    e_test_assert ("e_rbuf_consume limited", e_rbuf_is_empty (&rbuf));
+
+    /* e_rbuf_reserve, e_rbuf_peek (head and tail are at index 1) */
+    span = e_rbuf_reserve (&rbuf, 4, &n);
+    e_test_assert_ptr_eq ("e_rbuf_reserve ptr", span, &buffer[1]);
+    e_test_assert_eq ("e_rbuf_reserve until end", size_t, n, 3);
+    span[0] = 80;
+    span[1] = 81;
+    span[2] = 82;
+    e_rbuf_commit (&rbuf, n);
+    span = e_rbuf_reserve (&rbuf, 3, &n);
+    e_test_assert_ptr_eq ("e_rbuf_reserve wrapped ptr", span, &buffer[0]);
+    e_test_assert_eq ("e_rbuf_reserve wrapped", size_t, n, 1);
+    span[0] = 83;
+    e_rbuf_commit (&rbuf, n);
+    e_rbuf_reserve (&rbuf, 1, &n);
+    e_test_assert_eq ("e_rbuf_reserve full", size_t, n, 0);
+    span = e_rbuf_peek (&rbuf, 10, &n);
+    e_test_assert_eq ("e_rbuf_peek until end", size_t, n, 3);
+    e_test_assert ("e_rbuf_peek items", span[0] == 80 && span[1] == 81 && span[2] == 82);
+    e_rbuf_consume (&rbuf, 2);
+    span = e_rbuf_peek (&rbuf, 1, &n);
+    e_test_assert_eq ("e_rbuf_peek count", size_t, n, 1);
+    e_test_assert_eq ("e_rbuf_peek item", int, *span, 82);
+    e_rbuf_consume (&rbuf, 1);
+    span = e_rbuf_peek (&rbuf, 10, &n);
+    e_test_assert_eq ("e_rbuf_peek wrapped", size_t, n, 1);
+    e_test_assert_eq ("e_rbuf_peek wrapped item", int, *span, 83);
+    e_test_assert ("e_rbuf_pop after peek", e_rbuf_pop (&rbuf, &out) && out == 83);
+    e_rbuf_peek (&rbuf, 10, &n);
+    e_test_assert_eq ("e_rbuf_peek empty", size_t, n, 0);
+
+#if defined(E_CONFIG_RBUF_MIRROR) && defined(__linux__)
+    {
+        E_Rbuf (unsigned char) mirror;
+        unsigned char *head, byte;
+        size_t cap, i;
+        int ok;
+
+        /* e_rbuf_mirror_init */
+        e_test_assert ("e_rbuf_mirror_init", e_rbuf_mirror_init (&mirror, 100));
+        cap = e_rbuf_cap (&mirror);
+        e_test_assert ("e_rbuf_mirror_init cap", cap >= 100);
+        e_test_assert ("e_rbuf_mirror_init empty", e_rbuf_is_empty (&mirror));
+
+        /* writes past the end appear at the start */
+        e_rbuf_commit (&mirror, cap - 2);
+        e_rbuf_consume (&mirror, cap - 2);
+        head = e_rbuf_head_ptr (&mirror);
+        for (i = 0; i < 6; i++) {
+            head[i] = (unsigned char) (i + 1);
+        }
+        e_rbuf_commit (&mirror, 6);
+        e_test_assert_eq ("e_rbuf_mirror wrap head", size_t, mirror.data.head, 4);
+        e_test_assert_eq ("e_rbuf_mirror wrap start", int, *(unsigned char *) mirror.data.ptr, 3);
+        ok = 1;
+        for (i = 0; i < 6; i++) {
+            if (e_rbuf_tail_ptr (&mirror)[i] != i + 1) ok = 0;
+        }
+        e_test_assert ("e_rbuf_mirror contiguous read", ok);
+        e_rbuf_peek (&mirror, 10, &i);
+        e_test_assert_eq ("e_rbuf_mirror peek", size_t, i, 6);
+        e_rbuf_reserve (&mirror, cap, &i);
+        e_test_assert_eq ("e_rbuf_mirror reserve", size_t, i, cap - 6);
+        e_rbuf_pop (&mirror, NULL);
+        e_rbuf_pop (&mirror, NULL);
+        byte = 0;
+        e_test_assert ("e_rbuf_mirror pop", e_rbuf_pop (&mirror, &byte));
+        e_test_assert_eq ("e_rbuf_mirror pop out", int, byte, 3);
+        e_rbuf_mirror_deinit (&mirror);
+    }
+#endif
 }
@@ -1,5 +1,6 @@
 #define E_CONFIG_SB_SV_COMPAT
 #define E_SB_IMPL
+#include "e_arena.h"
 #include "e_sb.h"
 #include "e_sv.h"
 #include "e_test.h"
@@ -12,6 +13,10 @@ test_sb (void)
     E_Sb sb;
     char *buf = " bar";
     size_t prev_len;
+    unsigned char arena_buf[256];
+    unsigned char *arena_start;
+    E_Allocator allocator;
+    E_Arena arena;
 
     /* e_sb_init */
     sb = e_sb_init ();
@@ -55,4 +60,18 @@ test_sb (void)
 #endif
 
     e_sb_deinit (&sb);
+
+    /* e_sb_init_with_allocator */
+    arena_start = arena_buf;
+    arena_start += ((size_t) E_ALIGN_MAX - (size_t) arena_start % (size_t) E_ALIGN_MAX) %
+                   (size_t) E_ALIGN_MAX;
+    arena = e_arena_init (arena_start, 128);
+    allocator = e_arena_allocator (&arena);
+    sb = e_sb_init_with_allocator (&allocator);
+    e_sb_append (&sb, "foo");
+    e_test_assert ("e_sb_init_with_allocator", e_sv_eq (e_sb_to_sv (&sb), e_sv_from_cstr ("foo")));
+    e_test_assert ("e_sb_init_with_allocator in arena", (unsigned char *) sb.ptr == arena_start);
+    e_sb_deinit (&sb);
+    e_test_assert_eq ("e_sb_init_with_allocator deinit", size_t,
+                      e_arena_allocated_byte_count (&arena), 0);
 }
@@ -0,0 +1,125 @@
+#define E_SEGDA_IMPL
+#include "e_arena.h"
+#include "e_segda.h"
+#include "e_test.h"
+
+void
+test_segda (void)
+{
+    E_Segda (int) da = e_segda_init ();
+    E_Segda (int) da2 = e_segda_init ();
+    int items[100];
+    int *first, *tenth, *p;
+    size_t i;
+    int ok;
+    unsigned char arena_buf[4096];
+    E_Allocator allocator;
+    E_Arena arena;
+
+    /* e_segda_init */
+    e_test_assert_eq ("e_segda_init len", size_t, e_segda_len (&da), 0);
+    e_test_assert_eq ("e_segda_init segment_count", size_t, da.data.segment_count, 0);
+
+    /* e_segda_push, e_segda_nth */
+    for (i = 0; i < 11; i++) {
+        e_segda_push (&da, (int) i);
+    }
+    first = e_segda_nth (&da, 0);
+    tenth = e_segda_nth (&da, 10);
+    for (i = 11; i < 1000; i++) {
+        e_segda_push (&da, (int) i);
+    }
+    e_test_assert_eq ("e_segda_push len", size_t, e_segda_len (&da), 1000);
+    ok = 1;
+    for (i = 0; i < 1000; i++) {
+        if (*e_segda_nth (&da, i) != (int) i) ok = 0;
+    }
+    e_test_assert ("e_segda_nth", ok);
+    e_test_assert_eq ("e_segda_last", int, *e_segda_last (&da), 999);
+    e_test_assert_ptr_eq ("e_segda_push stable first", e_segda_nth (&da, 0), first);
+    e_test_assert_ptr_eq ("e_segda_push stable tenth", e_segda_nth (&da, 10), tenth);
+    e_test_assert_eq ("e_segda_push segment_count", size_t, da.data.segment_count, 6);
+
+    /* segment boundaries */
+    e_test_assert_ptr_eq ("e_segda_nth segment 0", e_segda_nth (&da, 0), da.data.segments[0]);
+    e_test_assert_ptr_eq ("e_segda_nth segment 1", e_segda_nth (&da, 16), da.data.segments[1]);
+    e_test_assert_ptr_eq ("e_segda_nth segment 2", e_segda_nth (&da, 48), da.data.segments[2]);
+    e_test_assert_ptr_eq ("e_segda_nth end of segment 1", e_segda_nth (&da, 47),
+                          (int *) da.data.segments[1] + 31);
+
+    /* e_segda_foreach */
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+    int sum = 0;
+    e_segda_foreach (&da, it) {
+        if (it != NULL) sum += *it;
+    }
+    e_test_assert_eq ("e_segda_foreach", int, sum, 999 * 1000 / 2);
+    sum = 0;
+    e_segda_foreach (&da, it) {
+        if (it == NULL || *it == 100) break;
+        if (*it % 2) continue;
+        sum += 1;
+    }
+    e_test_assert_eq ("e_segda_foreach break", int, sum, 50);
+    sum = 0;
+    e_segda_foreach (&da2, it) {
+        sum += 1;
+    }
+    e_test_assert_eq ("e_segda_foreach empty", int, sum, 0);
+#endif
+
+    /* e_segda_pop */
+    e_segda_pop (&da, 990);
+    e_test_assert_eq ("e_segda_pop len", size_t, e_segda_len (&da), 10);
+    e_test_assert_eq ("e_segda_pop last", int, *e_segda_last (&da), 9);
+    e_segda_push (&da, 42);
+    e_test_assert_ptr_eq ("e_segda_pop reuse", e_segda_nth (&da, 10), tenth);
+    e_test_assert_eq ("e_segda_pop segment_count", size_t, da.data.segment_count, 6);
+    e_segda_pop (&da, 100);
+    e_test_assert_eq ("e_segda_pop too many", size_t, e_segda_len (&da), 0);
+    e_segda_deinit (&da);
+
+    /* e_segda_extend */
+    for (i = 0; i < 100; i++) {
+        items[i] = (int) i;
+    }
+    e_segda_extend (&da2, items, 10);
+    e_segda_extend (&da2, items + 10, 90);
+    e_test_assert_eq ("e_segda_extend len", size_t, e_segda_len (&da2), 100);
+    e_test_assert_eq ("e_segda_extend segment_count", size_t, da2.data.segment_count, 3);
+    ok = 1;
+    for (i = 0; i < 100; i++) {
+        if (*e_segda_nth (&da2, i) != (int) i) ok = 0;
+    }
+    e_test_assert ("e_segda_extend items", ok);
+
+    /* e_segda_push_ref, e_segda_push_uninit */
+    e_segda_push_ref (&da2, &items[5]);
+    p = e_segda_push_uninit (&da2);
+    *p = -1;
+    e_test_assert_eq ("e_segda_push_ref", int, *e_segda_nth (&da2, 100), 5);
+    e_test_assert_eq ("e_segda_push_uninit", int, *e_segda_nth (&da2, 101), -1);
+    e_test_assert_eq ("e_segda_push_uninit len", size_t, e_segda_len (&da2), 102);
+    e_segda_deinit (&da2);
+
+    /* e_segda_init_with_allocator */
+    arena = e_arena_init (arena_buf, sizeof (arena_buf));
+    allocator = e_arena_allocator (&arena);
+    {
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L
+        E_Segda (int) ada = e_segda_init_with_allocator (&allocator);
+#else
+        E_Segda (int) ada = e_segda_init ();
+        ada.data.allocator = &allocator;
+#endif
+        for (i = 0; i < 100; i++) {
+            e_segda_push (&ada, (int) i);
+        }
+        e_test_assert_eq ("e_segda_init_with_allocator nth", int, *e_segda_nth (&ada, 77), 77);
+        p = e_segda_nth (&ada, 77);
+        e_test_assert ("e_segda_init_with_allocator arena",
+                       (unsigned char *) p >= arena_buf &&
+                           (unsigned char *) p < arena_buf + sizeof (arena_buf));
+        e_segda_deinit (&ada);
+    }
+}
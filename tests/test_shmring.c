@@ -0,0 +1,159 @@
+#if defined(__linux__) && defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L &&              \
+    !defined(__STDC_NO_ATOMICS__)
+
+# define _GNU_SOURCE
+# define E_SHMRING_IMPL
+# include "e_shmring.h"
+# include "e_test.h"
+
+# include <stdio.h>
+# include <sys/wait.h>
+# include <unistd.h>
+
+# define TEST_SHMRING_COUNT 100000
+
+typedef E_Shmring (int) Test_Shmring_Ints;
+
+/**
+ * Store `cap` in the header of `shmring` and try to open the segment again.
+ */
+static int
+test_shmring_open_with_cap (Test_Shmring_Ints *shmring, uint32_t cap)
+{
+    Test_Shmring_Ints other;
+    int fd, ok;
+
+    shmring->data.header->cap = cap;
+    fd = dup (e_shmring_fd (shmring));
+    ok = e_shmring_open_fd (&other, fd);
+    if (ok) {
+        e_shmring_close (&other);
+    } else {
+        close (fd);
+    }
+    return ok;
+}
+
+void
+test_shmring (void)
+{
+    Test_Shmring_Ints producer, consumer, other;
+    E_Shmring (char) other_char;
+    char name[64];
+    int item, i, ok, status;
+    const int *src;
+    int *dst;
+    size_t n;
+    pid_t pid;
+
+    /* e_shmring_create, e_shmring_open_fd */
+    e_test_assert ("e_shmring_create not power of two", !e_shmring_create (&producer, NULL, 12));
+    e_test_assert ("e_shmring_create too small", !e_shmring_create (&producer, NULL, 1));
+    e_test_assert_eq ("e_shmring_create failed fd", int, e_shmring_fd (&producer), -1);
+    ok = e_shmring_create (&producer, NULL, 4);
+    e_test_assert ("e_shmring_create", ok);
+    if (!ok) return; /* the remaining tests need the ringbuffer */
+    e_test_assert_eq ("e_shmring_cap", size_t, e_shmring_cap (&producer), 4);
+    e_test_assert_eq ("e_shmring_len", size_t, e_shmring_len (&producer), 0);
+    ok = e_shmring_open_fd (&consumer, dup (e_shmring_fd (&producer)));
+    e_test_assert ("e_shmring_open_fd", ok);
+    if (!ok) {
+        e_shmring_close (&producer);
+        return;
+    }
+    e_test_assert ("e_shmring_open_fd separate mapping",
+                   consumer.data.header != producer.data.header);
+
+    /* a header with an invalid capacity is rejected */
+    e_test_assert ("e_shmring_open_fd zero cap", !test_shmring_open_with_cap (&producer, 0));
+    e_test_assert ("e_shmring_open_fd cap not power of two",
+                   !test_shmring_open_with_cap (&producer, 3));
+    producer.data.header->cap = 4;
+
+    /* e_shmring_push, e_shmring_pop */
+    e_test_assert ("e_shmring_pop empty", !e_shmring_pop (&consumer, &item));
+    ok = 1;
+    for (i = 0; i < 4; i++) {
+        if (!e_shmring_push (&producer, i)) ok = 0;
+    }
+    e_test_assert ("e_shmring_push", ok);
+    e_test_assert ("e_shmring_push full", !e_shmring_push (&producer, 4));
+    e_test_assert_eq ("e_shmring_push len", size_t, e_shmring_len (&consumer), 4);
+    e_test_assert ("e_shmring_pop", e_shmring_pop (&consumer, &item) && item == 0);
+    e_test_assert ("e_shmring_pop NULL", e_shmring_pop (&consumer, NULL));
+    item = 4;
+    e_test_assert ("e_shmring_push_ref", e_shmring_push_ref (&producer, &item));
+    e_shmring_push_wait (&producer, 5);
+    ok = 1;
+    for (i = 2; i < 6; i++) {
+        e_shmring_pop_wait (&consumer, &item);
+        if (item != i) ok = 0;
+    }
+    e_test_assert ("e_shmring_pop_wait order", ok);
+
+    /* e_shmring_reserve, e_shmring_commit, e_shmring_peek, e_shmring_consume (head and tail are
+     * at index 2) */
+    dst = e_shmring_reserve (&producer, 4, &n);
+    e_test_assert_eq ("e_shmring_reserve until end", size_t, n, 2);
+    dst[0] = 10;
+    dst[1] = 11;
+    e_shmring_commit (&producer, n);
+    dst = e_shmring_reserve (&producer, 4, &n);
+    e_test_assert_eq ("e_shmring_reserve wrapped", size_t, n, 2);
+    dst[0] = 12;
+    e_shmring_commit (&producer, 1);
+    src = e_shmring_peek (&consumer, 4, &n);
+    e_test_assert ("e_shmring_peek until end", n == 2 && src[0] == 10 && src[1] == 11);
+    e_shmring_consume (&consumer, n);
+    src = e_shmring_peek (&consumer, 4, &n);
+    e_test_assert ("e_shmring_peek wrapped", n == 1 && src[0] == 12);
+    e_shmring_consume (&consumer, n);
+    e_shmring_peek (&consumer, 4, &n);
+    e_test_assert_eq ("e_shmring_peek empty", size_t, n, 0);
+    e_shmring_close (&consumer);
+
+    /* sharing the ringbuffer with another process */
+    pid = fork ();
+    if (pid == 0) {
+        for (i = 0; i < TEST_SHMRING_COUNT; i++) {
+            e_shmring_push_wait (&producer, i);
+        }
+        _exit (0);
+    }
+    ok = pid > 0;
+    for (i = 0; pid > 0 && i < TEST_SHMRING_COUNT; i++) {
+        e_shmring_pop_wait (&producer, &item);
+        if (item != i) ok = 0;
+    }
+    e_test_assert ("e_shmring fork order", ok);
+    e_test_assert ("e_shmring fork exit", waitpid (pid, &status, 0) == pid && status == 0);
+    e_shmring_close (&producer);
+
+    /* e_shmring_open, e_shmring_unlink */
+    snprintf (name, sizeof (name), "/e_shmring_test_%ld", (long) getpid ());
+    ok = e_shmring_create (&producer, name, 8);
+    e_test_assert ("e_shmring_create named", ok);
+    if (!ok) return;
+    e_test_assert ("e_shmring_create exists", !e_shmring_create (&other, name, 8));
+    ok = e_shmring_open (&consumer, name);
+    e_test_assert ("e_shmring_open", ok);
+    e_test_assert ("e_shmring_open other item size",
+                   !e_shmring_open (&other_char, name));
+    if (ok) {
+        e_shmring_push (&producer, 42);
+        e_test_assert ("e_shmring_open pop", e_shmring_pop (&consumer, &item) && item == 42);
+        e_shmring_close (&consumer);
+    }
+    e_shmring_close (&producer);
+    e_test_assert ("e_shmring_unlink", e_shmring_unlink (name));
+    e_test_assert ("e_shmring_open unlinked", !e_shmring_open (&consumer, name));
+}
+
+#else /* defined(__linux__) && __STDC_VERSION__ >= 201112L && !defined (__STDC_NO_ATOMICS__) */
+
+void
+test_shmring (void)
+{
+}
+
+#endif /* defined(__linux__) && __STDC_VERSION__ >= 201112L && !defined (__STDC_NO_ATOMICS__) */
@@ -0,0 +1,87 @@
+#define E_SOA_IMPL
+#include "e_arena.h"
+#include "e_soa.h"
+#include "e_test.h"
+
+#define PARTICLE_FIELDS_(X)                                                                        \
+    X (float, x)                                                                                   \
+    X (float, y)                                                                                   \
+    X (int, id)
+E_SOA_DECL_TYPE (PARTICLE_FIELDS_, Particles, particles);
+E_SOA_IMPL_TYPE (PARTICLE_FIELDS_, Particles, particles)
+
+void
+test_soa (void)
+{
+    Particles ps = e_soa_init ();
+    float sum;
+    size_t i, idx;
+    int ok;
+    unsigned char arena_buf[1024];
+    E_Allocator allocator;
+    E_Arena arena;
+
+    /* e_soa_init */
+    e_test_assert_eq ("e_soa_init len", size_t, e_soa_len (&ps), 0);
+    e_test_assert_eq ("e_soa_init cap", size_t, ps.data.cap, 0);
+    e_test_assert_null ("e_soa_init col", e_soa_col (&ps, x));
+
+    /* push */
+    for (i = 0; i < 100; i++) {
+        particles_push (&ps, (float) i, (float) i * 2.0f, (int) i + 1000);
+    }
+    e_test_assert_eq ("particles_push len", size_t, e_soa_len (&ps), 100);
+    e_test_assert_eq ("particles_push cap", size_t, ps.data.cap, 128);
+    ok = 1;
+    for (i = 0; i < 100; i++) {
+        if (e_soa_col (&ps, x)[i] != (float) i) ok = 0;
+        if (e_soa_col (&ps, y)[i] != (float) i * 2.0f) ok = 0;
+        if (e_soa_col (&ps, id)[i] != (int) i + 1000) ok = 0;
+    }
+    e_test_assert ("particles_push columns", ok);
+    e_test_assert_eq ("e_soa_nth", int, *e_soa_nth (&ps, id, 42), 1042);
+
+    /* column scan */
+    sum = 0.0f;
+    for (i = 0; i < e_soa_len (&ps); i++) {
+        sum += e_soa_col (&ps, x)[i];
+    }
+    e_test_assert_eq ("e_soa_col scan", int, (int) sum, 4950);
+
+    /* push_uninit */
+    idx = particles_push_uninit (&ps);
+    e_soa_col (&ps, x)[idx] = -1.0f;
+    e_soa_col (&ps, y)[idx] = -2.0f;
+    e_soa_col (&ps, id)[idx] = -3;
+    e_test_assert_eq ("particles_push_uninit idx", size_t, idx, 100);
+    e_test_assert_eq ("particles_push_uninit len", size_t, e_soa_len (&ps), 101);
+    e_test_assert_eq ("particles_push_uninit value", int, *e_soa_nth (&ps, id, 100), -3);
+
+    /* pop */
+    particles_pop (&ps, 2);
+    e_test_assert_eq ("particles_pop len", size_t, e_soa_len (&ps), 99);
+    e_test_assert_eq ("particles_pop last", int, e_soa_col (&ps, id)[98], 1098);
+    particles_pop (&ps, 1000);
+    e_test_assert_eq ("particles_pop too many", size_t, e_soa_len (&ps), 0);
+
+    /* reserve */
+    particles_reserve (&ps, 300);
+    e_test_assert_eq ("particles_reserve cap", size_t, ps.data.cap, 512);
+    particles_reserve (&ps, 10);
+    e_test_assert_eq ("particles_reserve no shrink", size_t, ps.data.cap, 512);
+    particles_deinit (&ps);
+
+    /* particles_init_with_allocator */
+    arena = e_arena_init (arena_buf, sizeof (arena_buf));
+    allocator = e_arena_allocator (&arena);
+    {
+        Particles aps = particles_init_with_allocator (&allocator);
+        particles_push (&aps, 1.0f, 2.0f, 3);
+        particles_push (&aps, 4.0f, 5.0f, 6);
+        e_test_assert_eq ("particles_init_with_allocator", int, e_soa_col (&aps, id)[1], 6);
+        e_test_assert ("particles_init_with_allocator arena",
+                       (unsigned char *) e_soa_col (&aps, id) >= arena_buf &&
+                           (unsigned char *) e_soa_col (&aps, id) < arena_buf + sizeof (arena_buf));
+        particles_deinit (&aps);
+    }
+}
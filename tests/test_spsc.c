@@ -0,0 +1,133 @@
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+
+# define E_SPSC_IMPL
+# include "e_spsc.h"
+# include "e_test.h"
+
+# if !defined(__STDC_NO_THREADS__) && !defined(__MINGW32__)
+#  define TEST_SPSC_THREADS
+#  include <threads.h>
+# endif
+
+# define TEST_SPSC_COUNT 200000
+
+typedef E_Spsc (unsigned int) Test_Spsc_Uints;
+
+typedef struct {
+    int a;
+    char b;
+} Test_Spsc_Item;
+
+# ifdef TEST_SPSC_THREADS
+static int
+test_spsc_producer (void *arg)
+{
+    Test_Spsc_Uints *spsc = arg;
+    unsigned int batch[37];
+    unsigned int next = 0;
+    size_t i, n, pushed;
+
+    while (next < TEST_SPSC_COUNT) {
+        if (next % 3 == 0) {
+            if (!e_spsc_push (spsc, next)) {
+                thrd_yield ();
+                continue;
+            }
+            next += 1;
+        } else {
+            n = TEST_SPSC_COUNT - next < 37 ? TEST_SPSC_COUNT - next : 37;
+            for (i = 0; i < n; i++) {
+                batch[i] = next + (unsigned int) i;
+            }
+            pushed = e_spsc_push_n (spsc, batch, n);
+            if (pushed == 0) thrd_yield ();
+            next += (unsigned int) pushed;
+        }
+    }
+    return 0;
+}
+# endif
+
+void
+test_spsc (void)
+{
+    unsigned int memory[64];
+    unsigned int items[100], out[100];
+    Test_Spsc_Uints spsc;
+    Test_Spsc_Item item_memory[4], item;
+    E_Spsc (Test_Spsc_Item) item_spsc;
+    unsigned int x;
+    size_t i;
+
+    /* e_spsc_init */
+    e_test_assert ("e_spsc_init not power of two", !e_spsc_init (&spsc, memory, 48));
+    e_test_assert ("e_spsc_init", e_spsc_init (&spsc, memory, 64));
+    e_test_assert_eq ("e_spsc_cap", size_t, e_spsc_cap (&spsc), 64);
+    e_test_assert_eq ("e_spsc_len", size_t, e_spsc_len (&spsc), 0);
+
+    /* e_spsc_push, e_spsc_pop */
+    e_test_assert ("e_spsc_pop empty", !e_spsc_pop (&spsc, &x));
+    e_test_assert ("e_spsc_push", e_spsc_push (&spsc, 7u));
+    e_test_assert_eq ("e_spsc_push len", size_t, e_spsc_len (&spsc), 1);
+    e_test_assert ("e_spsc_pop", e_spsc_pop (&spsc, &x));
+    e_test_assert_eq ("e_spsc_pop out", unsigned int, x, 7);
+
+    /* e_spsc_push_n, e_spsc_pop_n (wrapping around) */
+    for (i = 0; i < 100; i++) {
+        items[i] = (unsigned int) i;
+    }
+    e_test_assert_eq ("e_spsc_push_n", size_t, e_spsc_push_n (&spsc, items, 60), 60);
+    e_test_assert_eq ("e_spsc_pop_n", size_t, e_spsc_pop_n (&spsc, out, 50), 50);
+    e_test_assert_mem_eq ("e_spsc_pop_n items", out, items, 50 * sizeof (unsigned int));
+    e_test_assert_eq ("e_spsc_push_n full", size_t, e_spsc_push_n (&spsc, items + 60, 40), 40);
+    e_test_assert_eq ("e_spsc_push_n partial", size_t, e_spsc_push_n (&spsc, items, 100), 14);
+    e_test_assert ("e_spsc_push full", !e_spsc_push (&spsc, 1u));
+    e_test_assert_eq ("e_spsc_len full", size_t, e_spsc_len (&spsc), 64);
+    e_test_assert_eq ("e_spsc_pop_n wrap", size_t, e_spsc_pop_n (&spsc, out, 100), 64);
+    e_test_assert_mem_eq ("e_spsc_pop_n wrap items", out, items + 50, 50 * sizeof (unsigned int));
+    e_test_assert_mem_eq ("e_spsc_pop_n wrap rest", out + 50, items, 14 * sizeof (unsigned int));
+    e_test_assert_eq ("e_spsc_pop_n empty", size_t, e_spsc_pop_n (&spsc, NULL, 1), 0);
+
+    /* struct items */
+    e_test_assert ("e_spsc_init struct", e_spsc_init (&item_spsc, item_memory, 4));
+    item.a = 5;
+    item.b = 'x';
+    e_test_assert ("e_spsc_push struct", e_spsc_push (&item_spsc, item));
+    e_test_assert ("e_spsc_push_ref struct", e_spsc_push_ref (&item_spsc, &item));
+    item.a = 0;
+    e_test_assert ("e_spsc_pop struct", e_spsc_pop (&item_spsc, &item));
+    e_test_assert ("e_spsc_pop struct out", item.a == 5 && item.b == 'x');
+    e_test_assert ("e_spsc_pop NULL", e_spsc_pop (&item_spsc, NULL));
+
+# ifdef TEST_SPSC_THREADS
+    {
+        thrd_t producer;
+        unsigned int expected = 0;
+        size_t n;
+        int ok = 1;
+
+        e_spsc_init (&spsc, memory, 64);
+        thrd_create (&producer, test_spsc_producer, &spsc);
+        while (expected < TEST_SPSC_COUNT) {
+            n = e_spsc_pop_n (&spsc, out, 23);
+            if (n == 0) thrd_yield ();
+            for (i = 0; i < n; i++) {
+                if (out[i] != expected) ok = 0;
+                expected += 1;
+            }
+        }
+        thrd_join (producer, NULL);
+        e_test_assert ("e_spsc threaded order", ok);
+        e_test_assert_eq ("e_spsc threaded len", size_t, e_spsc_len (&spsc), 0);
+    }
+# endif
+}
+
+#else /* __STDC_VERSION__ >= 201112L && !defined (__STDC_NO_ATOMICS__) */
+
+void
+test_spsc (void)
+{
+}
+
+#endif /* __STDC_VERSION__ >= 201112L && !defined (__STDC_NO_ATOMICS__) */
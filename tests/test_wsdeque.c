@@ -0,0 +1,130 @@
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+
+# define E_WSDEQUE_IMPL
+# include "e_test.h"
+# include "e_wsdeque.h"
+
+# if !defined(__STDC_NO_THREADS__) && !defined(__MINGW32__)
+#  define TEST_WSDEQUE_THREADS
+#  include <threads.h>
+# endif
+
+# define TEST_WSDEQUE_THIEF_COUNT 3
+# define TEST_WSDEQUE_COUNT       50000
+
+typedef E_Wsdeque (int) Test_Wsdeque_Ints;
+
+# ifdef TEST_WSDEQUE_THREADS
+typedef struct {
+    Test_Wsdeque_Ints wsdeque;
+    atomic_int done;
+    unsigned char taken[TEST_WSDEQUE_COUNT];
+} Test_Wsdeque_Shared;
+
+static int
+test_wsdeque_thief (void *arg)
+{
+    Test_Wsdeque_Shared *shared = arg;
+    int item, count = 0;
+
+    while (!atomic_load (&shared->done)) {
+        if (e_wsdeque_steal (&shared->wsdeque, &item)) {
+            shared->taken[item] += 1;
+            count += 1;
+        } else {
+            thrd_yield ();
+        }
+    }
+    return count;
+}
+# endif
+
+void
+test_wsdeque (void)
+{
+    Test_Wsdeque_Ints wsdeque = e_wsdeque_init ();
+    int item, i;
+    int ok;
+
+    /* e_wsdeque_init */
+    e_test_assert_eq ("e_wsdeque_init len", size_t, e_wsdeque_len (&wsdeque), 0);
+    e_test_assert ("e_wsdeque_pop empty", !e_wsdeque_pop (&wsdeque, &item));
+    e_test_assert ("e_wsdeque_steal empty", !e_wsdeque_steal (&wsdeque, &item));
+
+    /* e_wsdeque_push, e_wsdeque_pop, e_wsdeque_steal (growing) */
+    for (i = 0; i < 100; i++) {
+        e_wsdeque_push (&wsdeque, i);
+    }
+    e_test_assert_eq ("e_wsdeque_push len", size_t, e_wsdeque_len (&wsdeque), 100);
+    e_test_assert ("e_wsdeque_pop", e_wsdeque_pop (&wsdeque, &item));
+    e_test_assert_eq ("e_wsdeque_pop lifo", int, item, 99);
+    e_test_assert ("e_wsdeque_steal", e_wsdeque_steal (&wsdeque, &item));
+    e_test_assert_eq ("e_wsdeque_steal fifo", int, item, 0);
+    item = -1;
+    e_wsdeque_push_ref (&wsdeque, &item);
+    e_test_assert ("e_wsdeque_pop push_ref", e_wsdeque_pop (&wsdeque, &item));
+    e_test_assert_eq ("e_wsdeque_push_ref", int, item, -1);
+    ok = 1;
+    for (i = 1; i < 50; i++) {
+        if (!e_wsdeque_steal (&wsdeque, &item) || item != i) ok = 0;
+    }
+    e_test_assert ("e_wsdeque_steal order", ok);
+    ok = 1;
+    for (i = 98; i >= 50; i--) {
+        if (!e_wsdeque_pop (&wsdeque, &item) || item != i) ok = 0;
+    }
+    e_test_assert ("e_wsdeque_pop order", ok);
+    e_test_assert ("e_wsdeque_pop empty again", !e_wsdeque_pop (&wsdeque, NULL));
+    e_test_assert ("e_wsdeque_steal empty again", !e_wsdeque_steal (&wsdeque, NULL));
+    e_test_assert_eq ("e_wsdeque_pop len", size_t, e_wsdeque_len (&wsdeque), 0);
+    e_wsdeque_deinit (&wsdeque);
+
+# ifdef TEST_WSDEQUE_THREADS
+    {
+        static Test_Wsdeque_Shared shared;
+        thrd_t thieves[TEST_WSDEQUE_THIEF_COUNT];
+        int result, count;
+
+        atomic_init (&shared.done, 0);
+        for (i = 0; i < TEST_WSDEQUE_THIEF_COUNT; i++) {
+            thrd_create (&thieves[i], test_wsdeque_thief, &shared);
+        }
+
+        /* the owner pushes in bursts and pops some of the items itself */
+        count = 0;
+        for (i = 0; i < TEST_WSDEQUE_COUNT; i++) {
+            e_wsdeque_push (&shared.wsdeque, i);
+            if (i % 7 == 0 && e_wsdeque_pop (&shared.wsdeque, &item)) {
+                shared.taken[item] += 1;
+                count += 1;
+            }
+        }
+        while (e_wsdeque_pop (&shared.wsdeque, &item)) {
+            shared.taken[item] += 1;
+            count += 1;
+        }
+        atomic_store (&shared.done, 1);
+
+        for (i = 0; i < TEST_WSDEQUE_THIEF_COUNT; i++) {
+            thrd_join (thieves[i], &result);
+            count += result;
+        }
+        e_test_assert_eq ("e_wsdeque concurrent count", int, count, TEST_WSDEQUE_COUNT);
+        ok = 1;
+        for (i = 0; i < TEST_WSDEQUE_COUNT; i++) {
+            if (shared.taken[i] != 1) ok = 0;
+        }
+        e_test_assert ("e_wsdeque concurrent items taken once", ok);
+        e_wsdeque_deinit (&shared.wsdeque);
+    }
+# endif
+}
+
+#else /* __STDC_VERSION__ >= 201112L && !defined (__STDC_NO_ATOMICS__) */
+
+void
+test_wsdeque (void)
+{
+}
+
+#endif /* __STDC_VERSION__ >= 201112L && !defined (__STDC_NO_ATOMICS__) */
@@ -5,7 +5,9 @@ extern void test_alloc (void);
 extern void test_arena (void);
 extern void test_base64 (void);
 extern void test_bcd (void);
+extern void test_bipbuf (void);
 extern void test_bitvec (void);
+extern void test_cda (void);
 extern void test_char (void);
 extern void test_cobs (void);
 extern void test_cobsr (void);
@@ -13,17 +15,27 @@ extern void test_compat (void);
 extern void test_cstr (void);
 extern void test_da (void);
 extern void test_debug (void);
+extern void test_deque (void);
+extern void test_disruptor (void);
 extern void test_endian (void);
+extern void test_heap (void);
 extern void test_ini (void);
 extern void test_log (void);
 extern void test_macro (void);
 extern void test_mem (void);
+extern void test_mpmc (void);
+extern void test_mpsc (void);
 extern void test_queue (void);
 extern void test_rand (void);
 extern void test_rbuf (void);
 extern void test_sb (void);
+extern void test_segda (void);
+extern void test_shmring (void);
+extern void test_soa (void);
+extern void test_spsc (void);
 extern void test_stdc (void);
 extern void test_sv (void);
+extern void test_wsdeque (void);
 
 int
 main (void)
@@ -32,7 +44,9 @@ main (void)
     test_arena ();
     test_base64 ();
     test_bcd ();
+    test_bipbuf ();
     test_bitvec ();
+    test_cda ();
     test_char ();
     test_cobs ();
     test_cobsr ();
@@ -40,17 +54,27 @@ main (void)
     test_cstr ();
     test_da ();
     test_debug ();
+    test_deque ();
+    test_disruptor ();
     test_endian ();
+    test_heap ();
     test_ini ();
     test_log ();
     test_macro ();
     test_mem ();
+    test_mpmc ();
+    test_mpsc ();
     test_queue ();
     test_rand ();
     test_rbuf ();
     test_sb ();
+    test_segda ();
+    test_shmring ();
+    test_soa ();
+    test_spsc ();
     test_stdc ();
     test_sv ();
+    test_wsdeque ();
 
     e_test_finish ();
     return 0;